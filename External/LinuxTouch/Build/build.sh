@@ -0,0 +1,18 @@
+#!/bin/bash
+
+printf "\n\e[1;36mBuilding External/LinuxTouch.\e[0;39m\n"
+
+UNAME=$(uname -s)
+if [ "$UNAME" != "Linux" ]; then
+	printf "\e[31mNeed to build libLinuxTouch.so on Linux!\e[39m\n"
+	exit 0
+fi
+
+DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+PROJECT=$(cd "$DIR/../" && pwd)
+SHARED=$(cd "$DIR/../../WindowsTouch" && pwd)
+PLUGINS="$DIR/../../../Source/Assets/TouchScript/Plugins/LinuxTouch"
+
+mkdir -p "$PLUGINS/x86_64"
+c++ -std=c++11 -Wall -Wextra -O2 -fPIC -shared -fvisibility=hidden -pthread -I"$PROJECT/Compat" -I"$SHARED" \
+	"$PROJECT/LinuxTouch.cpp" -o "$PLUGINS/x86_64/libLinuxTouch.so"
@@ -0,0 +1,40 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+// Windows types and the few CRT functions used by the headers LinuxTouch shares with WindowsTouch.
+// Only on the include path of the Linux build.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <wchar.h>
+
+typedef uint8_t					BYTE;
+typedef int16_t					INT16;
+typedef uint16_t				UINT16;
+typedef int32_t					INT32;
+typedef uint32_t				UINT32;
+typedef int64_t					INT64;
+typedef uint64_t				UINT64;
+typedef unsigned int			UINT;
+typedef int						LONG;
+typedef int						BOOL;
+
+#define TRUE					1
+#define FALSE					0
+
+typedef struct
+{
+	LONG					left, top, right, bottom;
+} RECT;
+
+#define _TRUNCATE				((size_t)-1)
+
+// Log lines are always truncated to the buffer, count is only ever _TRUNCATE.
+inline int _vsnwprintf_s(wchar_t* buffer, size_t size, size_t /*count*/, const wchar_t* format, va_list args)
+{
+	return vswprintf(buffer, size, format, args);
+}
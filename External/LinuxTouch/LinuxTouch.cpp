@@ -0,0 +1,529 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#include "LinuxTouch.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#define BIT_WORDS(bits)				(((bits) + 8 * sizeof(unsigned long) - 1) / (8 * sizeof(unsigned long)))
+#define TEST_BIT(bit, words)		((words[(bit) / (8 * sizeof(unsigned long))] >> ((bit) % (8 * sizeof(unsigned long)))) & 1)
+
+extern "C"
+{
+	// Only opens the devices, the reader is started by SetDeliveryMode() so no frame is delivered before the mode is chosen.
+	// Evdev is the only API, the requested one is ignored.
+	void __stdcall Init(TOUCH_API /*api*/, PointerDelegatePtr delegate)
+	{
+		Dispose();
+
+		_delegate = delegate;
+		_stats.setFrequency(NANOSECONDS);
+		openDevices();
+		if (_deviceCount == 0)
+		{
+			log(LOG_WARNING, L"No multitouch screens found, the user may need to be in the input group.");
+			return;
+		}
+		log(LOG_INFO, L"Opened %u touch devices.", _deviceCount);
+	}
+
+	// Can be called from any thread, the reader thread picks up the new parameters with its next wakeup.
+	void __stdcall SetScreenParams(int width, int height, float offsetX, float offsetY, float scaleX, float scaleY)
+	{
+		pthread_mutex_lock(&_screenLock);
+		_screen.width = width;
+		_screen.height = height;
+		_screen.offsetX = offsetX;
+		_screen.offsetY = offsetY;
+		_screen.scaleX = scaleX;
+		_screen.scaleY = scaleY;
+		pthread_mutex_unlock(&_screenLock);
+	}
+
+	void __stdcall Dispose()
+	{
+		stopReader();
+		closeDevices();
+		_slots.clear();
+		_eventBuffer.release();
+		_deliveryMode.store(DELIVERY_CALLBACK);
+		_delegate = NULL;
+	}
+
+	// In callback mode the delegate is called on the reader thread, not on the thread which called Init().
+	// The reader is stopped while the buffer is reallocated, so no event gets lost between the modes. It is left stopped if the buffer can't be allocated.
+	void __stdcall SetDeliveryMode(DELIVERY_MODE mode, int capacity)
+	{
+		stopReader();
+		if (mode == DELIVERY_BUFFERED)
+		{
+			if (!_eventBuffer.allocate(capacity > 0 ? capacity : DEFAULT_BUFFER_CAPACITY))
+			{
+				log(LOG_ERROR, L"Failed to allocate event buffer.");
+				return;
+			}
+		}
+		else _eventBuffer.release();
+		_deliveryMode.store(mode);
+		startReader();
+	}
+
+	int __stdcall GetPointerEvents(PackedEvent* buffer, int capacity)
+	{
+		if (!buffer || capacity <= 0 || !_eventBuffer.isAllocated()) return 0;
+		return _eventBuffer.pop(buffer, capacity);
+	}
+
+	// Devices are opened by Init() and cover the whole display.
+	int __stdcall GetDevices(DeviceInfo* buffer, int capacity)
+	{
+		if (!buffer || capacity <= 0) return _deviceCount;
+
+		pthread_mutex_lock(&_screenLock);
+		ScreenParams screen = _screen;
+		pthread_mutex_unlock(&_screenLock);
+
+		RECT display;
+		display.left = display.top = 0;
+		display.right = (LONG)(screen.width / screen.scaleX + 2 * screen.offsetX);
+		display.bottom = (LONG)(screen.height / screen.scaleY + 2 * screen.offsetY);
+
+		UINT32 count = _deviceCount < (UINT32)capacity ? _deviceCount : capacity;
+		for (UINT32 i = 0; i < count; i++)
+		{
+			buffer[i].index = i;
+			buffer[i].type = POINTER_DEVICE_TYPE_TOUCH;
+			buffer[i].maxContacts = _devices[i].slotCount;
+			buffer[i].monitor = -1;
+			buffer[i].displayRect = display;
+			buffer[i].monitorRect = display;
+		}
+		return count;
+	}
+
+	UINT32 __stdcall GetEventFormat()
+	{
+		return PACKED_EVENT_FORMAT;
+	}
+
+	void __stdcall GetInputStats(InputStats* stats)
+	{
+		if (stats) _stats.read(*stats);
+	}
+
+	void __stdcall ResetInputStats()
+	{
+		_stats.reset();
+	}
+
+	void __stdcall SetLogLevel(LOG_LEVEL level)
+	{
+		_logBuffer.setLevel(level);
+	}
+
+	// Same as in WindowsTouch, text is UTF-16 because that is what managed code marshals.
+	int __stdcall GetLogEntry(LOG_LEVEL* level, UINT16* text, int capacity)
+	{
+		LogEntry entry;
+		if (!text || capacity <= 0 || !_logBuffer.read(entry)) return -1;
+
+		UINT32 length = entry.length < (UINT32)capacity ? entry.length : capacity;
+		for (UINT32 i = 0; i < length; i++) text[i] = entry.text[i] < 0x10000 ? (UINT16)entry.text[i] : '?';
+		if (level) *level = entry.level;
+		return length;
+	}
+}
+
+// Opens every direct touch device which reports MT protocol B, touchpads and protocol A devices are skipped.
+void openDevices()
+{
+	char path[32];
+	for (UINT32 i = 0; i < MAX_EVENT_NODES && _deviceCount < MAX_DEVICES; i++)
+	{
+		snprintf(path, sizeof(path), "/dev/input/event%u", i);
+		TouchDevice& device = _devices[_deviceCount];
+		if (!openDevice(path, device)) continue;
+		device.index = _deviceCount++;
+	}
+}
+
+bool openDevice(const char* path, TouchDevice& device)
+{
+	int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+	if (fd < 0) return false;
+
+	unsigned long absBits[BIT_WORDS(ABS_CNT)] = {0};
+	unsigned long propBits[BIT_WORDS(INPUT_PROP_CNT)] = {0};
+	if (ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits) < 0
+		|| ioctl(fd, EVIOCGPROP(sizeof(propBits)), propBits) < 0
+		|| !TEST_BIT(ABS_MT_SLOT, absBits) || !TEST_BIT(ABS_MT_POSITION_X, absBits) || !TEST_BIT(ABS_MT_POSITION_Y, absBits)
+		|| !TEST_BIT(INPUT_PROP_DIRECT, propBits))
+	{
+		close(fd);
+		return false;
+	}
+
+	input_absinfo slots;
+	if (ioctl(fd, EVIOCGABS(ABS_MT_SLOT), &slots) < 0
+		|| ioctl(fd, EVIOCGABS(ABS_MT_POSITION_X), &device.absX) < 0
+		|| ioctl(fd, EVIOCGABS(ABS_MT_POSITION_Y), &device.absY) < 0)
+	{
+		close(fd);
+		return false;
+	}
+	device.hasPressure = TEST_BIT(ABS_MT_PRESSURE, absBits) && ioctl(fd, EVIOCGABS(ABS_MT_PRESSURE), &device.absPressure) >= 0;
+	device.hasOrientation = TEST_BIT(ABS_MT_ORIENTATION, absBits) && ioctl(fd, EVIOCGABS(ABS_MT_ORIENTATION), &device.absOrientation) >= 0;
+
+	// Event times are compared with the reader's clock.
+	int clock = CLOCK_MONOTONIC;
+	ioctl(fd, EVIOCSCLOCKID, &clock);
+
+	device.fd = fd;
+	device.slotCount = slots.maximum + 1 < MAX_MT_SLOTS ? slots.maximum + 1 : MAX_MT_SLOTS;
+	device.currentSlot = slots.value;
+	device.dropped = false;
+	for (UINT32 i = 0; i < MAX_MT_SLOTS; i++)
+	{
+		MtSlot& slot = device.slots[i];
+		memset(&slot, 0, sizeof(MtSlot));
+		slot.trackingId = slot.activeTrackingId = -1;
+		slot.pointerSlot = -1;
+	}
+	// Contacts which are already down show up with the first frame.
+	resyncDevice(device);
+	return true;
+}
+
+void closeDevices()
+{
+	for (UINT32 i = 0; i < _deviceCount; i++)
+	{
+		if (_devices[i].fd >= 0) close(_devices[i].fd);
+	}
+	_deviceCount = 0;
+}
+
+bool startReader()
+{
+	if (_readerRunning || _deviceCount == 0) return true;
+
+	if (pipe(_wakePipe) < 0)
+	{
+		log(LOG_ERROR, L"Failed to create wake pipe.");
+		return false;
+	}
+	if (pthread_create(&_readerThread, NULL, readerThread, NULL) != 0)
+	{
+		close(_wakePipe[0]);
+		close(_wakePipe[1]);
+		_wakePipe[0] = _wakePipe[1] = -1;
+		log(LOG_ERROR, L"Failed to start reader thread.");
+		return false;
+	}
+	_readerRunning = true;
+	return true;
+}
+
+void stopReader()
+{
+	if (!_readerRunning) return;
+
+	char stop = 0;
+	if (write(_wakePipe[1], &stop, 1) < 0) log(LOG_WARNING, L"Failed to wake reader thread.");
+	pthread_join(_readerThread, NULL);
+	close(_wakePipe[0]);
+	close(_wakePipe[1]);
+	_wakePipe[0] = _wakePipe[1] = -1;
+	_readerRunning = false;
+}
+
+// Sleeps in poll() until a device has events or the wake pipe is written to.
+void* readerThread(void* /*param*/)
+{
+	pollfd fds[MAX_DEVICES + 1];
+	for (UINT32 i = 0; i < _deviceCount; i++)
+	{
+		fds[i].fd = _devices[i].fd;
+		fds[i].events = POLLIN;
+	}
+	fds[_deviceCount].fd = _wakePipe[0];
+	fds[_deviceCount].events = POLLIN;
+
+	for (;;)
+	{
+		if (poll(fds, _deviceCount + 1, -1) < 0)
+		{
+			if (errno == EINTR) continue;
+			log(LOG_ERROR, L"poll() failed, error %d.", errno);
+			break;
+		}
+		if (fds[_deviceCount].revents != 0) break;
+
+		pthread_mutex_lock(&_screenLock);
+		ScreenParams screen = _screen;
+		pthread_mutex_unlock(&_screenLock);
+
+		UINT64 received = getTimestamp();
+		for (UINT32 i = 0; i < _deviceCount; i++)
+		{
+			if ((fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) != 0)
+			{
+				// Unplugged, the device stays in its place so that device indices don't change. Its contacts end now.
+				log(LOG_WARNING, L"Touch device %u was removed.", i);
+				fds[i].fd = -1;
+				close(_devices[i].fd);
+				_devices[i].fd = -1;
+				releaseContacts(_devices[i], screen, received);
+				continue;
+			}
+			if ((fds[i].revents & POLLIN) != 0) readDevice(_devices[i], screen, received);
+		}
+		if (_deliveryMode.load(std::memory_order_relaxed) == DELIVERY_BUFFERED)
+		{
+			_eventBuffer.commit();
+			_stats.updateRingSize(_eventBuffer.size());
+		}
+	}
+	return NULL;
+}
+
+void readDevice(TouchDevice& device, const ScreenParams& screen, UINT64 received)
+{
+	input_event events[READ_BATCH];
+	for (;;)
+	{
+		UINT64 start = getTimestamp();
+		ssize_t size = read(device.fd, events, sizeof(events));
+		if (size <= 0) break;
+
+		UINT32 count = (UINT32)(size / sizeof(input_event));
+		for (UINT32 i = 0; i < count; i++) handleEvent(device, events[i], screen, received);
+		_stats.countMessage(getTimestamp() - start);
+		if (count < READ_BATCH) break;
+	}
+}
+
+void handleEvent(TouchDevice& device, const input_event& event, const ScreenParams& screen, UINT64 received)
+{
+	if (event.type == EV_SYN)
+	{
+		if (event.code == SYN_DROPPED)
+		{
+			device.dropped = true;
+		}
+		else if (event.code == SYN_REPORT)
+		{
+			if (device.dropped)
+			{
+				resyncDevice(device);
+				device.dropped = false;
+			}
+			emitFrame(device, (UINT64)event.time.tv_sec * NANOSECONDS + (UINT64)event.time.tv_usec * 1000, screen, received);
+		}
+		return;
+	}
+	if (event.type != EV_ABS || device.dropped) return;
+
+	if (event.code == ABS_MT_SLOT)
+	{
+		device.currentSlot = event.value;
+		return;
+	}
+	if (device.currentSlot < 0 || device.currentSlot >= (INT32)device.slotCount) return;
+
+	MtSlot& slot = device.slots[device.currentSlot];
+	switch (event.code)
+	{
+	case ABS_MT_TRACKING_ID:
+		slot.trackingId = event.value;
+		break;
+	case ABS_MT_POSITION_X:
+		slot.x = event.value;
+		break;
+	case ABS_MT_POSITION_Y:
+		slot.y = event.value;
+		break;
+	case ABS_MT_PRESSURE:
+		slot.pressure = event.value;
+		break;
+	case ABS_MT_ORIENTATION:
+		slot.orientation = event.value;
+		break;
+	default:
+		return;
+	}
+	slot.changed = true;
+}
+
+// Reads the state of every slot back from the kernel after events were dropped.
+void resyncDevice(TouchDevice& device)
+{
+	struct
+	{
+		__u32				code;
+		__s32				values[MAX_MT_SLOTS];
+	} request;
+
+	const UINT32 codes[] = {ABS_MT_TRACKING_ID, ABS_MT_POSITION_X, ABS_MT_POSITION_Y, ABS_MT_PRESSURE, ABS_MT_ORIENTATION};
+	for (UINT32 c = 0; c < sizeof(codes) / sizeof(codes[0]); c++)
+	{
+		if (codes[c] == ABS_MT_PRESSURE && !device.hasPressure) continue;
+		if (codes[c] == ABS_MT_ORIENTATION && !device.hasOrientation) continue;
+
+		request.code = codes[c];
+		if (ioctl(device.fd, EVIOCGMTSLOTS(sizeof(request)), &request) < 0) continue;
+		for (UINT32 i = 0; i < device.slotCount; i++)
+		{
+			MtSlot& slot = device.slots[i];
+			switch (codes[c])
+			{
+			case ABS_MT_TRACKING_ID: slot.trackingId = request.values[i]; break;
+			case ABS_MT_POSITION_X: slot.x = request.values[i]; break;
+			case ABS_MT_POSITION_Y: slot.y = request.values[i]; break;
+			case ABS_MT_PRESSURE: slot.pressure = request.values[i]; break;
+			default: slot.orientation = request.values[i]; break;
+			}
+			slot.changed = true;
+		}
+	}
+
+	input_absinfo current;
+	if (ioctl(device.fd, EVIOCGABS(ABS_MT_SLOT), &current) >= 0) device.currentSlot = current.value;
+}
+
+void releaseContacts(TouchDevice& device, const ScreenParams& screen, UINT64 received)
+{
+	for (UINT32 i = 0; i < device.slotCount; i++)
+	{
+		device.slots[i].trackingId = -1;
+		device.slots[i].changed = true;
+	}
+	emitFrame(device, received, screen, received);
+}
+
+// Turns slot changes since the last SYN_REPORT into pointer events. A slot whose tracking id changed without going through -1
+// ended one contact and started another in the same frame.
+void emitFrame(TouchDevice& device, UINT64 timestamp, const ScreenParams& screen, UINT64 received)
+{
+	UINT32 contacts = 0;
+	for (UINT32 i = 0; i < device.slotCount; i++)
+	{
+		MtSlot& slot = device.slots[i];
+		if (slot.trackingId >= 0) contacts++;
+		if (!slot.changed) continue;
+		slot.changed = false;
+
+		if (slot.pointerId != 0 && slot.activeTrackingId != slot.trackingId)
+		{
+			emitContact(device, slot, WM_POINTERUP, timestamp, screen, received);
+			if (slot.pointerSlot >= 0) _slots.release(slot.pointerSlot);
+			slot.pointerId = 0;
+			slot.pointerSlot = -1;
+			slot.activeTrackingId = -1;
+		}
+		if (slot.trackingId < 0) continue;
+
+		if (slot.pointerId == 0)
+		{
+			slot.pointerId = _nextPointerId;
+			_nextPointerId = _nextPointerId == 0x7FFFFFFF ? 1 : _nextPointerId + 1;
+			slot.pointerSlot = _slots.acquire(slot.pointerId);
+			slot.activeTrackingId = slot.trackingId;
+			emitContact(device, slot, WM_POINTERDOWN, timestamp, screen, received);
+		}
+		else emitContact(device, slot, WM_POINTERUPDATE, timestamp, screen, received);
+	}
+	if (contacts > 0) _stats.countFrame(contacts);
+}
+
+void emitContact(const TouchDevice& device, const MtSlot& slot, UINT32 event, UINT64 timestamp, const ScreenParams& screen, UINT64 received)
+{
+	EventRecord record;
+	record.id = slot.pointerId;
+	record.event = event;
+	record.type = PT_TOUCH;
+	record.position = screenPosition(device, slot, screen);
+	record.slot = slot.pointerSlot;
+	record.device = device.index;
+	record.timestamp = timestamp;
+	record.received = received;
+
+	memset(&record.data, 0, sizeof(PointerData));
+	switch (event)
+	{
+	case WM_POINTERDOWN:
+		record.data.pointerFlags = POINTER_FLAG_NEW | POINTER_FLAG_INRANGE | POINTER_FLAG_INCONTACT | POINTER_FLAG_FIRSTBUTTON | POINTER_FLAG_DOWN;
+		break;
+	case WM_POINTERUPDATE:
+		record.data.pointerFlags = POINTER_FLAG_INRANGE | POINTER_FLAG_INCONTACT | POINTER_FLAG_FIRSTBUTTON | POINTER_FLAG_UPDATE;
+		break;
+	default:
+		record.data.pointerFlags = POINTER_FLAG_UP;
+		break;
+	}
+	if (device.hasPressure)
+	{
+		record.data.mask |= TOUCH_MASK_PRESSURE;
+		record.data.pressure = (UINT32)(normalize(slot.pressure, device.absPressure) * 1024);
+	}
+	// Orientation ranges from -max to max for a quarter turn either way, or from 0 to max for a quarter turn.
+	if (device.hasOrientation && device.absOrientation.maximum > 0)
+	{
+		record.data.mask |= TOUCH_MASK_ORIENTATION;
+		INT32 degrees = slot.orientation * 90 / device.absOrientation.maximum;
+		record.data.rotation = (UINT32)((degrees % 360 + 360) % 360);
+	}
+
+	_stats.countEvent(PT_TOUCH);
+	if (_deliveryMode.load(std::memory_order_relaxed) == DELIVERY_BUFFERED)
+	{
+		if (!_eventBuffer.push(packEvent(record))) _stats.countDropped(1);
+	}
+	else if (_delegate)
+	{
+		_delegate(record.id, record.slot, record.device, record.event, record.type, record.position, record.data, record.received);
+	}
+}
+
+// Same transform as WindowsTouch applies to screen pixels of a fullscreen window.
+Vector2 screenPosition(const TouchDevice& device, const MtSlot& slot, const ScreenParams& screen)
+{
+	float displayWidth = screen.width / screen.scaleX + 2 * screen.offsetX;
+	float displayHeight = screen.height / screen.scaleY + 2 * screen.offsetY;
+	float x = normalize(slot.x, device.absX) * displayWidth;
+	float y = normalize(slot.y, device.absY) * displayHeight;
+
+	Vector2 position;
+	position.x = (x - screen.offsetX) * screen.scaleX;
+	position.y = screen.height - (y - screen.offsetY) * screen.scaleY;
+	return position;
+}
+
+float normalize(INT32 value, const input_absinfo& info)
+{
+	if (info.maximum <= info.minimum) return 0;
+	return (float)(value - info.minimum) / (float)(info.maximum - info.minimum);
+}
+
+UINT64 getTimestamp()
+{
+	timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (UINT64)time.tv_sec * NANOSECONDS + time.tv_nsec;
+}
+
+void log(LOG_LEVEL level, const wchar_t* format, ...)
+{
+	if (!_logBuffer.isEnabled(level)) return;
+
+	va_list args;
+	va_start(args, format);
+	_logBuffer.write(level, format, args);
+	va_end(args);
+}
@@ -0,0 +1,216 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+// Linux counterpart of WindowsTouch.dll. Reads multitouch slots (MT protocol B) of evdev touchscreens on its own thread
+// and exposes the buffered subset of the WindowsTouch exports with the same records, so managed code drains both the same way.
+
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include <linux/input.h>
+#include <pthread.h>
+#include <time.h>
+#include "InputStats.h"
+#include "LogBuffer.h"
+#include "PackedEvent.h"
+#include "PointerSlots.h"
+#include "RingBuffer.h"
+
+#define EXPORT_API __attribute__((visibility("default")))
+
+// Mono uses stdcall for P/Invoke on 32 bit x86 only, everywhere else there is just one convention.
+#if defined(__i386__)
+#define __stdcall __attribute__((stdcall))
+#else
+#define __stdcall
+#endif
+
+// Same values as in WindowsTouch.h. The API is ignored, evdev is the only one.
+typedef enum
+{
+	WIN7,
+	WIN8,
+	RAW
+} TOUCH_API;
+
+typedef enum
+{
+	DELIVERY_CALLBACK,
+	DELIVERY_BUFFERED
+} DELIVERY_MODE;
+
+#define WM_POINTERUPDATE			0x0245
+#define WM_POINTERDOWN				0x0246
+#define WM_POINTERUP				0x0247
+
+typedef enum {
+	PT_POINTER				= 0x00000001,
+	PT_TOUCH				= 0x00000002,
+	PT_PEN					= 0x00000003,
+	PT_MOUSE				= 0x00000004,
+	PT_TOUCHPAD				= 0x00000005
+} POINTER_INPUT_TYPE;
+
+typedef enum {
+	POINTER_FLAG_NONE		= 0x00000000,
+	POINTER_FLAG_NEW		= 0x00000001,
+	POINTER_FLAG_INRANGE	= 0x00000002,
+	POINTER_FLAG_INCONTACT	= 0x00000004,
+	POINTER_FLAG_FIRSTBUTTON = 0x00000010,
+	POINTER_FLAG_DOWN		= 0x00010000,
+	POINTER_FLAG_UPDATE		= 0x00020000,
+	POINTER_FLAG_UP			= 0x00040000
+} POINTER_FLAGS;
+
+typedef enum {
+	TOUCH_MASK_NONE			= 0x00000000,
+	TOUCH_MASK_CONTACTAREA	= 0x00000001,
+	TOUCH_MASK_ORIENTATION	= 0x00000002,
+	TOUCH_MASK_PRESSURE		= 0x00000004
+} TOUCH_MASK;
+
+typedef enum {
+	POINTER_DEVICE_TYPE_UNKNOWN	= 0x00000000,
+	POINTER_DEVICE_TYPE_TOUCH	= 0x00000003
+} POINTER_DEVICE_TYPE;
+
+struct Vector2
+{
+	float					x, y;
+};
+
+// Must match PointerData in WindowsTouch.h. Touch pressure is 0-1024, rotation 0-359 degrees like on Windows.
+struct PointerData
+{
+	UINT32					pointerFlags;
+	UINT32					flags;
+	UINT32					mask;
+	UINT32					changedButtons;
+	UINT32					rotation;
+	UINT32					pressure;
+	INT32					tiltX;
+	INT32					tiltY;
+};
+
+// Has the fields of EventRecord in WindowsTouch.h, the event buffer stores it as a PackedEvent. Timestamps are CLOCK_MONOTONIC nanoseconds.
+struct EventRecord
+{
+	int						id;
+	UINT32					event;
+	POINTER_INPUT_TYPE		type;
+	Vector2					position;
+	PointerData				data;
+	INT32					slot;
+	UINT32					device;
+	UINT64					timestamp;	// kernel time of the SYN_REPORT which ended the frame
+	UINT64					received;	// when the reader thread read the frame
+};
+
+// Must match DeviceInfo in WindowsTouch.h.
+struct DeviceInfo
+{
+	UINT32					index;
+	POINTER_DEVICE_TYPE		type;
+	UINT32					maxContacts;
+	INT32					monitor;
+	RECT					displayRect;
+	RECT					monitorRect;
+};
+
+typedef void(__stdcall * PointerDelegatePtr)(int id, int slot, UINT32 device, UINT32 event, POINTER_INPUT_TYPE type, Vector2 position, PointerData data, UINT64 received);
+
+#define MAX_DEVICES					16
+#define MAX_MT_SLOTS				64
+#define MAX_EVENT_NODES				64
+#define DEFAULT_BUFFER_CAPACITY		1024
+// input_events read with one read() call.
+#define READ_BATCH					64
+#define NANOSECONDS					1000000000ULL
+
+// State of one MT slot as the kernel reports it. A contact has its own pointer id from the first frame it is seen in.
+struct MtSlot
+{
+	INT32					trackingId;		// -1 if the slot is empty
+	INT32					x, y;
+	INT32					pressure;
+	INT32					orientation;
+	int						pointerId;		// 0 if no contact was delivered for the slot
+	INT32					pointerSlot;
+	INT32					activeTrackingId;
+	bool					changed;
+};
+
+struct TouchDevice
+{
+	int						fd;
+	UINT32					index;
+	input_absinfo			absX, absY, absPressure, absOrientation;
+	bool					hasPressure;
+	bool					hasOrientation;
+	UINT32					slotCount;
+	INT32					currentSlot;
+	// Set by SYN_DROPPED, events are ignored until the next SYN_REPORT, then the slots are read back from the kernel.
+	bool					dropped;
+	MtSlot					slots[MAX_MT_SLOTS];
+};
+
+// Screen parameters with the same meaning as SetScreenParams() of WindowsTouch.
+// Devices cover the whole display, whose size is what managed code sends for a fullscreen window: screen / scale + 2 * offset.
+struct ScreenParams
+{
+	int						width, height;
+	float					offsetX, offsetY;
+	float					scaleX, scaleY;
+};
+
+PointerDelegatePtr			_delegate = NULL;
+std::atomic<DELIVERY_MODE>	_deliveryMode(DELIVERY_CALLBACK);
+RingBuffer<PackedEvent>		_eventBuffer;
+// Written by SetScreenParams() under the lock, copied by the reader thread once per wakeup.
+ScreenParams				_screen = {0, 0, 0, 0, 1, 1};
+pthread_mutex_t				_screenLock = PTHREAD_MUTEX_INITIALIZER;
+TouchDevice					_devices[MAX_DEVICES];
+UINT32						_deviceCount = 0;
+// Reader thread, it sleeps in poll() on the devices and the read end of the wake pipe.
+pthread_t					_readerThread;
+bool						_readerRunning = false;
+int							_wakePipe[2] = {-1, -1};
+// Only touched by the reader thread.
+PointerSlots				_slots;
+int							_nextPointerId = 1;
+StatsCounters				_stats;
+LogBuffer					_logBuffer;
+
+extern "C"
+{
+	EXPORT_API void __stdcall Init(TOUCH_API api, PointerDelegatePtr delegate);
+	EXPORT_API void __stdcall SetScreenParams(int width, int height, float offsetX, float offsetY, float scaleX, float scaleY);
+	EXPORT_API void __stdcall Dispose();
+	EXPORT_API void __stdcall SetDeliveryMode(DELIVERY_MODE mode, int capacity);
+	EXPORT_API int __stdcall GetPointerEvents(PackedEvent* buffer, int capacity);
+	EXPORT_API int __stdcall GetDevices(DeviceInfo* buffer, int capacity);
+	EXPORT_API UINT32 __stdcall GetEventFormat();
+	EXPORT_API void __stdcall GetInputStats(InputStats* stats);
+	EXPORT_API void __stdcall ResetInputStats();
+	EXPORT_API void __stdcall SetLogLevel(LOG_LEVEL level);
+	EXPORT_API int __stdcall GetLogEntry(LOG_LEVEL* level, UINT16* text, int capacity);
+}
+
+void log(LOG_LEVEL level, const wchar_t* format, ...);
+void openDevices();
+bool openDevice(const char* path, TouchDevice& device);
+void closeDevices();
+bool startReader();
+void stopReader();
+void* readerThread(void* param);
+void readDevice(TouchDevice& device, const ScreenParams& screen, UINT64 received);
+void handleEvent(TouchDevice& device, const input_event& event, const ScreenParams& screen, UINT64 received);
+void resyncDevice(TouchDevice& device);
+void releaseContacts(TouchDevice& device, const ScreenParams& screen, UINT64 received);
+void emitFrame(TouchDevice& device, UINT64 timestamp, const ScreenParams& screen, UINT64 received);
+void emitContact(const TouchDevice& device, const MtSlot& slot, UINT32 event, UINT64 timestamp, const ScreenParams& screen, UINT64 received);
+Vector2 screenPosition(const TouchDevice& device, const MtSlot& slot, const ScreenParams& screen);
+float normalize(INT32 value, const input_absinfo& info);
+UINT64 getTimestamp();
@@ -0,0 +1,388 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+// Micro-benchmark of the WindowsTouch decode path.
+// Creates a hidden UnityWndClass window, lets the plugin subclass it and sends synthetic WM_POINTER* / WM_TOUCH messages
+// through the real window proc. OS pointer queries are replaced with fakes which return generated contacts, so no digitizer is needed.
+//
+// Usage: WindowsTouchBenchmark [-contacts 1-100] [-hz rate] [-frames count]
+// Messages are sent as fast as possible, -hz sets how many digitizer frames arrive per 60 Hz drain of the event buffer.
+// In threaded mode ns/event is the cost of the window proc alone, the delivery thread publishes events meanwhile.
+
+#include <winsock2.h>
+#include <windows.h>
+#include <hidusage.h>
+#include <hidpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <atomic>
+#include <new>
+#include <xmmintrin.h>
+
+// <Allocation counting>
+
+volatile LONG _allocations = 0;
+
+void* countedMalloc(size_t size)
+{
+	InterlockedIncrement(&_allocations);
+	return malloc(size);
+}
+
+void* countedRealloc(void* memory, size_t size)
+{
+	InterlockedIncrement(&_allocations);
+	return realloc(memory, size);
+}
+
+void* operator new(size_t size)
+{
+	void* memory = countedMalloc(size);
+	if (!memory) throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	void* memory = countedMalloc(size);
+	if (!memory) throw std::bad_alloc();
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+
+// </Allocation counting>
+
+// <WM_TOUCH fakes>
+
+TOUCHINPUT					_touchInputs[100];
+
+BOOL WINAPI fakeGetTouchInputInfo(HTOUCHINPUT input, UINT count, PTOUCHINPUT inputs, int size)
+{
+	memcpy(inputs, _touchInputs, count * sizeof(TOUCHINPUT));
+	return TRUE;
+}
+
+BOOL WINAPI fakeCloseTouchInputHandle(HTOUCHINPUT input)
+{
+	return TRUE;
+}
+
+// </WM_TOUCH fakes>
+
+// The plugin is compiled into the benchmark to reach its window procs and globals.
+// Everything it includes is already included above, so only the plugin code is affected by these.
+#define realloc countedRealloc
+#define GetTouchInputInfo fakeGetTouchInputInfo
+#define CloseTouchInputHandle fakeCloseTouchInputHandle
+#include "../WindowsTouch.cpp"
+#undef realloc
+#undef GetTouchInputInfo
+#undef CloseTouchInputHandle
+
+#define MAX_CONTACTS				100
+#define SCREEN_WIDTH				1920
+#define SCREEN_HEIGHT				1080
+#define UNITY_FPS					60
+#define WARMUP_FRAMES				60
+#define DRAIN_CAPACITY				1024
+
+typedef enum
+{
+	MODE_CALLBACK,
+	MODE_BATCHED,
+	MODE_COALESCED,
+	MODE_THREADED
+} BENCHMARK_MODE;
+
+const char*					MODE_NAMES[] = {"callback", "batched", "coalesced", "threaded"};
+
+struct Contact
+{
+	float					x, y;
+	float					dx, dy;
+};
+
+struct Result
+{
+	UINT64					eventsIn;
+	UINT64					eventsOut;
+	double					seconds;
+	LONG					allocations;
+};
+
+Contact						_contacts[MAX_CONTACTS];
+UINT32						_contactCount = 0;
+UINT32						_frameId = 0;
+UINT64						_frameTime = 0;
+POINTER_FLAGS				_frameFlags = POINTER_FLAG_NONE;
+POINTER_BUTTON_CHANGE_TYPE	_frameButtons = POINTER_CHANGE_NONE;
+HWND						_window;
+UINT64						_delivered = 0;
+PackedEvent					_drainBuffer[DRAIN_CAPACITY];
+
+// <WM_POINTER fakes>
+
+void fillPointerInfo(POINTER_INFO& info, UINT32 index)
+{
+	memset(&info, 0, sizeof(POINTER_INFO));
+	info.pointerType = PT_TOUCH;
+	info.pointerId = index + 1;
+	info.frameId = _frameId;
+	info.pointerFlags = (POINTER_FLAGS)(_frameFlags | POINTER_FLAG_CONFIDENCE | (index == 0 ? POINTER_FLAG_PRIMARY : 0));
+	info.sourceDevice = (HANDLE)1;
+	info.hwndTarget = _window;
+	info.ptPixelLocation.x = (LONG)_contacts[index].x;
+	info.ptPixelLocation.y = (LONG)_contacts[index].y;
+	info.historyCount = 1;
+	info.PerformanceCount = _frameTime;
+	info.ButtonChangeType = _frameButtons;
+}
+
+void fillTouchInfo(POINTER_TOUCH_INFO& info, UINT32 index)
+{
+	memset(&info, 0, sizeof(POINTER_TOUCH_INFO));
+	fillPointerInfo(info.pointerInfo, index);
+	info.touchMask = (TOUCH_MASK)(TOUCH_MASK_CONTACTAREA | TOUCH_MASK_PRESSURE);
+	info.rcContact.left = info.pointerInfo.ptPixelLocation.x - 5;
+	info.rcContact.top = info.pointerInfo.ptPixelLocation.y - 5;
+	info.rcContact.right = info.pointerInfo.ptPixelLocation.x + 5;
+	info.rcContact.bottom = info.pointerInfo.ptPixelLocation.y + 5;
+	info.pressure = 512;
+}
+
+BOOL WINAPI fakeGetPointerInfo(UINT32 pointerId, POINTER_INFO* info)
+{
+	if (pointerId == 0 || pointerId > _contactCount) return FALSE;
+	fillPointerInfo(*info, pointerId - 1);
+	return TRUE;
+}
+
+BOOL WINAPI fakeGetPointerTouchInfo(UINT32 pointerId, POINTER_TOUCH_INFO* info)
+{
+	if (pointerId == 0 || pointerId > _contactCount) return FALSE;
+	fillTouchInfo(*info, pointerId - 1);
+	return TRUE;
+}
+
+BOOL WINAPI fakeGetPointerFrameTouchInfo(UINT32 pointerId, UINT32* pointerCount, POINTER_TOUCH_INFO* infos)
+{
+	if (*pointerCount < _contactCount) return FALSE;
+	for (UINT32 i = 0; i < _contactCount; i++) fillTouchInfo(infos[i], i);
+	*pointerCount = _contactCount;
+	return TRUE;
+}
+
+void installFakes()
+{
+	GetPointerInfo = fakeGetPointerInfo;
+	GetPointerTouchInfo = fakeGetPointerTouchInfo;
+	GetPointerFrameTouchInfo = fakeGetPointerFrameTouchInfo;
+	GetPointerInfoHistory = NULL;
+	GetPointerTouchInfoHistory = NULL;
+	GetPointerFrameTouchInfoHistory = NULL;
+}
+
+// </WM_POINTER fakes>
+
+void __stdcall benchmarkPointer(int id, int slot, UINT32 device, UINT32 event, POINTER_INPUT_TYPE type, Vector2 position, PointerData data, UINT64 received)
+{
+	_delivered++;
+}
+
+void moveContacts()
+{
+	for (UINT32 i = 0; i < _contactCount; i++)
+	{
+		Contact& contact = _contacts[i];
+		contact.x += contact.dx;
+		contact.y += contact.dy;
+		if (contact.x < 0 || contact.x >= SCREEN_WIDTH) contact.dx = -contact.dx;
+		if (contact.y < 0 || contact.y >= SCREEN_HEIGHT) contact.dy = -contact.dy;
+	}
+}
+
+// Sends one digitizer frame: a message per contact with WM_POINTER, one message for all contacts with WM_TOUCH.
+void sendFrame(TOUCH_API api, UINT msg, POINTER_FLAGS flags, POINTER_BUTTON_CHANGE_TYPE buttons, DWORD touchFlags)
+{
+	LARGE_INTEGER time;
+	QueryPerformanceCounter(&time);
+	_frameId++;
+	_frameTime = time.QuadPart;
+	_frameFlags = flags;
+	_frameButtons = buttons;
+
+	if (api == WIN8)
+	{
+		for (UINT32 i = 0; i < _contactCount; i++) SendMessage(_window, msg, MAKEWPARAM(i + 1, 0), 0);
+	}
+	else if (touchFlags != 0)
+	{
+		for (UINT32 i = 0; i < _contactCount; i++)
+		{
+			TOUCHINPUT& input = _touchInputs[i];
+			memset(&input, 0, sizeof(TOUCHINPUT));
+			input.x = (LONG)(_contacts[i].x * 100);
+			input.y = (LONG)(_contacts[i].y * 100);
+			input.dwID = i + 1;
+			input.dwFlags = touchFlags;
+		}
+		SendMessage(_window, WM_TOUCH, MAKEWPARAM(_contactCount, 0), 1);
+	}
+}
+
+void drain(BENCHMARK_MODE mode)
+{
+	if (mode == MODE_CALLBACK) return;
+
+	int count;
+	do
+	{
+		count = GetPointerEvents(_drainBuffer, DRAIN_CAPACITY);
+		_delivered += count;
+	} while (count == DRAIN_CAPACITY);
+}
+
+Result run(TOUCH_API api, BENCHMARK_MODE mode, UINT32 options, UINT32 contacts, UINT32 hz, UINT32 frames)
+{
+	Init(api, benchmarkPointer);
+	if (api == WIN8) installFakes();
+	SetScreenParams(SCREEN_WIDTH, SCREEN_HEIGHT, 0, 0, 1, 1);
+	if (mode == MODE_COALESCED) options |= OPTION_COALESCE;
+	SetOptions(options);
+
+	// Digitizer frames per Unity frame, the buffer must fit all of them.
+	UINT32 framesPerDrain = hz > UNITY_FPS ? hz / UNITY_FPS : 1;
+	SetDeliveryMode(mode == MODE_CALLBACK ? DELIVERY_CALLBACK : DELIVERY_BUFFERED, contacts * (framesPerDrain + 4) * 2);
+	if (mode == MODE_THREADED) StartDeliveryThread();
+
+	_contactCount = contacts;
+	srand(1);
+	for (UINT32 i = 0; i < contacts; i++)
+	{
+		_contacts[i].x = (float)(rand() % SCREEN_WIDTH);
+		_contacts[i].y = (float)(rand() % SCREEN_HEIGHT);
+		_contacts[i].dx = (float)(rand() % 21 - 10) * .5f;
+		_contacts[i].dy = (float)(rand() % 21 - 10) * .5f;
+	}
+
+	const POINTER_FLAGS contact = (POINTER_FLAGS)(POINTER_FLAG_INRANGE | POINTER_FLAG_INCONTACT | POINTER_FLAG_FIRSTBUTTON);
+	sendFrame(api, WM_POINTERENTER, (POINTER_FLAGS)(POINTER_FLAG_NEW | POINTER_FLAG_INRANGE), POINTER_CHANGE_NONE, 0);
+	sendFrame(api, WM_POINTERDOWN, (POINTER_FLAGS)(contact | POINTER_FLAG_DOWN), POINTER_CHANGE_FIRSTBUTTON_DOWN, TOUCHEVENTF_DOWN);
+	for (UINT32 i = 0; i < WARMUP_FRAMES; i++)
+	{
+		moveContacts();
+		sendFrame(api, WM_POINTERUPDATE, (POINTER_FLAGS)(contact | POINTER_FLAG_UPDATE), POINTER_CHANGE_NONE, TOUCHEVENTF_MOVE);
+		if ((i + 1) % framesPerDrain == 0) drain(mode);
+	}
+	drain(mode);
+
+	Result result;
+	_delivered = 0;
+	_allocations = 0;
+	LARGE_INTEGER start, end, frequency;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&start);
+
+	for (UINT32 i = 0; i < frames; i++)
+	{
+		moveContacts();
+		sendFrame(api, WM_POINTERUPDATE, (POINTER_FLAGS)(contact | POINTER_FLAG_UPDATE), POINTER_CHANGE_NONE, TOUCHEVENTF_MOVE);
+		if ((i + 1) % framesPerDrain == 0) drain(mode);
+	}
+	drain(mode);
+
+	QueryPerformanceCounter(&end);
+	// Events still in flight on the delivery thread.
+	if (mode == MODE_THREADED)
+	{
+		StopDeliveryThread();
+		drain(mode);
+	}
+	result.eventsIn = (UINT64)contacts * frames;
+	result.eventsOut = _delivered;
+	result.seconds = (double)(end.QuadPart - start.QuadPart) / frequency.QuadPart;
+	result.allocations = _allocations;
+
+	sendFrame(api, WM_POINTERUP, POINTER_FLAG_INRANGE, POINTER_CHANGE_FIRSTBUTTON_UP, TOUCHEVENTF_UP);
+	sendFrame(api, WM_POINTERLEAVE, POINTER_FLAG_NONE, POINTER_CHANGE_NONE, 0);
+	drain(mode);
+	Dispose();
+
+	return result;
+}
+
+void print(const char* api, BENCHMARK_MODE mode, const char* decode, UINT32 contacts, UINT32 hz, const Result& result)
+{
+	printf("%-5s %-10s %-7s %8u %6u %10.1f %12.0f %10llu %10llu %6ld\n", api, MODE_NAMES[mode], decode, contacts, hz,
+		result.seconds * 1e9 / result.eventsIn, result.eventsIn / result.seconds,
+		result.eventsIn, result.eventsOut, result.allocations);
+}
+
+LRESULT CALLBACK benchmarkWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	return DefWindowProcA(hwnd, msg, wParam, lParam);
+}
+
+UINT32 readArg(int argc, char** argv, const char* name, UINT32 value)
+{
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], name) == 0) return (UINT32)atoi(argv[i + 1]);
+	}
+	return value;
+}
+
+int main(int argc, char** argv)
+{
+	UINT32 contacts = readArg(argc, argv, "-contacts", 0);
+	UINT32 hz = readArg(argc, argv, "-hz", 240);
+	UINT32 frames = readArg(argc, argv, "-frames", 2000);
+	if (contacts > MAX_CONTACTS) contacts = MAX_CONTACTS;
+	if (hz == 0) hz = 240;
+	if (frames == 0) frames = 2000;
+
+	WNDCLASSA windowClass;
+	memset(&windowClass, 0, sizeof(WNDCLASSA));
+	windowClass.lpfnWndProc = benchmarkWndProc;
+	windowClass.hInstance = GetModuleHandleA(NULL);
+	windowClass.lpszClassName = "UnityWndClass";
+	RegisterClassA(&windowClass);
+	_window = CreateWindowExA(0, "UnityWndClass", "WindowsTouchBenchmark", WS_OVERLAPPEDWINDOW, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, NULL, NULL, windowClass.hInstance, NULL);
+	if (!_window)
+	{
+		printf("Failed to create window.\n");
+		return 1;
+	}
+
+	const UINT32 defaultContacts[] = {1, 10, 50, 100};
+	const UINT32* contactSet = contacts > 0 ? &contacts : defaultContacts;
+	UINT32 contactSetSize = contacts > 0 ? 1 : sizeof(defaultContacts) / sizeof(UINT32);
+
+	printf("%d-bit, %u digitizer frames per run\n", (int)(sizeof(void*) * 8), frames);
+	printf("%-5s %-10s %-7s %8s %6s %10s %12s %10s %10s %6s\n", "api", "mode", "decode", "contacts", "hz", "ns/event", "events/s", "in", "out", "allocs");
+	for (UINT32 c = 0; c < contactSetSize; c++)
+	{
+		for (int mode = MODE_CALLBACK; mode <= MODE_THREADED; mode++)
+		{
+			BENCHMARK_MODE m = (BENCHMARK_MODE)mode;
+			print("win8", m, "message", contactSet[c], hz, run(WIN8, m, OPTION_NONE, contactSet[c], hz, frames));
+			print("win8", m, "frame", contactSet[c], hz, run(WIN8, m, OPTION_FRAME_DECODE, contactSet[c], hz, frames));
+			print("win7", m, "message", contactSet[c], hz, run(WIN7, m, OPTION_NONE, contactSet[c], hz, frames));
+		}
+	}
+
+	DestroyWindow(_window);
+	return 0;
+}
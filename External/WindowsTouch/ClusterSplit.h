@@ -0,0 +1,162 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+#include <windows.h>
+#include <xmmintrin.h>
+
+#define MAX_CLUSTER_POINTS			256
+#define MAX_CLUSTER_ITERATIONS		32
+
+// Splits points into two clusters exactly like Clusters2D in managed code does.
+// Points are interleaved x, y pairs. Every assignment is set to 0 or 1, centers receive x, y of both cluster centroids.
+// Works on the stack, so it can be called from any thread.
+class ClusterSplit
+{
+public:
+	// Returns the number of iterations or -1 if the points can't be split.
+	static int split(const float* points, UINT32 count, int* assignments, float* centers)
+	{
+		if (count < 2 || count > MAX_CLUSTER_POINTS) return -1;
+
+		alignas(16) float x[MAX_CLUSTER_POINTS + 3];
+		alignas(16) float y[MAX_CLUSTER_POINTS + 3];
+		alignas(16) float d1[MAX_CLUSTER_POINTS + 3];
+		alignas(16) float d2[MAX_CLUSTER_POINTS + 3];
+		for (UINT32 i = 0; i < count; i++)
+		{
+			x[i] = points[i * 2];
+			y[i] = points[i * 2 + 1];
+		}
+		// Pad to a multiple of four with copies of the last point, they are never read back.
+		UINT32 padded = (count + 3) & ~3;
+		for (UINT32 i = count; i < padded; i++)
+		{
+			x[i] = x[count - 1];
+			y[i] = y[count - 1];
+		}
+
+		for (UINT32 i = 0; i < count; i++) assignments[i] = i == 1 ? 1 : 0;
+		float c1x = x[0], c1y = y[0], c2x = x[1], c2y = y[1];
+		if (count == 2)
+		{
+			storeCenters(centers, c1x, c1y, c2x, c2y);
+			return 0;
+		}
+
+		__m128 total = _mm_set1_ps((float)count);
+		int iteration = 0;
+		bool changed = true;
+		while (changed && iteration < MAX_CLUSTER_ITERATIONS)
+		{
+			iteration++;
+
+			// Take most distant points from both clusters.
+			distances(x, y, padded, c1x, c1y, d1);
+			distances(x, y, padded, c2x, c2y, d2);
+			UINT32 far1 = farthest(d2, count), far2 = farthest(d1, count);
+
+			// If it is the same point it is too far away from both clusters and has to be in a separate cluster.
+			if (far1 == far2)
+			{
+				c1x = (c1x + c2x) * .5f;
+				c1y = (c1y + c2y) * .5f;
+			}
+			else
+			{
+				c1x = x[far1];
+				c1y = y[far1];
+			}
+			c2x = x[far2];
+			c2y = y[far2];
+
+			distances(x, y, padded, c1x, c1y, d1);
+			distances(x, y, padded, c2x, c2y, d2);
+
+			// Initial assignments are only a guess, so the first pass never counts as converged.
+			changed = iteration == 1;
+			__m128 sum1X = _mm_setzero_ps(), sum1Y = _mm_setzero_ps(), sum2X = _mm_setzero_ps(), sum2Y = _mm_setzero_ps();
+			UINT32 count1 = 0;
+			for (UINT32 i = 0; i < padded; i += 4)
+			{
+				__m128 px = _mm_load_ps(x + i), py = _mm_load_ps(y + i);
+				__m128 closer = _mm_cmplt_ps(_mm_load_ps(d1 + i), _mm_load_ps(d2 + i));
+				// Mask off the padding.
+				__m128 valid = _mm_cmplt_ps(_mm_set_ps((float)(i + 3), (float)(i + 2), (float)(i + 1), (float)i), total);
+				__m128 in1 = _mm_and_ps(closer, valid), in2 = _mm_andnot_ps(closer, valid);
+				sum1X = _mm_add_ps(sum1X, _mm_and_ps(in1, px));
+				sum1Y = _mm_add_ps(sum1Y, _mm_and_ps(in1, py));
+				sum2X = _mm_add_ps(sum2X, _mm_and_ps(in2, px));
+				sum2Y = _mm_add_ps(sum2Y, _mm_and_ps(in2, py));
+
+				int mask = _mm_movemask_ps(in1);
+				for (UINT32 j = 0; j < 4 && i + j < count; j++)
+				{
+					int cluster = (mask & (1 << j)) != 0 ? 0 : 1;
+					if (cluster == 0) count1++;
+					if (assignments[i + j] != cluster)
+					{
+						assignments[i + j] = cluster;
+						changed = true;
+					}
+				}
+			}
+
+			// An empty cluster keeps its center.
+			UINT32 count2 = count - count1;
+			if (count1 > 0)
+			{
+				c1x = horizontalSum(sum1X) / count1;
+				c1y = horizontalSum(sum1Y) / count1;
+			}
+			if (count2 > 0)
+			{
+				c2x = horizontalSum(sum2X) / count2;
+				c2y = horizontalSum(sum2Y) / count2;
+			}
+		}
+
+		storeCenters(centers, c1x, c1y, c2x, c2y);
+		return iteration;
+	}
+
+private:
+	static void distances(const float* x, const float* y, UINT32 padded, float cx, float cy, float* result)
+	{
+		__m128 vx = _mm_set1_ps(cx), vy = _mm_set1_ps(cy);
+		for (UINT32 i = 0; i < padded; i += 4)
+		{
+			__m128 dx = _mm_sub_ps(_mm_load_ps(x + i), vx);
+			__m128 dy = _mm_sub_ps(_mm_load_ps(y + i), vy);
+			_mm_store_ps(result + i, _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+		}
+	}
+
+	// The first one wins a tie, like in managed code.
+	static UINT32 farthest(const float* distances, UINT32 count)
+	{
+		UINT32 index = 0;
+		for (UINT32 i = 1; i < count; i++)
+		{
+			if (distances[i] > distances[index]) index = i;
+		}
+		return index;
+	}
+
+	static void storeCenters(float* centers, float c1x, float c1y, float c2x, float c2y)
+	{
+		centers[0] = c1x;
+		centers[1] = c1y;
+		centers[2] = c2x;
+		centers[3] = c2y;
+	}
+
+	static float horizontalSum(__m128 v)
+	{
+		v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+		v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+		return _mm_cvtss_f32(v);
+	}
+};
@@ -0,0 +1,201 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+#include <windows.h>
+#include <math.h>
+#include <xmmintrin.h>
+#include "PointerSlots.h"
+
+#define AGGREGATE_ALL_DEVICES		0xFFFFFFFF
+
+// Shape of a group of contacts, in TouchScript coordinates.
+// Must match WindowsContactAggregate in managed code.
+struct ContactAggregate
+{
+	UINT32					device;		// device index or AGGREGATE_ALL_DEVICES
+	UINT32					count;
+	float					centroidX, centroidY;
+	float					minX, minY;
+	float					maxX, maxY;
+	float					meanDistance;	// mean distance between all pairs of contacts
+	float					angle;			// direction of the principal axis in radians, (-PI/2, PI/2]
+};
+
+// Screen positions of active touches packed by slot, so that aggregates can be computed four contacts at a time.
+class ContactSet
+{
+public:
+	ContactSet()
+	{
+		clear();
+	}
+
+	void clear()
+	{
+		for (UINT32 i = 0; i < MAX_POINTER_SLOTS; i++) _index[i] = -1;
+		_count = 0;
+	}
+
+	void update(int slot, UINT32 device, float x, float y)
+	{
+		if (slot < 0 || slot >= MAX_POINTER_SLOTS) return;
+
+		int index = _index[slot];
+		if (index < 0)
+		{
+			index = _count++;
+			_index[slot] = index;
+			_slot[index] = slot;
+		}
+		_x[index] = x;
+		_y[index] = y;
+		_device[index] = device;
+	}
+
+	// Moves the last contact in place of the removed one to keep them packed.
+	void remove(int slot)
+	{
+		if (slot < 0 || slot >= MAX_POINTER_SLOTS || _index[slot] < 0) return;
+
+		int index = _index[slot];
+		_index[slot] = -1;
+		_count--;
+		if ((UINT32)index == _count) return;
+
+		_x[index] = _x[_count];
+		_y[index] = _y[_count];
+		_device[index] = _device[_count];
+		_slot[index] = _slot[_count];
+		_index[_slot[index]] = index;
+	}
+
+	// Computes the aggregate of contacts of a device or of all contacts, positions are mapped with position * scale + translate.
+	void aggregate(UINT32 device, float scaleX, float scaleY, float translateX, float translateY, ContactAggregate& result)
+	{
+		UINT32 n = 0;
+		for (UINT32 i = 0; i < _count; i++)
+		{
+			if (device != AGGREGATE_ALL_DEVICES && _device[i] != device) continue;
+			_gx[n] = _x[i] * scaleX + translateX;
+			_gy[n] = _y[i] * scaleY + translateY;
+			n++;
+		}
+
+		memset(&result, 0, sizeof(ContactAggregate));
+		result.device = device;
+		result.count = n;
+		if (n == 0) return;
+
+		// Sums and bounds.
+		__m128 sumX = _mm_setzero_ps(), sumY = _mm_setzero_ps();
+		__m128 minX = _mm_set1_ps(_gx[0]), minY = _mm_set1_ps(_gy[0]);
+		__m128 maxX = minX, maxY = minY;
+		UINT32 i = 0;
+		for (; i + 4 <= n; i += 4)
+		{
+			__m128 x = _mm_load_ps(_gx + i);
+			__m128 y = _mm_load_ps(_gy + i);
+			sumX = _mm_add_ps(sumX, x);
+			sumY = _mm_add_ps(sumY, y);
+			minX = _mm_min_ps(minX, x);
+			minY = _mm_min_ps(minY, y);
+			maxX = _mm_max_ps(maxX, x);
+			maxY = _mm_max_ps(maxY, y);
+		}
+		float sx = horizontalSum(sumX), sy = horizontalSum(sumY);
+		result.minX = horizontalMin(minX);
+		result.minY = horizontalMin(minY);
+		result.maxX = horizontalMax(maxX);
+		result.maxY = horizontalMax(maxY);
+		for (; i < n; i++)
+		{
+			sx += _gx[i];
+			sy += _gy[i];
+			if (_gx[i] < result.minX) result.minX = _gx[i];
+			if (_gy[i] < result.minY) result.minY = _gy[i];
+			if (_gx[i] > result.maxX) result.maxX = _gx[i];
+			if (_gy[i] > result.maxY) result.maxY = _gy[i];
+		}
+		result.centroidX = sx / n;
+		result.centroidY = sy / n;
+		if (n == 1) return;
+
+		// Covariance gives the principal axis.
+		__m128 cx = _mm_set1_ps(result.centroidX), cy = _mm_set1_ps(result.centroidY);
+		__m128 sxx = _mm_setzero_ps(), syy = _mm_setzero_ps(), sxy = _mm_setzero_ps();
+		for (i = 0; i + 4 <= n; i += 4)
+		{
+			__m128 dx = _mm_sub_ps(_mm_load_ps(_gx + i), cx);
+			__m128 dy = _mm_sub_ps(_mm_load_ps(_gy + i), cy);
+			sxx = _mm_add_ps(sxx, _mm_mul_ps(dx, dx));
+			syy = _mm_add_ps(syy, _mm_mul_ps(dy, dy));
+			sxy = _mm_add_ps(sxy, _mm_mul_ps(dx, dy));
+		}
+		float covXX = horizontalSum(sxx), covYY = horizontalSum(syy), covXY = horizontalSum(sxy);
+		for (; i < n; i++)
+		{
+			float dx = _gx[i] - result.centroidX, dy = _gy[i] - result.centroidY;
+			covXX += dx * dx;
+			covYY += dy * dy;
+			covXY += dx * dy;
+		}
+		result.angle = .5f * atan2f(2 * covXY, covXX - covYY);
+
+		// Every pair once.
+		float total = 0;
+		for (i = 0; i < n - 1; i++)
+		{
+			__m128 xi = _mm_set1_ps(_gx[i]), yi = _mm_set1_ps(_gy[i]);
+			__m128 sum = _mm_setzero_ps();
+			UINT32 j = i + 1;
+			for (; j + 4 <= n; j += 4)
+			{
+				__m128 dx = _mm_sub_ps(_mm_loadu_ps(_gx + j), xi);
+				__m128 dy = _mm_sub_ps(_mm_loadu_ps(_gy + j), yi);
+				sum = _mm_add_ps(sum, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy))));
+			}
+			total += horizontalSum(sum);
+			for (; j < n; j++)
+			{
+				float dx = _gx[j] - _gx[i], dy = _gy[j] - _gy[i];
+				total += sqrtf(dx * dx + dy * dy);
+			}
+		}
+		result.meanDistance = total / (n * (n - 1) / 2);
+	}
+
+private:
+	static float horizontalSum(__m128 v)
+	{
+		v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+		v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+		return _mm_cvtss_f32(v);
+	}
+
+	static float horizontalMin(__m128 v)
+	{
+		v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+		v = _mm_min_ss(v, _mm_shuffle_ps(v, v, 1));
+		return _mm_cvtss_f32(v);
+	}
+
+	static float horizontalMax(__m128 v)
+	{
+		v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+		v = _mm_max_ss(v, _mm_shuffle_ps(v, v, 1));
+		return _mm_cvtss_f32(v);
+	}
+
+	float					_x[MAX_POINTER_SLOTS];
+	float					_y[MAX_POINTER_SLOTS];
+	UINT32					_device[MAX_POINTER_SLOTS];
+	int						_slot[MAX_POINTER_SLOTS];
+	int						_index[MAX_POINTER_SLOTS];
+	UINT32					_count;
+	// Positions of the contacts being aggregated, aligned for SSE loads.
+	alignas(16) float		_gx[MAX_POINTER_SLOTS];
+	alignas(16) float		_gy[MAX_POINTER_SLOTS];
+};
@@ -0,0 +1,422 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+#include <windows.h>
+#include <stdlib.h>
+#include <string.h>
+#include <hidusage.h>
+#include <hidpi.h>
+
+#pragma comment(lib, "hid.lib")
+
+#define MAX_HID_COLLECTIONS			128
+#define MAX_HID_CONTACTS			256
+#define MAX_HID_USAGES				16
+
+// Usages of the digitizer page, not every SDK defines them.
+#define HID_DIGITIZER_PAGE			0x0D
+#define HID_DIGITIZER_TOUCH_SCREEN	0x04
+#define HID_DIGITIZER_TIP_PRESSURE	0x30
+#define HID_DIGITIZER_TIP_SWITCH	0x42
+#define HID_DIGITIZER_CONFIDENCE	0x47
+#define HID_DIGITIZER_WIDTH			0x48
+#define HID_DIGITIZER_HEIGHT		0x49
+#define HID_DIGITIZER_CONTACT_ID	0x51
+#define HID_DIGITIZER_CONTACT_COUNT	0x54
+#define HID_DIGITIZER_SCAN_TIME		0x56
+#define HID_DESKTOP_PAGE			0x01
+#define HID_DESKTOP_X				0x30
+#define HID_DESKTOP_Y				0x31
+
+// Logical range of a report value, empty if the report doesn't have it.
+struct HidRange
+{
+	LONG					min, max;
+
+	bool exists() const
+	{
+		return max > min;
+	}
+
+	float normalize(ULONG value) const
+	{
+		return (float)((LONG)value - min) / (float)(max - min);
+	}
+};
+
+// Values of a finger collection of a multitouch report.
+struct HidCollection
+{
+	USHORT					link;
+	bool					hasId;
+	HidRange				x, y;
+	HidRange				pressure;
+	HidRange				width, height;
+};
+
+// A contact which is down, x and y are its last screen position.
+struct HidTrackedContact
+{
+	ULONG					id;
+	UINT32					frame;				// last frame the contact was reported in
+	float					x, y;
+};
+
+// A contact of a digitizer as decoded from one report.
+struct HidContact
+{
+	ULONG					id;
+	bool					tip;
+	bool					confident;
+	float					x, y;				// 0-1 of the digitizer surface
+	float					width, height;		// 0-1 of the digitizer surface, 0 if unknown
+	ULONG					pressure;			// 0-1024 like POINTER_PEN_INFO, 0 if unknown
+};
+
+// Report layout and contact state of a HID multitouch digitizer read through raw input.
+// Supports parallel and hybrid reporting modes: a frame may be split over several reports, only the first one has the contact count.
+class HidDigitizer
+{
+public:
+	HidDigitizer() : _device(NULL), _screenRect(), _preparsed(NULL), _reportLength(0), _countLink(0), _scanLink(0), _collectionCount(0), _trackedCount(0),
+		_expected(0), _received(0), _frame(0), _ticksPerScanUnit(0), _scanTime(0), _frameTime(0), _hasScanTime(false), _hasConfidence(false) {}
+
+	~HidDigitizer()
+	{
+		release();
+	}
+
+	HANDLE device() const
+	{
+		return _device;
+	}
+
+	// A device which failed to load keeps its handle so that it is not loaded again.
+	bool isLoaded() const
+	{
+		return _preparsed != NULL;
+	}
+
+	// Screen rectangle the digitizer surface maps to.
+	const RECT& screenRect() const
+	{
+		return _screenRect;
+	}
+
+	void setScreenRect(const RECT& rect)
+	{
+		_screenRect = rect;
+	}
+
+	// Scan time is counted in 100 us units.
+	void setFrequency(UINT64 frequency)
+	{
+		_ticksPerScanUnit = (double)frequency / 10000;
+	}
+
+	// Timestamp of the frame being decoded.
+	UINT64 timestamp() const
+	{
+		return _frameTime;
+	}
+
+	// Contacts of the frame being decoded so far, all of them once decode() set frameEnd.
+	UINT32 frameContacts() const
+	{
+		return _received;
+	}
+
+	// Reads the report layout of the device, returns false if it is not a multitouch digitizer.
+	bool load(HANDLE device)
+	{
+		release();
+
+		UINT size = 0;
+		if (GetRawInputDeviceInfo(device, RIDI_PREPARSEDDATA, NULL, &size) != 0 || size == 0) return fail(device);
+		_preparsed = (PHIDP_PREPARSED_DATA)malloc(size);
+		if (!_preparsed || GetRawInputDeviceInfo(device, RIDI_PREPARSEDDATA, _preparsed, &size) == (UINT)-1) return fail(device);
+
+		HIDP_CAPS caps;
+		if (HidP_GetCaps(_preparsed, &caps) != HIDP_STATUS_SUCCESS || caps.UsagePage != HID_DIGITIZER_PAGE) return fail(device);
+
+		USHORT count = caps.NumberInputValueCaps;
+		PHIDP_VALUE_CAPS values = (PHIDP_VALUE_CAPS)malloc(count * sizeof(HIDP_VALUE_CAPS));
+		if (!values || HidP_GetValueCaps(HidP_Input, values, &count, _preparsed) != HIDP_STATUS_SUCCESS)
+		{
+			free(values);
+			return fail(device);
+		}
+
+		for (USHORT i = 0; i < count; i++)
+		{
+			const HIDP_VALUE_CAPS& value = values[i];
+			USAGE usage = value.IsRange ? value.Range.UsageMin : value.NotRange.Usage;
+			if (value.UsagePage == HID_DIGITIZER_PAGE && usage == HID_DIGITIZER_CONTACT_COUNT)
+			{
+				_countLink = value.LinkCollection;
+				continue;
+			}
+			if (value.UsagePage == HID_DIGITIZER_PAGE && usage == HID_DIGITIZER_SCAN_TIME)
+			{
+				_scanLink = value.LinkCollection;
+				_hasScanTime = true;
+				continue;
+			}
+
+			HidCollection* collection = getCollection(value.LinkCollection);
+			if (!collection) continue;
+
+			HidRange range = rangeOf(value);
+			if (value.UsagePage == HID_DESKTOP_PAGE)
+			{
+				if (usage == HID_DESKTOP_X) collection->x = range;
+				else if (usage == HID_DESKTOP_Y) collection->y = range;
+			}
+			else if (value.UsagePage == HID_DIGITIZER_PAGE)
+			{
+				switch (usage)
+				{
+				case HID_DIGITIZER_CONTACT_ID:
+					collection->hasId = true;
+					break;
+				case HID_DIGITIZER_TIP_PRESSURE:
+					collection->pressure = range;
+					break;
+				case HID_DIGITIZER_WIDTH:
+					collection->width = range;
+					break;
+				case HID_DIGITIZER_HEIGHT:
+					collection->height = range;
+					break;
+				}
+			}
+		}
+		free(values);
+
+		// Devices without a confidence usage are confident about every contact.
+		count = caps.NumberInputButtonCaps;
+		PHIDP_BUTTON_CAPS buttons = (PHIDP_BUTTON_CAPS)malloc(count * sizeof(HIDP_BUTTON_CAPS));
+		if (buttons && HidP_GetButtonCaps(HidP_Input, buttons, &count, _preparsed) == HIDP_STATUS_SUCCESS)
+		{
+			for (USHORT i = 0; i < count; i++)
+			{
+				const HIDP_BUTTON_CAPS& button = buttons[i];
+				if (button.UsagePage != HID_DIGITIZER_PAGE) continue;
+				if (button.IsRange ? button.Range.UsageMin <= HID_DIGITIZER_CONFIDENCE && button.Range.UsageMax >= HID_DIGITIZER_CONFIDENCE
+					: button.NotRange.Usage == HID_DIGITIZER_CONFIDENCE) _hasConfidence = true;
+			}
+		}
+		free(buttons);
+
+		// Only collections with a position are fingers.
+		UINT32 fingers = 0;
+		for (UINT32 i = 0; i < _collectionCount; i++)
+		{
+			if (_collections[i].x.exists() && _collections[i].y.exists()) _collections[fingers++] = _collections[i];
+		}
+		_collectionCount = fingers;
+		if (_collectionCount == 0) return fail(device);
+
+		_device = device;
+		_reportLength = caps.InputReportByteLength;
+		return true;
+	}
+
+	void release()
+	{
+		if (_preparsed)
+		{
+			free(_preparsed);
+			_preparsed = NULL;
+		}
+		_device = NULL;
+		_collectionCount = 0;
+		_trackedCount = 0;
+		_expected = _received = 0;
+		_frameTime = 0;
+		_hasScanTime = false;
+		_hasConfidence = false;
+		_countLink = _scanLink = 0;
+	}
+
+	// Decodes contacts of one report which arrived at received. Returns how many were written to contacts, frameEnd is set if this report completed a frame.
+	UINT32 decode(BYTE* report, ULONG length, UINT64 received, HidContact* contacts, UINT32 capacity, bool& frameEnd)
+	{
+		frameEnd = false;
+		if (!_preparsed || length < _reportLength) return 0;
+
+		// Reports without a contact count always have all collections.
+		ULONG value;
+		bool counted = getValue(HID_DIGITIZER_PAGE, _countLink, HID_DIGITIZER_CONTACT_COUNT, report, length, value);
+		if (!counted || value > 0)
+		{
+			// The first report of a frame.
+			_expected = counted ? value : _collectionCount;
+			_received = 0;
+			_frame++;
+			updateTimestamp(report, length, received);
+		}
+		if (_received >= _expected) return 0;
+
+		UINT32 count = 0;
+		for (UINT32 i = 0; i < _collectionCount && _received < _expected && count < capacity; i++)
+		{
+			const HidCollection& collection = _collections[i];
+			HidContact& contact = contacts[count];
+
+			USAGE usages[MAX_HID_USAGES];
+			ULONG usageCount = MAX_HID_USAGES;
+			contact.tip = false;
+			contact.confident = !_hasConfidence;
+			if (HidP_GetUsages(HidP_Input, HID_DIGITIZER_PAGE, collection.link, usages, &usageCount, _preparsed, (PCHAR)report, length) == HIDP_STATUS_SUCCESS)
+			{
+				for (ULONG j = 0; j < usageCount; j++)
+				{
+					if (usages[j] == HID_DIGITIZER_TIP_SWITCH) contact.tip = true;
+					else if (usages[j] == HID_DIGITIZER_CONFIDENCE) contact.confident = true;
+				}
+			}
+
+			contact.id = i;
+			if (collection.hasId)
+				getValue(HID_DIGITIZER_PAGE, collection.link, HID_DIGITIZER_CONTACT_ID, report, length, contact.id);
+			ULONG x = 0, y = 0;
+			getValue(HID_DESKTOP_PAGE, collection.link, HID_DESKTOP_X, report, length, x);
+			getValue(HID_DESKTOP_PAGE, collection.link, HID_DESKTOP_Y, report, length, y);
+			contact.x = collection.x.normalize(x);
+			contact.y = collection.y.normalize(y);
+
+			contact.width = contact.height = 0;
+			contact.pressure = 0;
+			if (collection.width.exists() && getValue(HID_DIGITIZER_PAGE, collection.link, HID_DIGITIZER_WIDTH, report, length, value))
+				contact.width = collection.width.normalize(value);
+			if (collection.height.exists() && getValue(HID_DIGITIZER_PAGE, collection.link, HID_DIGITIZER_HEIGHT, report, length, value))
+				contact.height = collection.height.normalize(value);
+			if (collection.pressure.exists() && getValue(HID_DIGITIZER_PAGE, collection.link, HID_DIGITIZER_TIP_PRESSURE, report, length, value))
+				contact.pressure = (ULONG)(collection.pressure.normalize(value) * 1024);
+
+			_received++;
+			count++;
+		}
+		frameEnd = _received >= _expected;
+		return count;
+	}
+
+	// Returns the tracked contact, adding it if add is set, or NULL if it is not down or too many contacts are down.
+	HidTrackedContact* track(ULONG id, bool add, bool& added)
+	{
+		added = false;
+		for (UINT32 i = 0; i < _trackedCount; i++)
+		{
+			if (_tracked[i].id == id)
+			{
+				_tracked[i].frame = _frame;
+				return &_tracked[i];
+			}
+		}
+		if (!add || _trackedCount == MAX_HID_CONTACTS) return NULL;
+
+		HidTrackedContact& contact = _tracked[_trackedCount++];
+		contact.id = id;
+		contact.frame = _frame;
+		added = true;
+		return &contact;
+	}
+
+	void untrack(HidTrackedContact* contact)
+	{
+		_trackedCount--;
+		if (contact != &_tracked[_trackedCount]) *contact = _tracked[_trackedCount];
+	}
+
+	// Returns a tracked contact missing from the last complete frame, the device lifted it without a report.
+	HidTrackedContact* findStale()
+	{
+		for (UINT32 i = 0; i < _trackedCount; i++)
+		{
+			if (_tracked[i].frame != _frame) return &_tracked[i];
+		}
+		return NULL;
+	}
+
+private:
+	bool fail(HANDLE device)
+	{
+		release();
+		_device = device;
+		return false;
+	}
+
+	HidCollection* getCollection(USHORT link)
+	{
+		for (UINT32 i = 0; i < _collectionCount; i++)
+		{
+			if (_collections[i].link == link) return &_collections[i];
+		}
+		if (_collectionCount == MAX_HID_COLLECTIONS) return NULL;
+
+		HidCollection& collection = _collections[_collectionCount++];
+		memset(&collection, 0, sizeof(HidCollection));
+		collection.link = link;
+		return &collection;
+	}
+
+	// Converts the scan time of a frame to a QPC timestamp, so samples keep the device's report rate even if reports are read in bursts.
+	void updateTimestamp(BYTE* report, ULONG length, UINT64 received)
+	{
+		ULONG scanTime;
+		if (!_hasScanTime || !getValue(HID_DIGITIZER_PAGE, _scanLink, HID_DIGITIZER_SCAN_TIME, report, length, scanTime))
+		{
+			_frameTime = received;
+			return;
+		}
+
+		UINT64 time = received;
+		if (_frameTime != 0)
+		{
+			// Scan time wraps at 16 bits.
+			time = _frameTime + (UINT64)((double)((scanTime - _scanTime) & 0xFFFF) * _ticksPerScanUnit);
+			// Resync if the device clock ran ahead of arrival or fell more than 100 ms behind.
+			if (time > received || received - time > (UINT64)(_ticksPerScanUnit * 1000)) time = received;
+		}
+		_scanTime = scanTime;
+		_frameTime = time;
+	}
+
+	static HidRange rangeOf(const HIDP_VALUE_CAPS& value)
+	{
+		HidRange range;
+		range.min = value.LogicalMin;
+		range.max = value.LogicalMax;
+		// Unsigned values with the top bit set come out negative.
+		if (range.max < range.min && value.BitSize < 32) range.max = (LONG)((1UL << value.BitSize) - 1);
+		return range;
+	}
+
+	bool getValue(USAGE page, USHORT link, USAGE usage, BYTE* report, ULONG length, ULONG& value) const
+	{
+		return HidP_GetUsageValue(HidP_Input, page, link, usage, &value, _preparsed, (PCHAR)report, length) == HIDP_STATUS_SUCCESS;
+	}
+
+	HANDLE					_device;
+	RECT					_screenRect;
+	PHIDP_PREPARSED_DATA	_preparsed;
+	USHORT					_reportLength;
+	USHORT					_countLink;
+	USHORT					_scanLink;
+	HidCollection			_collections[MAX_HID_COLLECTIONS];
+	UINT32					_collectionCount;
+	HidTrackedContact		_tracked[MAX_HID_CONTACTS];
+	UINT32					_trackedCount;
+	ULONG					_expected;			// contacts in the current frame
+	ULONG					_received;			// contacts of the current frame decoded so far
+	UINT32					_frame;
+	double					_ticksPerScanUnit;
+	ULONG					_scanTime;
+	UINT64					_frameTime;
+	bool					_hasScanTime;
+	bool					_hasConfidence;
+};
@@ -0,0 +1,136 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+
+#define STATS_POINTER_TYPES			6
+#define STATS_DECODE_BUCKETS		16
+
+// Snapshot of the counters returned by GetInputStats().
+// Must match NativeInputStats in managed code.
+struct InputStats
+{
+	UINT64					messages;			// pointer messages handled by the window proc
+	UINT64					events[STATS_POINTER_TYPES];	// delivered events by POINTER_INPUT_TYPE
+	UINT64					frames;				// decoded input frames, a frame is every contact reported at once
+	UINT64					frameContacts;		// sum of contacts of all frames
+	UINT64					maxFrameContacts;
+	UINT64					coalesced;			// updates merged away by OPTION_COALESCE
+	UINT64					suppressed;			// events dropped by stationary and palm filters
+	UINT64					ringHighWater;		// most events ever waiting in the event buffer
+	UINT64					ringDropped;		// events which didn't fit into the event buffer
+	UINT64					decodeTime[STATS_DECODE_BUCKETS];	// messages by decode time, bucket i is below 2^(i+1) microseconds
+};
+
+// Always-on counters of the input path. Every counter is a relaxed atomic, so any thread can read them while the window thread writes.
+class StatsCounters
+{
+public:
+	StatsCounters() : _frequency(1)
+	{
+		reset();
+	}
+
+	void setFrequency(UINT64 frequency)
+	{
+		_frequency = frequency > 0 ? frequency : 1;
+	}
+
+	void reset()
+	{
+		_messages.store(0, std::memory_order_relaxed);
+		for (UINT32 i = 0; i < STATS_POINTER_TYPES; i++) _events[i].store(0, std::memory_order_relaxed);
+		_frames.store(0, std::memory_order_relaxed);
+		_frameContacts.store(0, std::memory_order_relaxed);
+		_maxFrameContacts.store(0, std::memory_order_relaxed);
+		_coalesced.store(0, std::memory_order_relaxed);
+		_suppressed.store(0, std::memory_order_relaxed);
+		_ringHighWater.store(0, std::memory_order_relaxed);
+		_ringDropped.store(0, std::memory_order_relaxed);
+		for (UINT32 i = 0; i < STATS_DECODE_BUCKETS; i++) _decodeTime[i].store(0, std::memory_order_relaxed);
+	}
+
+	// Counts a handled message which took the given number of QPC ticks to decode.
+	void countMessage(UINT64 ticks)
+	{
+		_messages.fetch_add(1, std::memory_order_relaxed);
+
+		UINT64 us = ticks * 1000000 / _frequency;
+		UINT32 bucket = 0;
+		while (us > 1 && bucket < STATS_DECODE_BUCKETS - 1)
+		{
+			us >>= 1;
+			bucket++;
+		}
+		_decodeTime[bucket].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void countEvent(UINT32 type)
+	{
+		if (type < STATS_POINTER_TYPES) _events[type].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void countFrame(UINT32 contacts)
+	{
+		_frames.fetch_add(1, std::memory_order_relaxed);
+		_frameContacts.fetch_add(contacts, std::memory_order_relaxed);
+		raise(_maxFrameContacts, contacts);
+	}
+
+	void countCoalesced()
+	{
+		_coalesced.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void countSuppressed()
+	{
+		_suppressed.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void countDropped(UINT32 count)
+	{
+		_ringDropped.fetch_add(count, std::memory_order_relaxed);
+	}
+
+	void updateRingSize(UINT32 size)
+	{
+		raise(_ringHighWater, size);
+	}
+
+	void read(InputStats& stats) const
+	{
+		stats.messages = _messages.load(std::memory_order_relaxed);
+		for (UINT32 i = 0; i < STATS_POINTER_TYPES; i++) stats.events[i] = _events[i].load(std::memory_order_relaxed);
+		stats.frames = _frames.load(std::memory_order_relaxed);
+		stats.frameContacts = _frameContacts.load(std::memory_order_relaxed);
+		stats.maxFrameContacts = _maxFrameContacts.load(std::memory_order_relaxed);
+		stats.coalesced = _coalesced.load(std::memory_order_relaxed);
+		stats.suppressed = _suppressed.load(std::memory_order_relaxed);
+		stats.ringHighWater = _ringHighWater.load(std::memory_order_relaxed);
+		stats.ringDropped = _ringDropped.load(std::memory_order_relaxed);
+		for (UINT32 i = 0; i < STATS_DECODE_BUCKETS; i++) stats.decodeTime[i] = _decodeTime[i].load(std::memory_order_relaxed);
+	}
+
+private:
+	static void raise(std::atomic<UINT64>& counter, UINT64 value)
+	{
+		UINT64 current = counter.load(std::memory_order_relaxed);
+		while (value > current && !counter.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+	}
+
+	UINT64					_frequency;
+	std::atomic<UINT64>		_messages;
+	std::atomic<UINT64>		_events[STATS_POINTER_TYPES];
+	std::atomic<UINT64>		_frames;
+	std::atomic<UINT64>		_frameContacts;
+	std::atomic<UINT64>		_maxFrameContacts;
+	std::atomic<UINT64>		_coalesced;
+	std::atomic<UINT64>		_suppressed;
+	std::atomic<UINT64>		_ringHighWater;
+	std::atomic<UINT64>		_ringDropped;
+	std::atomic<UINT64>		_decodeTime[STATS_DECODE_BUCKETS];
+};
@@ -0,0 +1,114 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include <stdarg.h>
+#include <stdio.h>
+
+#define LOG_ENTRY_LENGTH			120
+#define LOG_CAPACITY				256
+
+typedef enum
+{
+	LOG_DEBUG,
+	LOG_INFO,
+	LOG_WARNING,
+	LOG_ERROR,
+	LOG_NONE
+} LOG_LEVEL;
+
+// One formatted log line.
+struct LogEntry
+{
+	LOG_LEVEL				level;
+	UINT32					length;
+	wchar_t					text[LOG_ENTRY_LENGTH];
+};
+
+// Bounded multi-producer/single-consumer queue of log lines.
+// Producers format straight into a preallocated cell, a full queue drops the line. No locks, no allocations.
+class LogBuffer
+{
+public:
+	LogBuffer() : _dropped(0)
+	{
+		_level.store(LOG_WARNING);
+		_head.store(0);
+		_tail = 0;
+		for (UINT32 i = 0; i < LOG_CAPACITY; i++) _cells[i].sequence.store(i);
+	}
+
+	void setLevel(LOG_LEVEL level)
+	{
+		_level.store(level, std::memory_order_relaxed);
+	}
+
+	bool isEnabled(LOG_LEVEL level) const
+	{
+		return level >= _level.load(std::memory_order_relaxed);
+	}
+
+	// Number of lines which didn't fit and were dropped.
+	UINT32 dropped() const
+	{
+		return _dropped.load(std::memory_order_relaxed);
+	}
+
+	// Producer. Any thread.
+	void write(LOG_LEVEL level, const wchar_t* format, va_list args)
+	{
+		if (!isEnabled(level)) return;
+
+		UINT32 position = _head.load(std::memory_order_relaxed);
+		Cell* cell;
+		for (;;)
+		{
+			cell = &_cells[position % LOG_CAPACITY];
+			INT32 diff = (INT32)(cell->sequence.load(std::memory_order_acquire) - position);
+			if (diff == 0)
+			{
+				if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+			}
+			else if (diff < 0)
+			{
+				_dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			else position = _head.load(std::memory_order_relaxed);
+		}
+
+		int length = _vsnwprintf_s(cell->entry.text, LOG_ENTRY_LENGTH, _TRUNCATE, format, args);
+		cell->entry.level = level;
+		cell->entry.length = length < 0 ? (UINT32)wcslen(cell->entry.text) : (UINT32)length;
+		cell->sequence.store(position + 1, std::memory_order_release);
+	}
+
+	// Consumer. Copies the oldest line to entry, returns false if there is none.
+	bool read(LogEntry& entry)
+	{
+		Cell& cell = _cells[_tail % LOG_CAPACITY];
+		if (cell.sequence.load(std::memory_order_acquire) != _tail + 1) return false;
+
+		entry = cell.entry;
+		cell.sequence.store(_tail + LOG_CAPACITY, std::memory_order_release);
+		_tail++;
+		return true;
+	}
+
+private:
+	struct Cell
+	{
+		std::atomic<UINT32>	sequence;
+		LogEntry			entry;
+	};
+
+	Cell					_cells[LOG_CAPACITY];
+	std::atomic<UINT32>		_head;
+	UINT32					_tail;
+	std::atomic<int>		_level;
+	std::atomic<UINT32>		_dropped;
+};
@@ -0,0 +1,102 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+#include <windows.h>
+
+// Bump when the layout of PackedEvent changes, GetEventFormat() reports it together with the size.
+#define PACKED_EVENT_VERSION		1
+
+// The form events are stored in event buffers, TUIO buffers and capture files. Managed code drains arrays of it
+// with a plain copy, so it only has fixed size fields in order of their alignment and no padding: 48 bytes, 8 byte aligned.
+// Must match PackedEvent in managed code.
+//
+// Values are quantized to what the OS reports anyway:
+// - pressure is 0-1024 for touch and pen,
+// - rotation is 0-359 degrees, TUIO angles are in TUIO_ANGLE_SCALE units and still fit,
+// - tilt is -90..90 degrees, TUIO sizes in TUIO_SIZE_SCALE units are clamped to 16 bits,
+// - received is stored as ticks after timestamp and saturates after 2^32 ticks.
+struct PackedEvent
+{
+	UINT64					timestamp;		// time of the sample, QPC ticks on Windows, CLOCK_MONOTONIC nanoseconds on Linux
+	float					x, y;
+	INT32					id;
+	UINT32					pointerFlags;	// POINTER_FLAGS
+	UINT32					flags;			// TOUCH_FLAGS, PEN_FLAGS or the class id of a TUIO object
+	UINT32					receivedDelta;	// ticks from timestamp until the event was received
+	UINT16					event;
+	BYTE					type;			// POINTER_INPUT_TYPE
+	BYTE					device;			// index of the source device, see GetDevices()
+	INT16					slot;			// dense index from PointerSlots, -1 if all slots were taken
+	UINT16					pressure;
+	UINT16					rotation;
+	INT16					tiltX;
+	INT16					tiltY;
+	BYTE					mask;			// TOUCH_MASK, PEN_MASK or TUIO_KIND
+	BYTE					changedButtons;	// POINTER_BUTTON_CHANGE_TYPE
+};
+
+static_assert(sizeof(PackedEvent) == 48, "PackedEvent must stay 48 bytes.");
+
+// Version in the high and record size in the low 16 bits.
+#define PACKED_EVENT_FORMAT			((PACKED_EVENT_VERSION << 16) | sizeof(PackedEvent))
+
+inline INT16 clampInt16(INT32 value)
+{
+	return value < -32768 ? -32768 : value > 32767 ? 32767 : (INT16)value;
+}
+
+inline UINT16 clampUInt16(UINT32 value)
+{
+	return value > 65535 ? 65535 : (UINT16)value;
+}
+
+// Works with the EventRecord of both plugins, they have the same fields.
+template <typename T>
+PackedEvent packEvent(const T& record)
+{
+	PackedEvent packed;
+	packed.timestamp = record.timestamp;
+	packed.x = record.position.x;
+	packed.y = record.position.y;
+	packed.id = record.id;
+	packed.pointerFlags = (UINT32)record.data.pointerFlags;
+	packed.flags = record.data.flags;
+	UINT64 delta = record.received > record.timestamp ? record.received - record.timestamp : 0;
+	packed.receivedDelta = delta > 0xFFFFFFFF ? 0xFFFFFFFF : (UINT32)delta;
+	packed.event = (UINT16)record.event;
+	packed.type = (BYTE)record.type;
+	packed.device = (BYTE)record.device;
+	packed.slot = (INT16)record.slot;
+	packed.pressure = clampUInt16(record.data.pressure);
+	packed.rotation = clampUInt16(record.data.rotation);
+	packed.tiltX = clampInt16(record.data.tiltX);
+	packed.tiltY = clampInt16(record.data.tiltY);
+	packed.mask = (BYTE)record.data.mask;
+	packed.changedButtons = (BYTE)record.data.changedButtons;
+	return packed;
+}
+
+template <typename T>
+void unpackEvent(const PackedEvent& packed, T& record)
+{
+	record.id = packed.id;
+	record.event = packed.event;
+	record.type = (decltype(record.type))packed.type;
+	record.position.x = packed.x;
+	record.position.y = packed.y;
+	record.data.pointerFlags = (decltype(record.data.pointerFlags))packed.pointerFlags;
+	record.data.flags = packed.flags;
+	record.data.mask = packed.mask;
+	record.data.changedButtons = (decltype(record.data.changedButtons))packed.changedButtons;
+	record.data.rotation = packed.rotation;
+	record.data.pressure = packed.pressure;
+	record.data.tiltX = packed.tiltX;
+	record.data.tiltY = packed.tiltY;
+	record.slot = packed.slot;
+	record.device = packed.device;
+	record.timestamp = packed.timestamp;
+	record.received = packed.timestamp + packed.receivedDelta;
+}
@@ -0,0 +1,146 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+#include <windows.h>
+#include <math.h>
+
+#define MAX_FILTER_POINTERS			64
+
+// Smoothed position of a pointer and its speed, see OneEuroFilter.
+struct JitterState
+{
+	float					x, y;
+	float					dx, dy;
+	UINT64					timestamp;
+	bool					initialized;
+};
+
+// Last delivered state of a pointer, used to drop updates which don't change anything and to remember palms.
+struct FilterState
+{
+	int						id;
+	float					x, y;
+	UINT32					pressure;
+	UINT32					rotation;
+	UINT32					pointerFlags;
+	bool					delivered;
+	bool					palm;
+	JitterState				jitter;
+};
+
+// Adaptive low-pass filter by Casiez, Roussel and Vogel: a slow pointer is smoothed heavily to remove jitter,
+// a fast one barely at all to keep lag low. Cutoffs are in Hz, beta in 1/px.
+class OneEuroFilter
+{
+public:
+	OneEuroFilter() : _frequency(1), _minCutoff(1), _beta(.007f), _derivativeCutoff(1) {}
+
+	void setFrequency(UINT64 frequency)
+	{
+		_frequency = frequency > 0 ? (double)frequency : 1;
+	}
+
+	void setParams(float minCutoff, float beta, float derivativeCutoff)
+	{
+		_minCutoff = minCutoff > 0 ? minCutoff : .001f;
+		_beta = beta;
+		_derivativeCutoff = derivativeCutoff > 0 ? derivativeCutoff : .001f;
+	}
+
+	// Replaces x and y with the filtered position.
+	void apply(JitterState& state, UINT64 timestamp, float& x, float& y) const
+	{
+		if (!state.initialized)
+		{
+			state.x = x;
+			state.y = y;
+			state.dx = state.dy = 0;
+			state.timestamp = timestamp;
+			state.initialized = true;
+			return;
+		}
+
+		// Samples without a newer timestamp can't be weighted, they keep the filtered position.
+		float dt = timestamp > state.timestamp ? (float)((double)(timestamp - state.timestamp) / _frequency) : 0;
+		if (dt <= 0)
+		{
+			x = state.x;
+			y = state.y;
+			return;
+		}
+
+		float a = alpha(_derivativeCutoff, dt);
+		state.dx += a * ((x - state.x) / dt - state.dx);
+		state.dy += a * ((y - state.y) / dt - state.dy);
+
+		float speed = sqrtf(state.dx * state.dx + state.dy * state.dy);
+		a = alpha(_minCutoff + _beta * speed, dt);
+		state.x += a * (x - state.x);
+		state.y += a * (y - state.y);
+		state.timestamp = timestamp;
+
+		x = state.x;
+		y = state.y;
+	}
+
+private:
+	static float alpha(float cutoff, float dt)
+	{
+		float tau = 1 / (2 * 3.14159265f * cutoff);
+		return 1 / (1 + tau / dt);
+	}
+
+	double					_frequency;
+	float					_minCutoff;
+	float					_beta;
+	float					_derivativeCutoff;
+};
+
+// Fixed-size set of filter states for active pointers, no allocations.
+class PointerFilter
+{
+public:
+	PointerFilter() : _count(0) {}
+
+	FilterState* find(int id)
+	{
+		for (UINT32 i = 0; i < _count; i++)
+		{
+			if (_states[i].id == id) return &_states[i];
+		}
+		return NULL;
+	}
+
+	// Returns the state of the pointer, adding it if needed, or NULL if there's no space left.
+	FilterState* get(int id)
+	{
+		FilterState* state = find(id);
+		if (state) return state;
+		if (_count == MAX_FILTER_POINTERS) return NULL;
+
+		state = &_states[_count++];
+		state->id = id;
+		state->delivered = false;
+		state->palm = false;
+		state->jitter.initialized = false;
+		return state;
+	}
+
+	void remove(FilterState* state)
+	{
+		_count--;
+		if (state != &_states[_count]) *state = _states[_count];
+	}
+
+	void clear()
+	{
+		_count = 0;
+	}
+
+private:
+	FilterState				_states[MAX_FILTER_POINTERS];
+	UINT32					_count;
+};
@@ -0,0 +1,220 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+#include <windows.h>
+#include "PointerSlots.h"
+#include "PositionLatch.h"
+
+typedef enum
+{
+	PREDICT_NONE,
+	// Extrapolates the velocity between the last two samples.
+	PREDICT_LINEAR,
+	// Extrapolates velocity and acceleration of the last three samples.
+	PREDICT_CONSTANT_ACCELERATION,
+	// Extrapolates the velocity estimated by a constant velocity Kalman filter.
+	PREDICT_KALMAN
+} PREDICTION_MODE;
+
+// Per axis state of the Kalman filter: position, velocity and their covariance.
+struct KalmanAxis
+{
+	float					p, v;
+	float					pp, pv, vv;
+};
+
+// Motion of one slot fed by every delivered sample, extrapolated to a target time on request.
+class PointerPredictor
+{
+public:
+	PointerPredictor() : _frequency(1), _processNoise(4000000), _measurementNoise(1), _maxHorizon(.05f)
+	{
+		clear();
+	}
+
+	void setFrequency(UINT64 frequency)
+	{
+		_frequency = frequency > 0 ? (double)frequency : 1;
+	}
+
+	// Process noise is the variance of acceleration in (px/s^2)^2, measurement noise the variance of a sample position in px^2.
+	void setParams(float processNoise, float measurementNoise, float maxHorizon)
+	{
+		_processNoise = processNoise;
+		_measurementNoise = measurementNoise;
+		_maxHorizon = maxHorizon;
+	}
+
+	void clear()
+	{
+		for (UINT32 i = 0; i < MAX_POINTER_SLOTS; i++) _states[i].samples = 0;
+	}
+
+	void remove(int slot)
+	{
+		if (slot >= 0 && slot < MAX_POINTER_SLOTS) _states[slot].samples = 0;
+	}
+
+	void update(int slot, int id, UINT32 type, UINT32 device, PREDICTION_MODE mode, UINT64 timestamp, float x, float y)
+	{
+		if (slot < 0 || slot >= MAX_POINTER_SLOTS) return;
+
+		State& state = _states[slot];
+		if (state.samples == 0 || state.mode != mode || state.id != id)
+		{
+			state.mode = mode;
+			state.id = id;
+			state.type = type;
+			state.device = device;
+			state.samples = 1;
+			state.timestamp = timestamp;
+			state.x = x;
+			state.y = y;
+			state.vx = state.vy = state.ax = state.ay = 0;
+			resetAxis(state.kx, x);
+			resetAxis(state.ky, y);
+			return;
+		}
+
+		float dt = (float)((double)(timestamp - state.timestamp) / _frequency);
+		// Samples with the same timestamp only refine the position.
+		if (timestamp <= state.timestamp || dt <= 0)
+		{
+			state.x = x;
+			state.y = y;
+			return;
+		}
+
+		if (mode == PREDICT_KALMAN)
+		{
+			updateAxis(state.kx, x, dt);
+			updateAxis(state.ky, y, dt);
+		}
+		else
+		{
+			float vx = (x - state.x) / dt, vy = (y - state.y) / dt;
+			if (state.samples > 1)
+			{
+				state.ax = (vx - state.vx) / dt;
+				state.ay = (vy - state.vy) / dt;
+			}
+			state.vx = vx;
+			state.vy = vy;
+		}
+
+		if (state.samples < 3) state.samples++;
+		state.timestamp = timestamp;
+		state.x = x;
+		state.y = y;
+	}
+
+	// Returns false if the slot has no motion to extrapolate, x and y are left unchanged then.
+	bool predict(int slot, UINT64 target, float& x, float& y) const
+	{
+		if (slot < 0 || slot >= MAX_POINTER_SLOTS) return false;
+
+		const State& state = _states[slot];
+		if (state.samples < 2 || target <= state.timestamp) return false;
+
+		// A pointer which stopped sending samples is resting, its last velocity is stale.
+		float h = (float)((double)(target - state.timestamp) / _frequency);
+		if (h > _maxHorizon) return false;
+
+		switch (state.mode)
+		{
+		case PREDICT_LINEAR:
+			x = state.x + state.vx * h;
+			y = state.y + state.vy * h;
+			return true;
+		case PREDICT_CONSTANT_ACCELERATION:
+			if (state.samples < 3) return false;
+			x = state.x + state.vx * h + .5f * state.ax * h * h;
+			y = state.y + state.vy * h + .5f * state.ay * h * h;
+			return true;
+		case PREDICT_KALMAN:
+			x = state.kx.p + state.kx.v * h;
+			y = state.ky.p + state.ky.v * h;
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	// Writes positions of all tracked slots, returns how many were written.
+	// Slots which can't be extrapolated get their last sample, so a resting pointer returns to where it really is.
+	UINT32 predictAll(UINT64 target, LatchedPosition* buffer, UINT32 capacity) const
+	{
+		UINT32 count = 0;
+		for (int i = 0; i < MAX_POINTER_SLOTS && count < capacity; i++)
+		{
+			if (_states[i].samples == 0) continue;
+
+			LatchedPosition& entry = buffer[count];
+			if (!predict(i, target, entry.x, entry.y))
+			{
+				entry.x = _states[i].x;
+				entry.y = _states[i].y;
+			}
+			entry.id = _states[i].id;
+			entry.slot = i;
+			entry.type = _states[i].type;
+			entry.device = _states[i].device;
+			count++;
+		}
+		return count;
+	}
+
+private:
+	struct State
+	{
+		PREDICTION_MODE		mode;
+		INT32				id;
+		UINT32				type;
+		UINT32				device;
+		UINT32				samples;	// up to 3, how many of the fields below are valid
+		UINT64				timestamp;
+		float				x, y;
+		float				vx, vy;
+		float				ax, ay;
+		KalmanAxis			kx, ky;
+	};
+
+	void resetAxis(KalmanAxis& axis, float position) const
+	{
+		axis.p = position;
+		axis.v = 0;
+		axis.pp = _measurementNoise;
+		axis.pv = 0;
+		// Nothing is known about the initial velocity.
+		axis.vv = 1000000;
+	}
+
+	void updateAxis(KalmanAxis& axis, float measurement, float dt) const
+	{
+		// Predict with a constant velocity model, acceleration is white noise.
+		float dt2 = dt * dt;
+		axis.p += axis.v * dt;
+		float pp = axis.pp + dt * (2 * axis.pv + dt * axis.vv) + _processNoise * dt2 * dt2 * .25f;
+		float pv = axis.pv + dt * axis.vv + _processNoise * dt2 * dt * .5f;
+		float vv = axis.vv + _processNoise * dt2;
+
+		// Correct with the measured position.
+		float s = pp + _measurementNoise;
+		float kp = pp / s, kv = pv / s;
+		float residual = measurement - axis.p;
+		axis.p += kp * residual;
+		axis.v += kv * residual;
+		axis.pp = (1 - kp) * pp;
+		axis.pv = (1 - kp) * pv;
+		axis.vv = vv - kv * pv;
+	}
+
+	double					_frequency;
+	float					_processNoise;
+	float					_measurementNoise;
+	float					_maxHorizon;		// seconds, slots with older samples are not predicted
+	State					_states[MAX_POINTER_SLOTS];
+};
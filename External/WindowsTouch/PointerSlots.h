@@ -0,0 +1,77 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+#include <windows.h>
+
+#define MAX_POINTER_SLOTS			256
+
+// Maps sparse OS pointer ids to dense slot indices which stay the same while the pointer is active.
+// The lowest free slot is always taken, so active pointers occupy the first slots and managed code can keep them in a flat array.
+class PointerSlots
+{
+public:
+	PointerSlots()
+	{
+		clear();
+	}
+
+	void clear()
+	{
+		for (UINT32 i = 0; i < MAX_POINTER_SLOTS / 64; i++) _used[i] = 0;
+		_top = 0;
+	}
+
+	// Returns slot of the pointer or -1.
+	int find(int id) const
+	{
+		for (UINT32 i = 0; i < _top; i++)
+		{
+			if (isUsed(i) && _ids[i] == id) return i;
+		}
+		return -1;
+	}
+
+	// Returns slot of the pointer, a new one if the pointer doesn't have it yet, or -1 if all slots are taken.
+	int acquire(int id)
+	{
+		int slot = find(id);
+		if (slot >= 0) return slot;
+
+		for (UINT32 i = 0; i < MAX_POINTER_SLOTS / 64; i++)
+		{
+			if (_used[i] == ~(UINT64)0) continue;
+
+			UINT32 bit = 0;
+			while ((_used[i] & ((UINT64)1 << bit)) != 0) bit++;
+			_used[i] |= (UINT64)1 << bit;
+
+			UINT32 index = i * 64 + bit;
+			_ids[index] = id;
+			if (index >= _top) _top = index + 1;
+			return index;
+		}
+		return -1;
+	}
+
+	void release(int slot)
+	{
+		if (slot < 0 || slot >= MAX_POINTER_SLOTS) return;
+
+		_used[slot / 64] &= ~((UINT64)1 << (slot % 64));
+		while (_top > 0 && !isUsed(_top - 1)) _top--;
+	}
+
+private:
+	bool isUsed(UINT32 slot) const
+	{
+		return (_used[slot / 64] & ((UINT64)1 << (slot % 64))) != 0;
+	}
+
+	INT32					_ids[MAX_POINTER_SLOTS];
+	UINT64					_used[MAX_POINTER_SLOTS / 64];
+	// One past the highest used slot, find() doesn't look further.
+	UINT32					_top;
+};
@@ -0,0 +1,93 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+
+#define MAX_TABLE_POINTERS			64
+
+// Current state of all active pointers stored as structure of arrays, managed code reads it directly.
+// Layout must match WindowsPointerHandler.PointerTable offsets in managed code.
+// Sequence lock: the window thread makes sequence odd while it writes, readers retry if sequence was odd or changed while they were copying.
+struct PointerTable
+{
+	std::atomic<UINT32>		sequence;
+	UINT32					count;
+	UINT64					timestamp[MAX_TABLE_POINTERS];
+	INT32					id[MAX_TABLE_POINTERS];
+	UINT32					type[MAX_TABLE_POINTERS];
+	// Sequence of the last write which changed this row, readers compare it to the sequence of their previous read.
+	UINT32					updated[MAX_TABLE_POINTERS];
+	UINT32					pointerFlags[MAX_TABLE_POINTERS];
+	UINT32					mask[MAX_TABLE_POINTERS];
+	UINT32					pressure[MAX_TABLE_POINTERS];
+	UINT32					rotation[MAX_TABLE_POINTERS];
+	float					x[MAX_TABLE_POINTERS];
+	float					y[MAX_TABLE_POINTERS];
+	INT32					slot[MAX_TABLE_POINTERS];
+	UINT32					device[MAX_TABLE_POINTERS];
+
+	void clear()
+	{
+		beginWrite();
+		count = 0;
+		endWrite();
+	}
+
+	void beginWrite()
+	{
+		sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+
+	void endWrite()
+	{
+		sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Sequence value rows written between beginWrite() and endWrite() are marked with.
+	UINT32 writeSequence() const
+	{
+		return sequence.load(std::memory_order_relaxed) + 1;
+	}
+
+	// Returns row index of the pointer or -1.
+	int find(int pointerId) const
+	{
+		for (UINT32 i = 0; i < count; i++)
+		{
+			if (id[i] == pointerId) return i;
+		}
+		return -1;
+	}
+
+	// Returns index of a new row or -1 if the table is full.
+	int add(int pointerId)
+	{
+		if (count == MAX_TABLE_POINTERS) return -1;
+		id[count] = pointerId;
+		return count++;
+	}
+
+	// Moves the last row in place of the removed one to keep rows dense.
+	void remove(int index)
+	{
+		count--;
+		if ((UINT32)index == count) return;
+		timestamp[index] = timestamp[count];
+		id[index] = id[count];
+		type[index] = type[count];
+		updated[index] = updated[count];
+		pointerFlags[index] = pointerFlags[count];
+		mask[index] = mask[count];
+		pressure[index] = pressure[count];
+		rotation[index] = rotation[count];
+		x[index] = x[count];
+		y[index] = y[count];
+		slot[index] = slot[count];
+		device[index] = device[count];
+	}
+};
@@ -0,0 +1,80 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include "PointerTable.h"
+
+// The freshest known position of an active pointer.
+// Must match WindowsPointerHandler.LatchedPosition in managed code.
+struct LatchedPosition
+{
+	INT32					id;
+	INT32					slot;
+	UINT32					type;
+	UINT32					device;
+	float					x, y;
+};
+
+// Snapshot of pointer positions taken as late as possible before a frame is drawn.
+// Any thread can latch or read. A reader retries while a latch is being written, a latch started while another one is running is skipped.
+class PositionLatch
+{
+public:
+	PositionLatch() : _count(0)
+	{
+		_sequence.store(0);
+		_writing.store(false);
+	}
+
+	// Returns false if another thread is latching right now.
+	bool beginWrite()
+	{
+		bool expected = false;
+		if (!_writing.compare_exchange_strong(expected, true, std::memory_order_acquire)) return false;
+		_sequence.store(_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		return true;
+	}
+
+	void endWrite()
+	{
+		_sequence.store(_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		_writing.store(false, std::memory_order_release);
+	}
+
+	// Must be called between beginWrite() and endWrite().
+	LatchedPosition* entries()
+	{
+		return _entries;
+	}
+
+	void setCount(UINT32 count)
+	{
+		_count = count;
+	}
+
+	UINT32 read(LatchedPosition* buffer, UINT32 capacity) const
+	{
+		for (;;)
+		{
+			UINT32 sequence = _sequence.load(std::memory_order_acquire);
+			if ((sequence & 1) != 0) continue;
+
+			UINT32 count = _count < capacity ? _count : capacity;
+			for (UINT32 i = 0; i < count; i++) buffer[i] = _entries[i];
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (_sequence.load(std::memory_order_relaxed) == sequence) return count;
+		}
+	}
+
+private:
+	std::atomic<UINT32>		_sequence;
+	std::atomic<bool>		_writing;
+	UINT32					_count;
+	LatchedPosition			_entries[MAX_TABLE_POINTERS];
+};
@@ -0,0 +1,140 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include <new>
+
+// Single-producer/single-consumer queue of fixed-size records.
+// The producer (window thread) stages records with push() and makes them visible with commit(),
+// the consumer (managed code) copies them out with pop(). No locks, no allocations after allocate().
+template <typename T>
+class RingBuffer
+{
+public:
+	RingBuffer() : _buffer(NULL), _capacity(0), _mask(0), _staged(0), _dropped(0)
+	{
+		_head.store(0);
+		_tail.store(0);
+	}
+
+	~RingBuffer()
+	{
+		release();
+	}
+
+	// Capacity is rounded up to the next power of two.
+	bool allocate(UINT32 capacity)
+	{
+		release();
+
+		UINT32 size = 1;
+		while (size < capacity) size <<= 1;
+
+		_buffer = new (std::nothrow) T[size];
+		if (!_buffer) return false;
+
+		_capacity = size;
+		_mask = size - 1;
+		_staged = 0;
+		_dropped = 0;
+		_head.store(0);
+		_tail.store(0);
+		return true;
+	}
+
+	void release()
+	{
+		if (_buffer)
+		{
+			delete[] _buffer;
+			_buffer = NULL;
+		}
+		_capacity = 0;
+		_mask = 0;
+	}
+
+	bool isAllocated() const
+	{
+		return _buffer != NULL;
+	}
+
+	UINT32 capacity() const
+	{
+		return _capacity;
+	}
+
+	// Number of committed records which weren't popped yet.
+	UINT32 size() const
+	{
+		return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+	}
+
+	// Number of records ever committed, a position the consumer can later stop at.
+	UINT32 committed() const
+	{
+		return _head.load(std::memory_order_acquire);
+	}
+
+	// Consumer. Number of records before position which weren't popped yet.
+	UINT32 available(UINT32 position) const
+	{
+		return position - _tail.load(std::memory_order_relaxed);
+	}
+
+	// Number of records which didn't fit and were dropped.
+	UINT32 dropped() const
+	{
+		return _dropped;
+	}
+
+	// Producer. Stages a record, it is not visible to the consumer until commit().
+	bool push(const T& item)
+	{
+		UINT32 head = _head.load(std::memory_order_relaxed);
+		UINT32 tail = _tail.load(std::memory_order_acquire);
+		if (head + _staged - tail >= _capacity)
+		{
+			_dropped++;
+			return false;
+		}
+
+		_buffer[(head + _staged) & _mask] = item;
+		_staged++;
+		return true;
+	}
+
+	// Producer. Publishes all staged records at once.
+	void commit()
+	{
+		if (_staged == 0) return;
+		_head.store(_head.load(std::memory_order_relaxed) + _staged, std::memory_order_release);
+		_staged = 0;
+	}
+
+	// Consumer. Copies up to maxCount records to target and returns how many were copied.
+	UINT32 pop(T* target, UINT32 maxCount)
+	{
+		UINT32 tail = _tail.load(std::memory_order_relaxed);
+		UINT32 head = _head.load(std::memory_order_acquire);
+		UINT32 count = head - tail;
+		if (count > maxCount) count = maxCount;
+
+		for (UINT32 i = 0; i < count; i++) target[i] = _buffer[(tail + i) & _mask];
+
+		_tail.store(tail + count, std::memory_order_release);
+		return count;
+	}
+
+private:
+	T*						_buffer;
+	UINT32					_capacity;
+	UINT32					_mask;
+	UINT32					_staged;
+	UINT32					_dropped;
+	std::atomic<UINT32>		_head;
+	std::atomic<UINT32>		_tail;
+};
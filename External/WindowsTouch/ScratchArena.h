@@ -0,0 +1,61 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+#include <windows.h>
+#include <stdlib.h>
+
+// Growable scratch memory for per-message OS queries.
+// Memory is only reallocated when a request doesn't fit, so in the steady state get() doesn't allocate.
+// Only one request is valid at a time: the next get() may move the memory.
+class ScratchArena
+{
+public:
+	ScratchArena() : _memory(NULL), _size(0) {}
+
+	~ScratchArena()
+	{
+		release();
+	}
+
+	bool reserve(size_t size)
+	{
+		if (size <= _size) return true;
+
+		void* memory = realloc(_memory, size);
+		if (!memory) return false;
+
+		_memory = memory;
+		_size = size;
+		return true;
+	}
+
+	void release()
+	{
+		if (_memory)
+		{
+			free(_memory);
+			_memory = NULL;
+		}
+		_size = 0;
+	}
+
+	size_t size() const
+	{
+		return _size;
+	}
+
+	// Returns memory for count items of type T or NULL if it can't be allocated.
+	template <typename T>
+	T* get(size_t count)
+	{
+		if (!reserve(count * sizeof(T))) return NULL;
+		return (T*)_memory;
+	}
+
+private:
+	void*					_memory;
+	size_t					_size;
+};
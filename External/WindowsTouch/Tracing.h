@@ -0,0 +1,61 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+// ETW events of the input path. They are written with TraceLogging, so WPA decodes them without a manifest.
+// The provider is TouchScript.WindowsTouch {B97484DA-705F-514B-58DA-88F20B039725}, the GUID is derived from the name as ETW tools expect.
+// When no session listens, every event costs one branch. Define WINDOWSTOUCH_NO_TRACING to compile all of them out.
+
+#include <windows.h>
+
+#ifndef WINDOWSTOUCH_NO_TRACING
+
+#include <TraceLoggingProvider.h>
+
+TRACELOGGING_DECLARE_PROVIDER(_traceProvider);
+
+#define TRACE_REGISTER()							TraceLoggingRegister(_traceProvider)
+#define TRACE_UNREGISTER()							TraceLoggingUnregister(_traceProvider)
+
+// A pointer message passed GetPointerInfo or GetTouchInputInfo, received is the QPC time it entered the window proc.
+#define TRACE_MESSAGE(msg, pointerId, frameId, received) \
+	TraceLoggingWrite(_traceProvider, "MessageReceived", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE), \
+		TraceLoggingUInt32(msg, "Message"), TraceLoggingUInt32(pointerId, "PointerId"), \
+		TraceLoggingUInt32(frameId, "FrameId"), TraceLoggingUInt64(received, "ReceivedAt"))
+#define TRACE_DECODE_START(frameId) \
+	TraceLoggingWrite(_traceProvider, "Decode", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE), \
+		TraceLoggingOpcode(WINEVENT_OPCODE_START), TraceLoggingUInt32(frameId, "FrameId"))
+#define TRACE_DECODE_STOP(frameId) \
+	TraceLoggingWrite(_traceProvider, "Decode", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE), \
+		TraceLoggingOpcode(WINEVENT_OPCODE_STOP), TraceLoggingUInt32(frameId, "FrameId"))
+#define TRACE_BATCH(frameId, count) \
+	TraceLoggingWrite(_traceProvider, "Batch", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE), \
+		TraceLoggingUInt32(frameId, "FrameId"), TraceLoggingUInt32(count, "Count"))
+#define TRACE_DELEGATE_START(frameId, pointerId, event) \
+	TraceLoggingWrite(_traceProvider, "Delegate", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE), \
+		TraceLoggingOpcode(WINEVENT_OPCODE_START), TraceLoggingUInt32(frameId, "FrameId"), \
+		TraceLoggingInt32(pointerId, "PointerId"), TraceLoggingUInt32(event, "Event"))
+#define TRACE_DELEGATE_STOP(frameId) \
+	TraceLoggingWrite(_traceProvider, "Delegate", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE), \
+		TraceLoggingOpcode(WINEVENT_OPCODE_STOP), TraceLoggingUInt32(frameId, "FrameId"))
+// Managed code copied count events out of the ring buffer.
+#define TRACE_DRAIN(frameId, count, capacity) \
+	TraceLoggingWrite(_traceProvider, "Drain", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE), \
+		TraceLoggingUInt32(frameId, "FrameId"), TraceLoggingUInt32(count, "Count"), \
+		TraceLoggingUInt32(capacity, "Capacity"))
+
+#else
+
+#define TRACE_REGISTER()							E_NOTIMPL
+#define TRACE_UNREGISTER()
+#define TRACE_MESSAGE(msg, pointerId, frameId, received)
+#define TRACE_DECODE_START(frameId)
+#define TRACE_DECODE_STOP(frameId)
+#define TRACE_BATCH(frameId, count)
+#define TRACE_DELEGATE_START(frameId, pointerId, event)
+#define TRACE_DELEGATE_STOP(frameId)
+#define TRACE_DRAIN(frameId, count, capacity)
+
+#endif
@@ -0,0 +1,423 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+#include <windows.h>
+#include <string.h>
+
+#define TUIO_MAX_SESSIONS			256
+#define TUIO_MAX_FRAME_SETS			256
+#define TUIO_MAX_BUNDLE_DEPTH		4
+// fseq values further back than this mean the tracker restarted, not that the frame is late.
+#define TUIO_FRAME_RESTART			100
+
+typedef enum
+{
+	TUIO_CURSOR,
+	TUIO_OBJECT,
+	TUIO_BLOB
+} TUIO_KIND;
+
+typedef enum
+{
+	TUIO_ADDED,
+	TUIO_UPDATED,
+	TUIO_REMOVED
+} TUIO_CHANGE;
+
+// A change of one session when its frame ends. Positions are normalized with y pointing down.
+struct TuioEvent
+{
+	TUIO_CHANGE				change;
+	TUIO_KIND				kind;
+	INT32					id;			// unique for the decoder, session ids of different profiles may collide
+	INT32					classId;	// symbol of an object, -1 otherwise
+	float					x, y;
+	float					angle;		// radians
+	float					width, height;
+};
+
+// Reads arguments of an OSC 1.0 message in place. A read past the end or of a wrong type fails and so do all reads after it.
+class OscArguments
+{
+public:
+	OscArguments(const char* types, const char* data, const char* end) : _types(types), _data(data), _end(end) {}
+
+	bool readInt(INT32& value)
+	{
+		if (!next('i', 4)) return false;
+		value = (INT32)readWord();
+		return true;
+	}
+
+	// Integers are accepted too, some trackers send whole coordinates as ints.
+	bool readFloat(float& value)
+	{
+		if (_types && *_types == 'i')
+		{
+			INT32 integer;
+			if (!readInt(integer)) return false;
+			value = (float)integer;
+			return true;
+		}
+		if (!next('f', 4)) return false;
+		UINT32 word = readWord();
+		memcpy(&value, &word, sizeof(float));
+		return true;
+	}
+
+	bool readString(const char*& value)
+	{
+		if (!_types || *_types != 's') return fail();
+		const char* terminator = (const char*)memchr(_data, 0, _end - _data);
+		if (!terminator) return fail();
+		value = _data;
+		_types++;
+		_data += paddedLength(terminator - _data + 1);
+		if (_data > _end) _data = _end;
+		return true;
+	}
+
+	bool hasMore() const
+	{
+		return _types && *_types != 0;
+	}
+
+	static UINT32 paddedLength(size_t length)
+	{
+		return (UINT32)((length + 3) & ~(size_t)3);
+	}
+
+	static UINT32 readWord(const char* data)
+	{
+		const BYTE* p = (const BYTE*)data;
+		return ((UINT32)p[0] << 24) | ((UINT32)p[1] << 16) | ((UINT32)p[2] << 8) | p[3];
+	}
+
+private:
+	bool next(char type, UINT32 size)
+	{
+		if (!_types || *_types != type || _end - _data < (ptrdiff_t)size) return fail();
+		_types++;
+		return true;
+	}
+
+	UINT32 readWord()
+	{
+		UINT32 word = readWord(_data);
+		_data += 4;
+		return word;
+	}
+
+	bool fail()
+	{
+		_types = NULL;
+		return false;
+	}
+
+	const char*				_types;
+	const char*				_data;
+	const char*				_end;
+};
+
+// Turns TUIO 1.1 and 2.0 packets into added, updated and removed sessions without allocating.
+// TUIO 1.1 profiles 2Dcur, 2Dobj and 2Dblb end their frames with fseq, TUIO 2.0 frames start with frm and end with alv.
+// Every profile keeps its own sessions, a TUIO 2.0 alv covers ptr, tok and bnd components.
+class TuioDecoder
+{
+public:
+	TuioDecoder()
+	{
+		clear();
+	}
+
+	void clear()
+	{
+		_sessionCount = 0;
+		_nextId = 1;
+		_dropped = 0;
+		for (UINT32 i = 0; i < SCOPE_COUNT; i++)
+		{
+			_frames[i].setCount = 0;
+			_frames[i].aliveCount = 0;
+			_frames[i].lastFrame = -1;
+			_frames[i].frameAccepted = true;
+		}
+	}
+
+	// Events which didn't fit into the output since the decoder was cleared.
+	UINT32 dropped() const
+	{
+		return _dropped;
+	}
+
+	// Decodes one UDP datagram and writes changes of the frames it finished. Returns the number of events written.
+	UINT32 decode(const char* packet, UINT32 length, TuioEvent* events, UINT32 capacity)
+	{
+		_events = events;
+		_eventCount = 0;
+		_eventCapacity = capacity;
+		decodePacket(packet, length, 0);
+		return _eventCount;
+	}
+
+private:
+	enum
+	{
+		SCOPE_CURSOR,
+		SCOPE_OBJECT,
+		SCOPE_BLOB,
+		SCOPE_TUIO2,
+		SCOPE_COUNT
+	};
+
+	struct Session
+	{
+		UINT32				scope;
+		INT32				sessionId;
+		TuioEvent			state;
+	};
+
+	struct Frame
+	{
+		TuioEvent			sets[TUIO_MAX_FRAME_SETS];	// id holds the session id until the frame ends
+		UINT32				setCount;
+		INT32				alive[TUIO_MAX_SESSIONS];
+		UINT32				aliveCount;
+		INT32				lastFrame;
+		bool				frameAccepted;
+	};
+
+	void decodePacket(const char* data, UINT32 length, UINT32 depth)
+	{
+		if (length >= 16 && memcmp(data, "#bundle", 8) == 0)
+		{
+			if (depth == TUIO_MAX_BUNDLE_DEPTH) return;
+			// Time tag is ignored, TUIO sends bundles as soon as they are ready.
+			UINT32 offset = 16;
+			while (offset + 4 <= length)
+			{
+				UINT32 size = OscArguments::readWord(data + offset);
+				offset += 4;
+				if (size > length - offset) return;
+				decodePacket(data + offset, size, depth + 1);
+				offset += size;
+			}
+			return;
+		}
+		decodeMessage(data, length);
+	}
+
+	void decodeMessage(const char* data, UINT32 length)
+	{
+		const char* end = data + length;
+		const char* terminator = (const char*)memchr(data, 0, length);
+		if (!terminator || data[0] != '/') return;
+		const char* address = data;
+		const char* types = data + OscArguments::paddedLength(terminator - data + 1);
+		if (types >= end || *types != ',') return;
+		terminator = (const char*)memchr(types, 0, end - types);
+		if (!terminator) return;
+		const char* arguments = types + OscArguments::paddedLength(terminator - types + 1);
+		if (arguments > end) return;
+
+		OscArguments args(types + 1, arguments, end);
+		if (strncmp(address, "/tuio/", 6) == 0)
+		{
+			if (strcmp(address + 6, "2Dcur") == 0) decodeTuio1(SCOPE_CURSOR, args);
+			else if (strcmp(address + 6, "2Dobj") == 0) decodeTuio1(SCOPE_OBJECT, args);
+			else if (strcmp(address + 6, "2Dblb") == 0) decodeTuio1(SCOPE_BLOB, args);
+		}
+		else if (strncmp(address, "/tuio2/", 7) == 0) decodeTuio2(address + 7, args);
+	}
+
+	void decodeTuio1(UINT32 scope, OscArguments& args)
+	{
+		const char* command;
+		if (!args.readString(command)) return;
+		Frame& frame = _frames[scope];
+
+		if (strcmp(command, "set") == 0)
+		{
+			TuioEvent set;
+			set.classId = -1;
+			set.angle = set.width = set.height = 0;
+			bool ok;
+			switch (scope)
+			{
+			case SCOPE_CURSOR:
+				set.kind = TUIO_CURSOR;
+				ok = args.readInt(set.id) && args.readFloat(set.x) && args.readFloat(set.y);
+				break;
+			case SCOPE_OBJECT:
+				set.kind = TUIO_OBJECT;
+				ok = args.readInt(set.id) && args.readInt(set.classId) && args.readFloat(set.x) && args.readFloat(set.y) && args.readFloat(set.angle);
+				break;
+			default:
+				set.kind = TUIO_BLOB;
+				ok = args.readInt(set.id) && args.readFloat(set.x) && args.readFloat(set.y) && args.readFloat(set.angle)
+					&& args.readFloat(set.width) && args.readFloat(set.height);
+				break;
+			}
+			if (ok) addSet(frame, set);
+		}
+		else if (strcmp(command, "alive") == 0)
+		{
+			readAlive(frame, args);
+		}
+		else if (strcmp(command, "fseq") == 0)
+		{
+			INT32 id;
+			if (args.readInt(id) && acceptFrame(frame, id)) endFrame(scope);
+			frame.setCount = 0;
+		}
+	}
+
+	void decodeTuio2(const char* component, OscArguments& args)
+	{
+		Frame& frame = _frames[SCOPE_TUIO2];
+		if (strcmp(component, "frm") == 0)
+		{
+			INT32 id;
+			frame.setCount = 0;
+			frame.frameAccepted = args.readInt(id) && acceptFrame(frame, id);
+			return;
+		}
+		if (strcmp(component, "alv") == 0)
+		{
+			readAlive(frame, args);
+			if (frame.frameAccepted) endFrame(SCOPE_TUIO2);
+			frame.setCount = 0;
+			return;
+		}
+
+		TuioEvent set;
+		set.classId = -1;
+		set.angle = set.width = set.height = 0;
+		INT32 typeUser, component2;
+		bool ok;
+		if (strcmp(component, "ptr") == 0)
+		{
+			set.kind = TUIO_CURSOR;
+			ok = args.readInt(set.id) && args.readInt(typeUser) && args.readInt(component2) && args.readFloat(set.x) && args.readFloat(set.y);
+		}
+		else if (strcmp(component, "tok") == 0)
+		{
+			set.kind = TUIO_OBJECT;
+			ok = args.readInt(set.id) && args.readInt(typeUser) && args.readInt(set.classId) && args.readFloat(set.x) && args.readFloat(set.y)
+				&& args.readFloat(set.angle);
+		}
+		else if (strcmp(component, "bnd") == 0)
+		{
+			set.kind = TUIO_BLOB;
+			ok = args.readInt(set.id) && args.readFloat(set.x) && args.readFloat(set.y) && args.readFloat(set.angle)
+				&& args.readFloat(set.width) && args.readFloat(set.height);
+		}
+		else return;
+		if (ok) addSet(frame, set);
+	}
+
+	void addSet(Frame& frame, const TuioEvent& set)
+	{
+		// A session set twice in one frame keeps the last values.
+		for (UINT32 i = 0; i < frame.setCount; i++)
+		{
+			if (frame.sets[i].id != set.id) continue;
+			frame.sets[i] = set;
+			return;
+		}
+		if (frame.setCount < TUIO_MAX_FRAME_SETS) frame.sets[frame.setCount++] = set;
+	}
+
+	void readAlive(Frame& frame, OscArguments& args)
+	{
+		frame.aliveCount = 0;
+		INT32 id;
+		while (args.hasMore() && frame.aliveCount < TUIO_MAX_SESSIONS && args.readInt(id)) frame.alive[frame.aliveCount++] = id;
+	}
+
+	// Late frames are dropped, -1 means the tracker doesn't number its frames.
+	bool acceptFrame(Frame& frame, INT32 id)
+	{
+		if (id != -1 && id <= frame.lastFrame && frame.lastFrame - id <= TUIO_FRAME_RESTART) return false;
+		frame.lastFrame = id;
+		return true;
+	}
+
+	// Sessions missing from alive are removed, sets of new sessions add them, the rest update.
+	void endFrame(UINT32 scope)
+	{
+		Frame& frame = _frames[scope];
+
+		for (UINT32 i = 0; i < _sessionCount;)
+		{
+			Session& session = _sessions[i];
+			if (session.scope != scope || isAlive(frame, session.sessionId))
+			{
+				i++;
+				continue;
+			}
+			session.state.change = TUIO_REMOVED;
+			emit(session.state);
+			_sessions[i] = _sessions[--_sessionCount];
+		}
+
+		for (UINT32 i = 0; i < frame.setCount; i++)
+		{
+			TuioEvent& set = frame.sets[i];
+			if (!isAlive(frame, set.id)) continue;
+
+			Session* session = findSession(scope, set.id);
+			if (!session)
+			{
+				if (_sessionCount == TUIO_MAX_SESSIONS) continue;
+				session = &_sessions[_sessionCount++];
+				session->scope = scope;
+				session->sessionId = set.id;
+				session->state.id = _nextId;
+				_nextId = _nextId == 0x7FFFFFFF ? 1 : _nextId + 1;
+				set.change = TUIO_ADDED;
+			}
+			else set.change = TUIO_UPDATED;
+
+			set.id = session->state.id;
+			session->state = set;
+			emit(set);
+		}
+	}
+
+	bool isAlive(const Frame& frame, INT32 sessionId) const
+	{
+		for (UINT32 i = 0; i < frame.aliveCount; i++)
+		{
+			if (frame.alive[i] == sessionId) return true;
+		}
+		return false;
+	}
+
+	Session* findSession(UINT32 scope, INT32 sessionId)
+	{
+		for (UINT32 i = 0; i < _sessionCount; i++)
+		{
+			if (_sessions[i].scope == scope && _sessions[i].sessionId == sessionId) return &_sessions[i];
+		}
+		return NULL;
+	}
+
+	void emit(const TuioEvent& event)
+	{
+		if (_eventCount < _eventCapacity) _events[_eventCount++] = event;
+		else _dropped++;
+	}
+
+	Session					_sessions[TUIO_MAX_SESSIONS];
+	UINT32					_sessionCount;
+	Frame					_frames[SCOPE_COUNT];
+	INT32					_nextId;
+	UINT32					_dropped;
+	TuioEvent*				_events;
+	UINT32					_eventCount;
+	UINT32					_eventCapacity;
+};
@@ -0,0 +1,68 @@
+/*
+* @author Valentin Simonov / http://va.lent.in/
+*/
+
+#pragma once
+
+// The part of Unity's native plugin interface (PluginAPI/IUnityInterface.h and IUnityGraphics.h) the plugin uses.
+// Layouts must match the ones Unity ships, fields past the last one used here are left out.
+
+#define UNITY_INTERFACE_API			__stdcall
+#define UNITY_INTERFACE_EXPORT		__declspec(dllexport)
+
+struct UnityInterfaceGUID
+{
+	unsigned long long		m_GUIDHigh;
+	unsigned long long		m_GUIDLow;
+};
+
+struct IUnityInterface
+{
+};
+
+struct IUnityInterfaces
+{
+	IUnityInterface*		(UNITY_INTERFACE_API * GetInterface)(UnityInterfaceGUID guid);
+	void					(UNITY_INTERFACE_API * RegisterInterface)(UnityInterfaceGUID guid, IUnityInterface* ptr);
+};
+
+typedef enum
+{
+	kUnityGfxRendererOpenGL = 0,
+	kUnityGfxRendererD3D9 = 1,
+	kUnityGfxRendererD3D11 = 2,
+	kUnityGfxRendererGCM = 3,
+	kUnityGfxRendererNull = 4,
+	kUnityGfxRendererOpenGLES20 = 8,
+	kUnityGfxRendererOpenGLES30 = 11,
+	kUnityGfxRendererGXM = 12,
+	kUnityGfxRendererPS4 = 13,
+	kUnityGfxRendererXboxOne = 14,
+	kUnityGfxRendererMetal = 16,
+	kUnityGfxRendererOpenGLCore = 17,
+	kUnityGfxRendererD3D12 = 18,
+	kUnityGfxRendererVulkan = 21
+} UnityGfxRenderer;
+
+typedef enum
+{
+	kUnityGfxDeviceEventInitialize = 0,
+	kUnityGfxDeviceEventShutdown = 1,
+	kUnityGfxDeviceEventBeforeReset = 2,
+	kUnityGfxDeviceEventAfterReset = 3
+} UnityGfxDeviceEventType;
+
+typedef void (UNITY_INTERFACE_API * IUnityGraphicsDeviceEventCallback)(UnityGfxDeviceEventType eventType);
+
+// {7CBA0A9C-A4DD-B544-8C5A-D4926EB17B11}
+const UnityInterfaceGUID	IUnityGraphicsGUID = {0x7CBA0A9CA4DDB544ULL, 0x8C5AD4926EB17B11ULL};
+
+struct IUnityGraphics : IUnityInterface
+{
+	UnityGfxRenderer		(UNITY_INTERFACE_API * GetRenderer)();
+	void					(UNITY_INTERFACE_API * RegisterDeviceEventCallback)(IUnityGraphicsDeviceEventCallback callback);
+	void					(UNITY_INTERFACE_API * UnregisterDeviceEventCallback)(IUnityGraphicsDeviceEventCallback callback);
+};
+
+// Called on the render thread with the id passed to GL.IssuePluginEvent.
+typedef void (UNITY_INTERFACE_API * UnityRenderingEvent)(int eventId);
@@ -7,184 +7,2351 @@
 extern "C" 
 {
 
-	void __stdcall Init(TOUCH_API api, LogFuncPtr logFunc, PointerDelegatePtr delegate)
+	// Unity calls this when it loads the plugin, before any managed code runs.
+	void UNITY_INTERFACE_API UnityPluginLoad(IUnityInterfaces* unityInterfaces)
 	{
-		_log = logFunc;
-		_delegate = delegate;
+		_unityInterfaces = unityInterfaces;
+		_unityGraphics = (IUnityGraphics*)unityInterfaces->GetInterface(IUnityGraphicsGUID);
+		if (!_unityGraphics) return;
+
+		_unityGraphics->RegisterDeviceEventCallback(onGraphicsDeviceEvent);
+		// The device may already exist.
+		onGraphicsDeviceEvent(kUnityGfxDeviceEventInitialize);
+	}
+
+	void UNITY_INTERFACE_API UnityPluginUnload()
+	{
+		if (_unityGraphics) _unityGraphics->UnregisterDeviceEventCallback(onGraphicsDeviceEvent);
+		_unityGraphics = NULL;
+		_unityInterfaces = NULL;
+	}
+
+	void __stdcall Init(TOUCH_API api, PointerDelegatePtr delegate)
+	{
+		InputContext& context = _contexts[DEFAULT_CONTEXT];
+		unhookWindow(context);
 		_api = api;
+		if (!_traceRegistered) _traceRegistered = TRACE_REGISTER() == S_OK;
+
+		HWND window = findUnityWindow();
+		if (!window)
+		{
+			log(LOG_ERROR, L"Unity window not found.");
+			return;
+		}
+		_scratch.reserve(DEFAULT_SCRATCH_SIZE);
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		_predictor.setFrequency(frequency.QuadPart);
+		_jitterFilter.setFrequency(frequency.QuadPart);
+
+		HINSTANCE h = LoadLibrary(TEXT("user32.dll"));
+		GetPointerDevice = (GET_POINTER_DEVICE)GetProcAddress(h, "GetPointerDevice");
+		GetPointerDeviceRects = (GET_POINTER_DEVICE_RECTS)GetProcAddress(h, "GetPointerDeviceRects");
+		if (api == WIN8)
+		{
+			EnableMouseInPointer = (ENABLE_MOUSE_IN_POINTER)GetProcAddress(h, "EnableMouseInPointer");
+			IsMouseInPointerEnabled = (IS_MOUSE_IN_POINTER_ENABLED)GetProcAddress(h, "IsMouseInPointerEnabled");
+			GetPointerInfo = (GET_POINTER_INFO) GetProcAddress(h, "GetPointerInfo");
+			GetPointerTouchInfo = (GET_POINTER_TOUCH_INFO) GetProcAddress(h, "GetPointerTouchInfo");
+			GetPointerPenInfo = (GET_POINTER_PEN_INFO)GetProcAddress(h, "GetPointerPenInfo");
+			GetPointerFrameTouchInfo = (GET_POINTER_FRAME_TOUCH_INFO)GetProcAddress(h, "GetPointerFrameTouchInfo");
+			GetPointerFramePenInfo = (GET_POINTER_FRAME_PEN_INFO)GetProcAddress(h, "GetPointerFramePenInfo");
+			GetPointerInfoHistory = (GET_POINTER_INFO_HISTORY)GetProcAddress(h, "GetPointerInfoHistory");
+			GetPointerTouchInfoHistory = (GET_POINTER_TOUCH_INFO_HISTORY)GetProcAddress(h, "GetPointerTouchInfoHistory");
+			GetPointerPenInfoHistory = (GET_POINTER_PEN_INFO_HISTORY)GetProcAddress(h, "GetPointerPenInfoHistory");
+			GetPointerFrameTouchInfoHistory = (GET_POINTER_FRAME_TOUCH_INFO_HISTORY)GetProcAddress(h, "GetPointerFrameTouchInfoHistory");
+			GetPointerFramePenInfoHistory = (GET_POINTER_FRAME_PEN_INFO_HISTORY)GetProcAddress(h, "GetPointerFramePenInfoHistory");
+
+			hookWindow(context, window, delegate);
+			log(LOG_INFO, L"Initialized WIN8 input.");
+		}
+		else if (api == RAW)
+		{
+			for (UINT32 i = 0; i < MAX_DEVICES; i++) _digitizers[i].setFrequency(frequency.QuadPart);
+#ifndef _WIN64
+			BOOL wow64 = FALSE;
+			IsWow64Process(GetCurrentProcess(), &wow64);
+			_rawHeaderPadding = wow64 ? 8 : 0;
+#endif
+
+			hookWindow(context, window, delegate);
+			if (registerRawInput(true)) log(LOG_INFO, L"Initialized RAW input.");
+			else log(LOG_ERROR, L"RegisterRawInputDevices failed, error %u.", GetLastError());
+		}
+		else
+		{
+			hookWindow(context, window, delegate);
+			log(LOG_INFO, L"Initialized WIN7 input.");
+		}
+	}
+
+	void __stdcall Dispose()
+	{
+		StopDeliveryThread();
+		StopSyntheticLoad();
+		StopCapture();
+		StopReplay();
+		// The TUIO receiver is owned by TuioInput, it keeps running when the window input is re-created.
+		if (_mouseInPointer) SetMouseInPointer(FALSE);
+		if (_api == RAW && _contexts[DEFAULT_CONTEXT].window) registerRawInput(false);
+		for (UINT32 i = 0; i < MAX_CONTEXTS; i++) unhookWindow(_contexts[i]);
+		_context = &_contexts[DEFAULT_CONTEXT];
+		_batchSize = 0;
+		_lastFrameId = 0;
+		_lastFrameDevice = NULL;
+		_pointerTable.clear();
+		_contactSet.clear();
+		_predictor.clear();
+		for (UINT32 i = 0; i < STATS_POINTER_TYPES; i++) _predictionModes[i] = PREDICT_NONE;
+		_predicting.store(false);
+		_deviceCount = 0;
+		for (UINT32 i = 0; i < MAX_DEVICES; i++) _digitizers[i].release();
+		_coalescedCount = 0;
+		_scratch.release();
+		if (_traceRegistered) TRACE_UNREGISTER();
+		_traceRegistered = false;
+	}
+
+	// Hooks another window of the Unity window thread, e.g. the one of a secondary display.
+	// Returns the context for the Context* exports or -1. Input API and options are the ones of Init(),
+	// the pointer table, prediction and contact aggregates only cover the default context.
+	int __stdcall CreateContext(HWND window, PointerDelegatePtr delegate)
+	{
+		InputContext& first = _contexts[DEFAULT_CONTEXT];
+		if (!first.window)
+		{
+			log(LOG_ERROR, L"Init() must be called before CreateContext().");
+			return -1;
+		}
+		if (!IsWindow(window) || findContext(window))
+		{
+			log(LOG_ERROR, L"Window is not valid or already hooked.");
+			return -1;
+		}
+		// Raw input of a usage goes to a single window of the process.
+		if (_api == RAW)
+		{
+			log(LOG_ERROR, L"RAW input supports only one window.");
+			return -1;
+		}
+		if (GetWindowThreadProcessId(window, NULL) != GetWindowThreadProcessId(first.window, NULL))
+		{
+			log(LOG_ERROR, L"Window belongs to another thread than the Unity window.");
+			return -1;
+		}
+
+		for (int i = DEFAULT_CONTEXT + 1; i < MAX_CONTEXTS; i++)
+		{
+			InputContext& context = _contexts[i];
+			if (context.window) continue;
+
+			AcquireSRWLockExclusive(&context.lock);
+			context.screenWidth = context.screenHeight = 0;
+			context.offsetX = context.offsetY = 0;
+			context.scaleX = context.scaleY = 1;
+			ReleaseSRWLockExclusive(&context.lock);
+			hookWindow(context, window, delegate);
+			log(LOG_INFO, L"Created context %d.", i);
+			return i;
+		}
+		log(LOG_ERROR, L"All %d contexts are in use.", MAX_CONTEXTS);
+		return -1;
+	}
+
+	// The default context is only released by Dispose().
+	void __stdcall DestroyContext(int context)
+	{
+		if (context <= DEFAULT_CONTEXT || context >= MAX_CONTEXTS) return;
+
+		// Queued events of the context have to be published before its event buffer goes away.
+		bool delivering = _deliveryThread != NULL;
+		if (delivering) StopDeliveryThread();
+		unhookWindow(_contexts[context]);
+		if (delivering) StartDeliveryThread();
+	}
+
+	void __stdcall SetScreenParams(int width, int height, float offsetX, float offsetY, float scaleX, float scaleY)
+	{
+		SetContextScreenParams(DEFAULT_CONTEXT, width, height, offsetX, offsetY, scaleX, scaleY);
+	}
+
+	// Can be called from any thread, the window proc picks up the new transform with its next batch.
+	void __stdcall SetContextScreenParams(int context, int width, int height, float offsetX, float offsetY, float scaleX, float scaleY)
+	{
+		InputContext* target = getContext(context);
+		if (!target) return;
+
+		AcquireSRWLockExclusive(&target->lock);
+		target->screenWidth = width;
+		target->screenHeight = height;
+		target->offsetX = offsetX;
+		target->offsetY = offsetY;
+		target->scaleX = scaleX;
+		target->scaleY = scaleY;
+		updateTransform(*target);
+		ReleaseSRWLockExclusive(&target->lock);
+	}
+
+	// Positions are smoothed in screen pixels.
+	void __stdcall SetJitterFilterParams(float minCutoff, float beta, float derivativeCutoff)
+	{
+		AcquireSRWLockExclusive(&_trackingLock);
+		_jitterFilter.setParams(minCutoff, beta, derivativeCutoff);
+		ReleaseSRWLockExclusive(&_trackingLock);
+	}
+
+	void __stdcall SetDeliveryMode(DELIVERY_MODE mode, int capacity)
+	{
+		SetContextDeliveryMode(DEFAULT_CONTEXT, mode, capacity);
+	}
+
+	void __stdcall SetContextDeliveryMode(int context, DELIVERY_MODE mode, int capacity)
+	{
+		InputContext* target = getContext(context);
+		if (!target) return;
+		if (mode == DELIVERY_CALLBACK && _deliveryThread)
+		{
+			log(LOG_ERROR, L"Callback delivery is not available while the delivery thread runs.");
+			return;
+		}
+
+		if (mode == DELIVERY_BUFFERED && target->eventBuffer.isAllocated() && capacity > 0)
+		{
+			// Keep the buffer if rounding the new capacity up to a power of two gives the same size.
+			UINT32 current = target->eventBuffer.capacity();
+			if ((UINT32)capacity > current || (UINT32)capacity <= current / 2)
+			{
+				// The window proc and the delivery thread may be pushing to a buffer in use.
+				if (target->deliveryMode.load(std::memory_order_acquire) == DELIVERY_BUFFERED || _deliveryThread)
+				{
+					log(LOG_ERROR, L"Event buffer can't be resized while buffered delivery is active.");
+					return;
+				}
+				target->eventBuffer.release();
+			}
+		}
+
+		if (mode == DELIVERY_BUFFERED && !target->eventBuffer.isAllocated())
+		{
+			if (capacity <= 0) capacity = DEFAULT_BUFFER_CAPACITY;
+			if (!target->eventBuffer.allocate(capacity))
+			{
+				log(LOG_ERROR, L"Failed to allocate event buffer.");
+				return;
+			}
+		}
+		// The window proc only touches the buffer after it sees the new mode.
+		target->deliveryMode.store(mode, std::memory_order_release);
+		if (mode == DELIVERY_BUFFERED) log(LOG_INFO, L"Switched to buffered delivery.");
+		else log(LOG_INFO, L"Switched to callback delivery.");
+	}
+
+	// Moves filtering, transforms, stats, capture and publishing of events off the window thread.
+	// Every context must use buffered delivery since managed code can't be called from the delivery thread.
+	// Must be called on the window thread, which makes sure no window proc is halfway through a batch.
+	BOOL __stdcall StartDeliveryThread()
+	{
+		if (_deliveryThread) return TRUE;
+
+		HWND window = _contexts[DEFAULT_CONTEXT].window;
+		if (!window || GetWindowThreadProcessId(window, NULL) != GetCurrentThreadId())
+		{
+			log(LOG_ERROR, L"StartDeliveryThread() must be called on the window thread after Init().");
+			return FALSE;
+		}
+		if (_replayRecords)
+		{
+			log(LOG_ERROR, L"Delivery thread can't be started during a replay.");
+			return FALSE;
+		}
+		for (UINT32 i = 0; i < MAX_CONTEXTS; i++)
+		{
+			if (!_contexts[i].window || _contexts[i].deliveryMode.load(std::memory_order_relaxed) == DELIVERY_BUFFERED) continue;
+			log(LOG_ERROR, L"Delivery thread requires buffered delivery in every context.");
+			return FALSE;
+		}
+
+		if (!_inputQueue.allocate(DELIVERY_QUEUE_CAPACITY))
+		{
+			log(LOG_ERROR, L"Failed to allocate delivery queue.");
+			return FALSE;
+		}
+		// Events of the current batch were already processed on this thread.
+		flushBatch();
+		_deliveryWake = CreateEvent(NULL, FALSE, FALSE, NULL);
+		_delivering.store(true, std::memory_order_release);
+		_deliveryThread = CreateThread(NULL, 0, deliveryThread, NULL, 0, NULL);
+		if (!_deliveryThread)
+		{
+			_delivering.store(false, std::memory_order_release);
+			CloseHandle(_deliveryWake);
+			_deliveryWake = NULL;
+			_inputQueue.release();
+			log(LOG_ERROR, L"Failed to start delivery thread.");
+			return FALSE;
+		}
+		log(LOG_INFO, L"Started delivery thread.");
+		return TRUE;
+	}
+
+	void __stdcall StopDeliveryThread()
+	{
+		if (!_deliveryThread) return;
+
+		// The thread publishes whatever is left in the queue before it exits.
+		_delivering.store(false, std::memory_order_release);
+		SetEvent(_deliveryWake);
+		WaitForSingleObject(_deliveryThread, INFINITE);
+		CloseHandle(_deliveryThread);
+		_deliveryThread = NULL;
+		CloseHandle(_deliveryWake);
+		_deliveryWake = NULL;
+		_inputQueue.release();
+		log(LOG_INFO, L"Stopped delivery thread.");
+	}
+
+	void __stdcall SetOptions(UINT32 options)
+	{
+		// Contacts which changed while tracking was off are stale.
+		if ((options & ~_options.load(std::memory_order_relaxed) & OPTION_CONTACT_AGGREGATES) != 0)
+		{
+			AcquireSRWLockExclusive(&_trackingLock);
+			_contactSet.clear();
+			ReleaseSRWLockExclusive(&_trackingLock);
+		}
+		_options.store(options, std::memory_order_relaxed);
+	}
+
+	// Makes Windows send mouse input as WM_POINTER messages, every mouse then gets its own device index.
+	// Returns whether mouse input arrives as pointer messages now.
+	BOOL __stdcall SetMouseInPointer(BOOL enable)
+	{
+		if (!EnableMouseInPointer || !IsMouseInPointerEnabled)
+		{
+			log(LOG_WARNING, L"EnableMouseInPointer is only available with WIN8 API.");
+			return FALSE;
+		}
+
+		if ((IsMouseInPointerEnabled() != FALSE) != (enable != FALSE) && !EnableMouseInPointer(enable))
+			log(LOG_WARNING, L"EnableMouseInPointer failed, error %u.", GetLastError());
+		bool enabled = IsMouseInPointerEnabled() != FALSE;
+		registerRawMice(enabled);
+		return enabled ? TRUE : FALSE;
+	}
+
+	void __stdcall SetFilterParams(float positionEpsilon, UINT32 pressureEpsilon, UINT32 rotationEpsilon, UINT32 maxContactArea, BOOL requireConfidence)
+	{
+		AcquireSRWLockExclusive(&_trackingLock);
+		_filterParams.positionEpsilon = positionEpsilon;
+		_filterParams.pressureEpsilon = pressureEpsilon;
+		_filterParams.rotationEpsilon = rotationEpsilon;
+		_filterParams.maxContactArea = maxContactArea;
+		_filterParams.requireConfidence = requireConfidence != FALSE;
+		ReleaseSRWLockExclusive(&_trackingLock);
+	}
+
+	// Marks the start of a frame in every context. With OPTION_FRAME_SYNC events committed later wait for the next frame.
+	void __stdcall BeginFrame()
+	{
+		for (UINT32 i = 0; i < MAX_CONTEXTS; i++)
+		{
+			InputContext& context = _contexts[i];
+			context.frameMark.store(context.eventBuffer.committed(), std::memory_order_release);
+		}
+	}
+
+	int __stdcall GetPointerEvents(PackedEvent* buffer, int capacity)
+	{
+		return GetContextPointerEvents(DEFAULT_CONTEXT, buffer, capacity);
+	}
+
+	int __stdcall GetContextPointerEvents(int context, PackedEvent* buffer, int capacity)
+	{
+		InputContext* source = getContext(context);
+		if (!source || !buffer || capacity <= 0 || !source->eventBuffer.isAllocated()) return 0;
+
+		UINT32 options = _options.load(std::memory_order_relaxed);
+		UINT32 available = (options & OPTION_FRAME_SYNC) != 0 ? source->eventBuffer.available(source->frameMark.load(std::memory_order_acquire)) : 0xFFFFFFFF;
+		UINT32 count;
+		if ((options & OPTION_COALESCE) != 0) count = popCoalesced(*source, buffer, capacity, available, (options & OPTION_COALESCE_HISTORY) != 0);
+		else count = source->eventBuffer.pop(buffer, (UINT32)capacity < available ? capacity : available);
+		TRACE_DRAIN(_traceFrameId, count, capacity);
+		return count;
+	}
+
+	// Copies updates merged away since the last call, oldest first.
+	int __stdcall GetCoalescedEvents(PackedEvent* buffer, int capacity)
+	{
+		if (!buffer || capacity <= 0) return 0;
+
+		UINT32 count = (UINT32)capacity < _coalescedCount ? (UINT32)capacity : _coalescedCount;
+		for (UINT32 i = 0; i < count; i++) buffer[i] = _coalescedEvents[i];
+		_coalescedCount = 0;
+		return count;
+	}
+
+	PointerTable* __stdcall GetPointerTable()
+	{
+		return &_pointerTable;
+	}
+
+	UnityRenderingEvent __stdcall GetRenderEventFunc()
+	{
+		return onRenderEvent;
+	}
+
+	// Main thread version of RENDER_EVENT_LATCH_POSITIONS. Returns FALSE if the pointer table is off or couldn't be read.
+	BOOL __stdcall LatchPositions()
+	{
+		return latchPositions() ? TRUE : FALSE;
+	}
+
+	int __stdcall GetLatchedPositions(LatchedPosition* buffer, int capacity)
+	{
+		if (!buffer || capacity <= 0) return 0;
+		return _positionLatch.read(buffer, capacity);
+	}
+
+	void __stdcall SetPrediction(POINTER_INPUT_TYPE type, PREDICTION_MODE mode)
+	{
+		if ((UINT32)type >= STATS_POINTER_TYPES) return;
+
+		AcquireSRWLockExclusive(&_trackingLock);
+		_predictionModes[type] = mode;
+		bool predicting = false;
+		for (UINT32 i = 0; i < STATS_POINTER_TYPES; i++)
+		{
+			if (_predictionModes[i] != PREDICT_NONE) predicting = true;
+		}
+		if (!predicting) _predictor.clear();
+		_predicting.store(predicting);
+		ReleaseSRWLockExclusive(&_trackingLock);
+	}
+
+	void __stdcall SetPredictionParams(float processNoise, float measurementNoise, float maxHorizon)
+	{
+		AcquireSRWLockExclusive(&_trackingLock);
+		_predictor.setParams(processNoise, measurementNoise, maxHorizon);
+		ReleaseSRWLockExclusive(&_trackingLock);
+	}
+
+	// Extrapolates every predicted pointer to target, a QPC time usually when the frame will be displayed.
+	int __stdcall PredictPositions(UINT64 target, LatchedPosition* buffer, int capacity)
+	{
+		if (!_predicting || !buffer || capacity <= 0) return 0;
+
+		AcquireSRWLockShared(&_trackingLock);
+		UINT32 count = _predictor.predictAll(target, buffer, capacity);
+		ReleaseSRWLockShared(&_trackingLock);
+		return count;
+	}
+
+	// Writes the aggregate of all active touches followed by one for every device with active touches.
+	// Touches of all contexts are aggregated in coordinates of the default one.
+	int __stdcall GetContactAggregates(ContactAggregate* buffer, int capacity)
+	{
+		if (!buffer || capacity <= 0) return 0;
+
+		const ScreenTransform transform = _contexts[DEFAULT_CONTEXT].transform.read();
+		AcquireSRWLockShared(&_trackingLock);
+		_contactSet.aggregate(AGGREGATE_ALL_DEVICES, transform.scaleX, transform.scaleY, transform.translateX, transform.translateY, buffer[0]);
+		int count = 1;
+		for (UINT32 i = 0; buffer[0].count > 0 && i < _deviceCount && count < capacity; i++)
+		{
+			_contactSet.aggregate(i, transform.scaleX, transform.scaleY, transform.translateX, transform.translateY, buffer[count]);
+			if (buffer[count].count > 0) count++;
+		}
+		ReleaseSRWLockShared(&_trackingLock);
+		return count;
+	}
+
+	// Device indices in event records and aggregates are positions in this list.
+	int __stdcall GetDevices(DeviceInfo* buffer, int capacity)
+	{
+		if (!buffer || capacity <= 0) return 0;
+
+		UINT32 count = _deviceCount < (UINT32)capacity ? _deviceCount : (UINT32)capacity;
+		for (UINT32 i = 0; i < count; i++) buffer[i] = _deviceInfos[i];
+		return count;
+	}
+
+	// Stateless, so it doesn't need Init() and can be called from any thread.
+	int __stdcall SplitClusters(const Vector2* points, int count, int* assignments, Vector2* centers)
+	{
+		if (!points || !assignments || !centers || count < 0) return -1;
+		return ClusterSplit::split(&points[0].x, (UINT32)count, assignments, &centers[0].x);
+	}
+
+	// Injects touches from a separate thread, they arrive at the window proc exactly like the ones from a digitizer.
+	BOOL __stdcall StartSyntheticLoad(int contacts, int hz, SYNTHETIC_PATTERN pattern)
+	{
+		StopSyntheticLoad();
+		if (contacts <= 0 || hz <= 0) return FALSE;
+		if (contacts > MAX_TOUCH_COUNT) contacts = MAX_TOUCH_COUNT;
+		if (hz > MAX_SYNTHETIC_HZ) hz = MAX_SYNTHETIC_HZ;
+
+		if (!InjectTouchInput)
+		{
+			HMODULE h = GetModuleHandle(TEXT("user32.dll"));
+			InitializeTouchInjection = (INITIALIZE_TOUCH_INJECTION)GetProcAddress(h, "InitializeTouchInjection");
+			InjectTouchInput = (INJECT_TOUCH_INPUT)GetProcAddress(h, "InjectTouchInput");
+			if (!InitializeTouchInjection || !InjectTouchInput)
+			{
+				InjectTouchInput = NULL;
+				log(LOG_WARNING, L"Touch injection is not supported.");
+				return FALSE;
+			}
+		}
+		if (!InitializeTouchInjection(contacts, TOUCH_FEEDBACK_NONE))
+		{
+			log(LOG_ERROR, L"Failed to initialize touch injection.");
+			return FALSE;
+		}
+
+		InputContext& context = _contexts[DEFAULT_CONTEXT];
+		GetClientRect(context.window, &_syntheticArea);
+		AcquireSRWLockShared(&context.lock);
+		POINT origin = context.clientOrigin;
+		ReleaseSRWLockShared(&context.lock);
+		_syntheticArea.left += origin.x;
+		_syntheticArea.right += origin.x;
+		_syntheticArea.top += origin.y;
+		_syntheticArea.bottom += origin.y;
+		if (_syntheticArea.right - _syntheticArea.left < 2 || _syntheticArea.bottom - _syntheticArea.top < 2)
+		{
+			log(LOG_WARNING, L"Client area %ldx%ld is too small for synthetic touches.", _syntheticArea.right - _syntheticArea.left, _syntheticArea.bottom - _syntheticArea.top);
+			return FALSE;
+		}
+
+		_syntheticContactCount = contacts;
+		_syntheticHz = hz;
+		_syntheticPattern = pattern;
+		_syntheticRunning.store(true, std::memory_order_release);
+		_syntheticThread = CreateThread(NULL, 0, syntheticLoadThread, NULL, 0, NULL);
+		if (!_syntheticThread)
+		{
+			_syntheticRunning.store(false, std::memory_order_release);
+			log(LOG_ERROR, L"Failed to start synthetic load thread.");
+			return FALSE;
+		}
+		log(LOG_INFO, L"Started synthetic load.");
+		return TRUE;
+	}
+
+	void __stdcall StopSyntheticLoad()
+	{
+		if (!_syntheticThread) return;
+
+		_syntheticRunning.store(false, std::memory_order_release);
+		WaitForSingleObject(_syntheticThread, INFINITE);
+		CloseHandle(_syntheticThread);
+		_syntheticThread = NULL;
+		log(LOG_INFO, L"Stopped synthetic load.");
+	}
+
+	// Appends every delivered event to a file, the file is written by a separate thread.
+	BOOL __stdcall StartCapture(LPCWSTR path)
+	{
+		StopCapture();
+
+		_captureFile = CreateFileW(path, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (_captureFile == INVALID_HANDLE_VALUE)
+		{
+			log(LOG_ERROR, L"Failed to create capture file.");
+			return FALSE;
+		}
+
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		CaptureHeader header;
+		header.magic = CAPTURE_MAGIC;
+		header.version = CAPTURE_VERSION;
+		header.recordSize = sizeof(PackedEvent);
+		header.frequency = frequency.QuadPart;
+		DWORD written;
+		if (!WriteFile(_captureFile, &header, sizeof(CaptureHeader), &written, NULL) || !_captureBuffer.allocate(CAPTURE_BUFFER_CAPACITY))
+		{
+			CloseHandle(_captureFile);
+			_captureFile = INVALID_HANDLE_VALUE;
+			log(LOG_ERROR, L"Failed to start capture.");
+			return FALSE;
+		}
+
+		_captureWake = CreateEvent(NULL, FALSE, FALSE, NULL);
+		_capturing.store(true, std::memory_order_release);
+		_captureThread = CreateThread(NULL, 0, captureThread, NULL, 0, NULL);
+		if (!_captureThread)
+		{
+			_capturing.store(false, std::memory_order_release);
+			CloseHandle(_captureWake);
+			_captureWake = NULL;
+			CloseHandle(_captureFile);
+			_captureFile = INVALID_HANDLE_VALUE;
+			_captureBuffer.release();
+			log(LOG_ERROR, L"Failed to start capture thread.");
+			return FALSE;
+		}
+		log(LOG_INFO, L"Started capture.");
+		return TRUE;
+	}
+
+	void __stdcall StopCapture()
+	{
+		if (!_captureThread) return;
+
+		// The thread writes whatever is left in the buffer before it exits.
+		_capturing.store(false, std::memory_order_release);
+		SetEvent(_captureWake);
+		WaitForSingleObject(_captureThread, INFINITE);
+		CloseHandle(_captureThread);
+		_captureThread = NULL;
+		CloseHandle(_captureWake);
+		_captureWake = NULL;
+		CloseHandle(_captureFile);
+		_captureFile = INVALID_HANDLE_VALUE;
+		if (_captureBuffer.dropped() > 0) log(LOG_WARNING, L"Capture buffer overflowed, %u events were not recorded.", _captureBuffer.dropped());
+		_captureBuffer.release();
+		log(LOG_INFO, L"Stopped capture.");
+	}
+
+	// Maps a capture file, its events are delivered by UpdateReplay() instead of live input.
+	BOOL __stdcall StartReplay(LPCWSTR path, REPLAY_MODE mode)
+	{
+		StopReplay();
+		// Recorded events are delivered on the calling thread.
+		if (_deliveryThread)
+		{
+			log(LOG_ERROR, L"Replay can't be started while the delivery thread runs.");
+			return FALSE;
+		}
+
+		_replayFile = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (_replayFile == INVALID_HANDLE_VALUE)
+		{
+			log(LOG_ERROR, L"Failed to open capture file.");
+			return FALSE;
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(_replayFile, &size) || size.QuadPart < (INT64)(sizeof(CaptureHeader) + sizeof(PackedEvent)))
+		{
+			log(LOG_ERROR, L"Capture file is empty.");
+			StopReplay();
+			return FALSE;
+		}
+
+		_replayMapping = CreateFileMappingW(_replayFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		const CaptureHeader* header = _replayMapping ? (const CaptureHeader*)MapViewOfFile(_replayMapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+		if (!header)
+		{
+			log(LOG_ERROR, L"Failed to map capture file.");
+			StopReplay();
+			return FALSE;
+		}
+		_replayRecords = (const PackedEvent*)(header + 1);
+		if (header->magic != CAPTURE_MAGIC || header->version != CAPTURE_VERSION || header->recordSize != sizeof(PackedEvent))
+		{
+			log(LOG_ERROR, L"Unsupported capture file.");
+			StopReplay();
+			return FALSE;
+		}
+
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		_replayTickScale = (double)header->frequency / frequency.QuadPart;
+		_replayCount = (UINT32)((size.QuadPart - sizeof(CaptureHeader)) / sizeof(PackedEvent));
+		_replayIndex = 0;
+		_replayMode = mode;
+		_replayStart = getTimestamp();
+		_batchSize = 0;
+		log(LOG_INFO, L"Started replay.");
+		return TRUE;
+	}
+
+	// Delivers recorded events which are due, at most maxEvents of them if it is positive.
+	// Returns the number of events left to replay.
+	int __stdcall UpdateReplay(int maxEvents)
+	{
+		if (!_replayRecords) return 0;
+
+		UINT64 now = getTimestamp();
+		UINT64 first = _replayRecords[0].timestamp;
+		UINT64 due = first + (UINT64)((now - _replayStart) * _replayTickScale);
+		UINT32 limit = _replayCount - _replayIndex;
+		if (maxEvents > 0 && (UINT32)maxEvents < limit) limit = maxEvents;
+
+		// Recorded events go to the default context.
+		_context = &_contexts[DEFAULT_CONTEXT];
+		for (UINT32 i = 0; i < limit; i++)
+		{
+			const PackedEvent& recorded = _replayRecords[_replayIndex];
+			if (_replayMode == REPLAY_ORIGINAL_TIMING && recorded.timestamp > due) break;
+
+			// Shift timestamps to now so that latency and velocity code sees a live stream.
+			EventRecord& record = _batch[_batchSize++];
+			unpackEvent(recorded, record);
+			record.timestamp = _replayStart + (UINT64)((recorded.timestamp - first) / _replayTickScale);
+			record.received = now;
+			_replayIndex++;
+			if (_batchSize == MAX_BATCH_SIZE) deliverBatch();
+		}
+		deliverBatch();
+
+		return _replayCount - _replayIndex;
+	}
+
+	// Listens for TUIO 1.1 and 2.0 on the UDP port, GetTuioEvents() returns what arrived since the last call.
+	// Independent of Init() and the window contexts, it has its own buffer.
+	BOOL __stdcall StartTuio(int port)
+	{
+		StopTuio();
+
+		WSADATA data;
+		if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+		{
+			log(LOG_ERROR, L"Failed to initialize Winsock.");
+			return FALSE;
+		}
+
+		sockaddr_in address;
+		memset(&address, 0, sizeof(sockaddr_in));
+		address.sin_family = AF_INET;
+		address.sin_port = htons((USHORT)port);
+		address.sin_addr.s_addr = htonl(INADDR_ANY);
+		// Bursts of bundles from fast trackers shouldn't overflow the socket while the thread is descheduled.
+		int receiveBuffer = TUIO_RECEIVE_BUFFER;
+		ULONG nonBlocking = 1;
+		_tuioSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		if (_tuioSocket == INVALID_SOCKET
+			|| bind(_tuioSocket, (const sockaddr*)&address, sizeof(sockaddr_in)) == SOCKET_ERROR
+			|| ioctlsocket(_tuioSocket, FIONBIO, &nonBlocking) == SOCKET_ERROR)
+		{
+			log(LOG_ERROR, L"Failed to listen on UDP port %d, error %d.", port, WSAGetLastError());
+			if (_tuioSocket != INVALID_SOCKET) closesocket(_tuioSocket);
+			_tuioSocket = INVALID_SOCKET;
+			WSACleanup();
+			return FALSE;
+		}
+		setsockopt(_tuioSocket, SOL_SOCKET, SO_RCVBUF, (const char*)&receiveBuffer, sizeof(int));
+
+		_tuioBuffer.allocate(TUIO_BUFFER_CAPACITY);
+		_tuioDecoder.clear();
+		_tuioSlots.clear();
+		_tuioRunning.store(true, std::memory_order_release);
+		_tuioThread = CreateThread(NULL, 0, tuioThread, NULL, 0, NULL);
+		if (!_tuioThread)
+		{
+			_tuioRunning.store(false, std::memory_order_release);
+			closesocket(_tuioSocket);
+			_tuioSocket = INVALID_SOCKET;
+			WSACleanup();
+			_tuioBuffer.release();
+			log(LOG_ERROR, L"Failed to start TUIO thread.");
+			return FALSE;
+		}
+		log(LOG_INFO, L"Listening to TUIO on port %d.", port);
+		return TRUE;
+	}
+
+	// Sessions which are still active get no removed events, managed code cancels its pointers itself.
+	void __stdcall StopTuio()
+	{
+		if (!_tuioThread) return;
+
+		_tuioRunning.store(false, std::memory_order_release);
+		WaitForSingleObject(_tuioThread, INFINITE);
+		CloseHandle(_tuioThread);
+		_tuioThread = NULL;
+		closesocket(_tuioSocket);
+		_tuioSocket = INVALID_SOCKET;
+		WSACleanup();
+		if (_tuioBuffer.dropped() > 0 || _tuioDecoder.dropped() > 0)
+			log(LOG_WARNING, L"TUIO buffer overflowed, %u events were dropped.", _tuioBuffer.dropped() + _tuioDecoder.dropped());
+		_tuioBuffer.release();
+		log(LOG_INFO, L"Stopped TUIO.");
+	}
+
+	int __stdcall GetTuioEvents(PackedEvent* buffer, int capacity)
+	{
+		if (!buffer || capacity <= 0 || !_tuioBuffer.isAllocated()) return 0;
+		return _tuioBuffer.pop(buffer, capacity);
+	}
+
+	// Managed code checks it before it reads any PackedEvents.
+	UINT32 __stdcall GetEventFormat()
+	{
+		return PACKED_EVENT_FORMAT;
+	}
+
+	void __stdcall GetInputStats(InputStats* stats)
+	{
+		GetContextInputStats(DEFAULT_CONTEXT, stats);
+	}
+
+	void __stdcall GetContextInputStats(int context, InputStats* stats)
+	{
+		InputContext* source = getContext(context);
+		if (source && stats) source->stats.read(*stats);
+	}
+
+	void __stdcall ResetInputStats()
+	{
+		for (UINT32 i = 0; i < MAX_CONTEXTS; i++) _contexts[i].stats.reset();
+	}
+
+	void __stdcall SetLogLevel(LOG_LEVEL level)
+	{
+		_logBuffer.setLevel(level);
+	}
+
+	// Copies the oldest log line to text and returns its length, -1 if there are no lines.
+	int __stdcall GetLogEntry(LOG_LEVEL* level, wchar_t* text, int capacity)
+	{
+		LogEntry entry;
+		if (!text || capacity <= 0 || !_logBuffer.read(entry)) return -1;
+
+		UINT32 length = entry.length < (UINT32)capacity ? entry.length : capacity;
+		memcpy(text, entry.text, length * sizeof(wchar_t));
+		if (level) *level = entry.level;
+		return length;
+	}
+
+	void __stdcall StopReplay()
+	{
+		if (_replayRecords) UnmapViewOfFile((const CaptureHeader*)_replayRecords - 1);
+		_replayRecords = NULL;
+		if (_replayMapping) CloseHandle(_replayMapping);
+		_replayMapping = NULL;
+		if (_replayFile != INVALID_HANDLE_VALUE) CloseHandle(_replayFile);
+		_replayFile = INVALID_HANDLE_VALUE;
+		_replayCount = 0;
+		_replayIndex = 0;
+	}
+
+}
+
+LRESULT CALLBACK wndProc8(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	InputContext* context = findContext(hwnd);
+	if (!context) return DefWindowProc(hwnd, msg, wParam, lParam);
+	_context = context;
+	bool decoded;
+
+	switch (msg)
+	{
+	case WM_TOUCH:
+		CloseTouchInputHandle((HTOUCHINPUT)lParam);
+		break;
+	case WM_INPUT:
+		if (_mouseInPointer) trackMouseDevice((HRAWINPUT)lParam);
+		// DefWindowProc has to clean up after WM_INPUT.
+		return CallWindowProc((WNDPROC)context->oldWindowProc, hwnd, msg, wParam, lParam);
+	case WM_POINTERENTER:
+	case WM_POINTERLEAVE:
+	case WM_POINTERDOWN:
+	case WM_POINTERUP:
+	case WM_POINTERUPDATE:
+	case WM_POINTERCAPTURECHANGED:
+		_messageTime = getTimestamp();
+		decoded = decodeWin8Touches(msg, wParam, lParam);
+		context->stats.countMessage(getTimestamp() - _messageTime);
+		// Messages dropped before decoding didn't emit TRACE_DECODE_START.
+		if (decoded)
+		{
+			TRACE_DECODE_STOP(_traceFrameId);
+		}
+		break;
+	case WM_MOVE:
+	case WM_SIZE:
+	case WM_DPICHANGED:
+		updateClientOrigin(*context);
+		return CallWindowProc((WNDPROC)context->oldWindowProc, hwnd, msg, wParam, lParam);
+	default:
+		return CallWindowProc((WNDPROC)context->oldWindowProc, hwnd, msg, wParam, lParam);
+	}
+	return 0;
+}
+
+LRESULT CALLBACK wndProc7(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	InputContext* context = findContext(hwnd);
+	if (!context) return DefWindowProc(hwnd, msg, wParam, lParam);
+	_context = context;
+	bool decoded;
+
+	switch (msg)
+	{
+	case WM_TOUCH:
+		_messageTime = getTimestamp();
+		decoded = decodeWin7Touches(msg, wParam, lParam);
+		context->stats.countMessage(getTimestamp() - _messageTime);
+		if (decoded)
+		{
+			TRACE_DECODE_STOP(_traceFrameId);
+		}
+		break;
+	case WM_MOVE:
+	case WM_SIZE:
+	case WM_DPICHANGED:
+		updateClientOrigin(*context);
+		return CallWindowProc((WNDPROC)context->oldWindowProc, hwnd, msg, wParam, lParam);
+	default:
+		return CallWindowProc((WNDPROC)context->oldWindowProc, hwnd, msg, wParam, lParam);
+	}
+	return 0;
+}
+
+LRESULT CALLBACK wndProcRaw(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	InputContext* context = findContext(hwnd);
+	if (!context) return DefWindowProc(hwnd, msg, wParam, lParam);
+	_context = context;
+
+	switch (msg)
+	{
+	case WM_INPUT:
+		_messageTime = getTimestamp();
+		_traceFrameId++;
+		TRACE_MESSAGE(msg, 0, _traceFrameId, _messageTime);
+		TRACE_DECODE_START(_traceFrameId);
+		decodeRawInput((HRAWINPUT)lParam);
+		// Reports queued behind this one are decoded now and go out in the same batch.
+		if (ownsRawInputBuffer()) decodeRawInputBuffer();
+		else
+		{
+			MSG pending;
+			while (PeekMessage(&pending, hwnd, WM_INPUT, WM_INPUT, PM_REMOVE))
+			{
+				decodeRawInput((HRAWINPUT)pending.lParam);
+				CallWindowProc((WNDPROC)context->oldWindowProc, hwnd, WM_INPUT, pending.wParam, pending.lParam);
+			}
+		}
+		flushBatch();
+		context->stats.countMessage(getTimestamp() - _messageTime);
+		TRACE_DECODE_STOP(_traceFrameId);
+		// DefWindowProc has to clean up after WM_INPUT.
+		return CallWindowProc((WNDPROC)context->oldWindowProc, hwnd, msg, wParam, lParam);
+	case WM_MOVE:
+	case WM_SIZE:
+	case WM_DPICHANGED:
+		updateClientOrigin(*context);
+		return CallWindowProc((WNDPROC)context->oldWindowProc, hwnd, msg, wParam, lParam);
+	default:
+		return CallWindowProc((WNDPROC)context->oldWindowProc, hwnd, msg, wParam, lParam);
+	}
+}
+
+// Returns false if the message was dropped before decoding started.
+bool decodeWin8Touches(UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	int pointerId = GET_POINTERID_WPARAM(wParam);
+
+	POINTER_INFO pointerInfo;
+	if (!GetPointerInfo(pointerId, &pointerInfo))
+	{
+		log(LOG_WARNING, L"GetPointerInfo failed for pointer %d, error %u.", pointerId, GetLastError());
+		return false;
+	}
+	_traceFrameId = pointerInfo.frameId;
+	_currentDevice = deviceIndex(pointerInfo.pointerType == PT_MOUSE && _mouseDevice ? _mouseDevice : pointerInfo.sourceDevice);
+	TRACE_MESSAGE(msg, pointerId, _traceFrameId, _messageTime);
+	TRACE_DECODE_START(_traceFrameId);
+
+	UINT32 options = _options.load(std::memory_order_relaxed);
+	// Windows only coalesces updates, all other messages have exactly one sample.
+	UINT32 entries = 1;
+	if ((options & OPTION_HISTORY) != 0 && msg == WM_POINTERUPDATE
+		&& (pointerInfo.pointerFlags & POINTER_FLAG_CANCELED) == 0
+		&& pointerInfo.historyCount > 1) entries = pointerInfo.historyCount;
+
+	if ((options & OPTION_FRAME_DECODE) != 0
+		&& msg != WM_POINTERCAPTURECHANGED
+		&& (pointerInfo.pointerType == PT_TOUCH || pointerInfo.pointerType == PT_PEN))
+	{
+		// All contacts of this frame were already sent when we got the first message of the frame.
+		if (pointerInfo.frameId == _lastFrameId && pointerInfo.sourceDevice == _lastFrameDevice) return true;
+		if (decodeWin8Frame(pointerId, pointerInfo, entries))
+		{
+			_lastFrameId = pointerInfo.frameId;
+			_lastFrameDevice = pointerInfo.sourceDevice;
+			return true;
+		}
+	}
+
+	_context->stats.countFrame(1);
+	if (entries > 1 && decodeWin8History(pointerId, pointerInfo, entries)) return true;
+
+	Vector2 position = screenPosition(pointerInfo.ptPixelLocation);
+	PointerData data {};
+	data.pointerFlags = pointerInfo.pointerFlags;
+	data.changedButtons = pointerInfo.ButtonChangeType;
+
+	if ((pointerInfo.pointerFlags & POINTER_FLAG_CANCELED) != 0
+		|| msg == WM_POINTERCAPTURECHANGED) msg = POINTER_CANCELLED;
+
+	switch (pointerInfo.pointerType)
+	{
+	case PT_MOUSE:
+		break;
+	case PT_TOUCH:
+		POINTER_TOUCH_INFO touchInfo;
+		GetPointerTouchInfo(pointerId, &touchInfo);
+		fillPointerData(data, touchInfo);
+		break;
+	case PT_PEN:
+		POINTER_PEN_INFO penInfo;
+		GetPointerPenInfo(pointerId, &penInfo);
+		fillPointerData(data, penInfo);
+		break;
+	}
+
+	emitPointer(pointerId, msg, pointerInfo.pointerType, position, data, pointerInfo.PerformanceCount);
+	flushBatch();
+	return true;
+}
+
+// Reads all contacts of the frame pointerInfo belongs to with one call and sends them as one batch.
+// If entries > 1 also reads coalesced frames and sends them oldest first.
+// Returns false if the frame couldn't be read, in which case the message should be decoded on its own.
+bool decodeWin8Frame(int pointerId, const POINTER_INFO& pointerInfo, UINT32 entries)
+{
+	UINT32 count = MAX_FRAME_POINTERS;
+	if (pointerInfo.pointerType == PT_TOUCH)
+	{
+		POINTER_TOUCH_INFO* touchInfos = _scratch.get<POINTER_TOUCH_INFO>(entries * count);
+		if (!touchInfos) return false;
+		if (entries > 1)
+		{
+			if (!GetPointerFrameTouchInfoHistory || !GetPointerFrameTouchInfoHistory(pointerId, &entries, &count, touchInfos)) return false;
+		}
+		else
+		{
+			if (!GetPointerFrameTouchInfo || !GetPointerFrameTouchInfo(pointerId, &count, touchInfos)) return false;
+		}
+		_context->stats.countFrame(count);
+		emitFrames(touchInfos, entries, count);
+	}
+	else
+	{
+		POINTER_PEN_INFO* penInfos = _scratch.get<POINTER_PEN_INFO>(entries * count);
+		if (!penInfos) return false;
+		if (entries > 1)
+		{
+			if (!GetPointerFramePenInfoHistory || !GetPointerFramePenInfoHistory(pointerId, &entries, &count, penInfos)) return false;
+		}
+		else
+		{
+			if (!GetPointerFramePenInfo || !GetPointerFramePenInfo(pointerId, &count, penInfos)) return false;
+		}
+		_context->stats.countFrame(count);
+		emitFrames(penInfos, entries, count);
+	}
+
+	flushBatch();
+	return true;
+}
+
+// Reads coalesced samples of a single pointer and sends them oldest first as one batch.
+bool decodeWin8History(int pointerId, const POINTER_INFO& pointerInfo, UINT32 entries)
+{
+	switch (pointerInfo.pointerType)
+	{
+	case PT_TOUCH:
+	{
+		POINTER_TOUCH_INFO* touchInfos = _scratch.get<POINTER_TOUCH_INFO>(entries);
+		if (!touchInfos || !GetPointerTouchInfoHistory || !GetPointerTouchInfoHistory(pointerId, &entries, touchInfos)) return false;
+		emitFrames(touchInfos, entries, 1);
+		break;
+	}
+	case PT_PEN:
+	{
+		POINTER_PEN_INFO* penInfos = _scratch.get<POINTER_PEN_INFO>(entries);
+		if (!penInfos || !GetPointerPenInfoHistory || !GetPointerPenInfoHistory(pointerId, &entries, penInfos)) return false;
+		emitFrames(penInfos, entries, 1);
+		break;
+	}
+	default:
+		POINTER_INFO* pointerInfos = _scratch.get<POINTER_INFO>(entries);
+		if (!pointerInfos || !GetPointerInfoHistory || !GetPointerInfoHistory(pointerId, &entries, pointerInfos)) return false;
+		for (int i = entries - 1; i >= 0; i--)
+		{
+			POINTER_INFO& info = pointerInfos[i];
+			PointerData data {};
+			data.pointerFlags = info.pointerFlags;
+			data.changedButtons = info.ButtonChangeType;
+			emitPointer(info.pointerId, WM_POINTERUPDATE, info.pointerType, screenPosition(info.ptPixelLocation), data, info.PerformanceCount);
+		}
+		break;
+	}
+
+	flushBatch();
+	return true;
+}
+
+// Sends [entries] rows of [count] contacts, rows are stored most recent first.
+template <typename T>
+void emitFrames(T* infos, UINT32 entries, UINT32 count)
+{
+	for (int entry = entries - 1; entry >= 0; entry--)
+	{
+		T* row = infos + entry * count;
+		for (UINT32 i = 0; i < count; i++)
+		{
+			PointerData data {};
+			data.pointerFlags = row[i].pointerInfo.pointerFlags;
+			data.changedButtons = row[i].pointerInfo.ButtonChangeType;
+			fillPointerData(data, row[i]);
+			emitFramePointer(row[i].pointerInfo, data);
+		}
+	}
+}
+
+// Frame data has no message attached, so the events which separate messages would carry are restored from the flags.
+void emitFramePointer(const POINTER_INFO& pointerInfo, const PointerData& data)
+{
+	int id = pointerInfo.pointerId;
+	POINTER_FLAGS flags = pointerInfo.pointerFlags;
+	POINTER_INPUT_TYPE type = pointerInfo.pointerType;
+	UINT64 timestamp = pointerInfo.PerformanceCount;
+	Vector2 position = screenPosition(pointerInfo.ptPixelLocation);
+
+	if ((flags & POINTER_FLAG_CANCELED) != 0)
+	{
+		emitPointer(id, POINTER_CANCELLED, type, position, data, timestamp);
+		return;
+	}
+
+	if ((flags & POINTER_FLAG_NEW) != 0) emitPointer(id, WM_POINTERENTER, type, position, data, timestamp);
+
+	if ((flags & POINTER_FLAG_DOWN) != 0) emitPointer(id, WM_POINTERDOWN, type, position, data, timestamp);
+	else if ((flags & POINTER_FLAG_UP) != 0) emitPointer(id, WM_POINTERUP, type, position, data, timestamp);
+	else emitPointer(id, WM_POINTERUPDATE, type, position, data, timestamp);
+
+	if ((flags & POINTER_FLAG_INRANGE) == 0) emitPointer(id, WM_POINTERLEAVE, type, position, data, timestamp);
+}
+
+// Events are collected in screen pixels and moved to TouchScript coordinates by transformBatch().
+Vector2 screenPosition(POINT p)
+{
+	return Vector2((float)p.x, (float)p.y);
+}
+
+void updateClientOrigin(InputContext& context)
+{
+	POINT origin = {0, 0};
+	ClientToScreen(context.window, &origin);
+	AcquireSRWLockExclusive(&context.lock);
+	context.clientOrigin = origin;
+	updateTransform(context);
+	ReleaseSRWLockExclusive(&context.lock);
+}
+
+// Folds client origin, offset, scale and Y flip into one transform:
+// x = (screenX - originX - offsetX) * scaleX
+// y = screenHeight - (screenY - originY - offsetY) * scaleY
+// Must be called with context.lock held.
+void updateTransform(InputContext& context)
+{
+	ScreenTransform transform;
+	transform.scaleX = context.scaleX;
+	transform.scaleY = -context.scaleY;
+	transform.translateX = -((float)context.clientOrigin.x + context.offsetX) * context.scaleX;
+	transform.translateY = (float)context.screenHeight + ((float)context.clientOrigin.y + context.offsetY) * context.scaleY;
+	context.transform.write(transform);
+}
+
+void fillPointerData(PointerData& data, const POINTER_TOUCH_INFO& touchInfo)
+{
+	data.flags = touchInfo.touchFlags;
+	data.mask = touchInfo.touchMask;
+	data.rotation = touchInfo.orientation;
+	data.pressure = touchInfo.pressure;
+
+	UINT32 area = 0;
+	if ((touchInfo.touchMask & TOUCH_MASK_CONTACTAREA) != 0)
+		area = (touchInfo.rcContact.right - touchInfo.rcContact.left) * (touchInfo.rcContact.bottom - touchInfo.rcContact.top);
+	if (isPalmContact(area, touchInfo.pointerInfo.pointerFlags)) data.flags |= TOUCH_FLAG_PALM;
+}
+
+void fillPointerData(PointerData& data, const POINTER_PEN_INFO& penInfo)
+{
+	data.flags = penInfo.penFlags;
+	data.mask = penInfo.penMask;
+	data.rotation = penInfo.rotation;
+	data.pressure = penInfo.pressure;
+	data.tiltX = penInfo.tiltX;
+	data.tiltY = penInfo.tiltY;
+}
+
+// Returns false if the message was dropped before decoding started.
+bool decodeWin7Touches(UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	UINT cInputs = LOWORD(wParam);
+	PTOUCHINPUT pInputs = _scratch.get<TOUCHINPUT>(cInputs);
+
+	if (!pInputs || !GetTouchInputInfo((HTOUCHINPUT)lParam, cInputs, pInputs, sizeof(TOUCHINPUT)))
+	{
+		log(LOG_WARNING, L"GetTouchInputInfo failed for %u inputs, error %u.", cInputs, GetLastError());
+		CloseTouchInputHandle((HTOUCHINPUT)lParam);
+		return false;
+	}
+	_traceFrameId++;
+	_context->stats.countFrame(cInputs);
+	TRACE_MESSAGE(msg, cInputs > 0 ? pInputs[0].dwID : 0, _traceFrameId, _messageTime);
+	TRACE_DECODE_START(_traceFrameId);
+
+	for (UINT i = 0; i < cInputs; i++)
+	{
+		TOUCHINPUT& touch = pInputs[i];
+		_currentDevice = deviceIndex(touch.hSource);
+
+		POINT p;
+		p.x = touch.x / 100;
+		p.y = touch.y / 100;
+
+		Vector2 position = screenPosition(p);
+		PointerData data {};
+
+		// WM_TOUCH has no confidence flag, only the contact area can be checked.
+		if ((touch.dwMask & TOUCHINPUTMASKF_CONTACTAREA) != 0
+			&& isPalmContact((touch.cxContact / 100) * (touch.cyContact / 100), POINTER_FLAG_CONFIDENCE)) data.flags |= TOUCH_FLAG_PALM;
+
+		if ((touch.dwFlags & TOUCHEVENTF_DOWN) != 0)
+		{
+			msg = WM_POINTERDOWN;
+			data.changedButtons = POINTER_CHANGE_FIRSTBUTTON_DOWN;
+		}
+		else if ((touch.dwFlags & TOUCHEVENTF_UP) != 0)
+		{
+			msg = WM_POINTERLEAVE;
+			data.changedButtons = POINTER_CHANGE_FIRSTBUTTON_UP;
+		}
+		else if ((touch.dwFlags & TOUCHEVENTF_MOVE) != 0)
+		{
+			msg = WM_POINTERUPDATE;
+		}
+
+		emitPointer(touch.dwID, msg, PT_TOUCH, position, data, 0);
+	}
+
+	CloseTouchInputHandle((HTOUCHINPUT)lParam);
+	flushBatch();
+	return true;
+}
+
+// Registers the window for touch screen reports or removes the registration.
+bool registerRawInput(bool add)
+{
+	RAWINPUTDEVICE device;
+	device.usUsagePage = HID_DIGITIZER_PAGE;
+	device.usUsage = HID_DIGITIZER_TOUCH_SCREEN;
+	device.dwFlags = add ? 0 : RIDEV_REMOVE;
+	device.hwndTarget = add ? _contexts[DEFAULT_CONTEXT].window : NULL;
+	return RegisterRawInputDevices(&device, 1, sizeof(RAWINPUTDEVICE)) != FALSE;
+}
+
+// Registers the window for mouse reports when nobody else did, they only tell which mouse moved.
+void registerRawMice(bool add)
+{
+	if (add == _mouseInPointer) return;
+	_mouseInPointer = add;
+	_mouseDevice = NULL;
+
+	RAWINPUTDEVICE device;
+	device.usUsagePage = HID_GENERIC_DESKTOP_PAGE;
+	device.usUsage = HID_GENERIC_MOUSE;
+	if (add)
+	{
+		RAWINPUTDEVICE devices[8];
+		UINT count = 8;
+		count = GetRegisteredRawInputDevices(devices, &count, sizeof(RAWINPUTDEVICE));
+		for (UINT i = 0; count != (UINT)-1 && i < count; i++)
+		{
+			if (devices[i].usUsagePage == HID_GENERIC_DESKTOP_PAGE && devices[i].usUsage == HID_GENERIC_MOUSE) return;
+		}
+
+		device.dwFlags = 0;
+		device.hwndTarget = _contexts[DEFAULT_CONTEXT].window;
+		_ownsRawMice = RegisterRawInputDevices(&device, 1, sizeof(RAWINPUTDEVICE)) != FALSE;
+		if (!_ownsRawMice) log(LOG_WARNING, L"RegisterRawInputDevices failed for mice, error %u. All mice have one device index.", GetLastError());
+	}
+	else if (_ownsRawMice)
+	{
+		device.dwFlags = RIDEV_REMOVE;
+		device.hwndTarget = NULL;
+		RegisterRawInputDevices(&device, 1, sizeof(RAWINPUTDEVICE));
+		_ownsRawMice = false;
+	}
+}
+
+// Remembers the mouse which sent this raw input, Windows sends the pointer message it causes after it.
+// Only the header is read, the data stays for Unity.
+void trackMouseDevice(HRAWINPUT handle)
+{
+	RAWINPUTHEADER header;
+	UINT size = sizeof(RAWINPUTHEADER);
+	if (GetRawInputData(handle, RID_HEADER, &header, &size, sizeof(RAWINPUTHEADER)) == (UINT)-1) return;
+	// Injected input has no device.
+	if (header.dwType == RIM_TYPEMOUSE && header.hDevice) _mouseDevice = header.hDevice;
+}
+
+// GetRawInputBuffer takes all raw input of the thread, it can only be used if nobody else, like Unity, registered for raw input.
+bool ownsRawInputBuffer()
+{
+	RAWINPUTDEVICE devices[4];
+	UINT count = 4;
+	count = GetRegisteredRawInputDevices(devices, &count, sizeof(RAWINPUTDEVICE));
+	if (count == (UINT)-1) return false;
+	for (UINT i = 0; i < count; i++)
+	{
+		if (devices[i].usUsagePage != HID_DIGITIZER_PAGE) return false;
+	}
+	return true;
+}
+
+void decodeRawInput(HRAWINPUT handle)
+{
+	UINT size = 0;
+	if (GetRawInputData(handle, RID_INPUT, NULL, &size, sizeof(RAWINPUTHEADER)) != 0 || size == 0) return;
+
+	// The data is gone if GetRawInputBuffer already read it.
+	RAWINPUT* input = (RAWINPUT*)_scratch.get<BYTE>(size);
+	if (!input || GetRawInputData(handle, RID_INPUT, input, &size, sizeof(RAWINPUTHEADER)) == (UINT)-1) return;
+	if (input->header.dwType == RIM_TYPEHID) decodeHidReports(input->header.hDevice, input->data.hid);
+}
+
+// Reads all queued raw input, RAW_INPUT_BATCH blocks at a time.
+void decodeRawInputBuffer()
+{
+	for (;;)
+	{
+		UINT size = 0;
+		if (GetRawInputBuffer(NULL, &size, sizeof(RAWINPUTHEADER)) != 0 || size == 0) return;
+
+		size *= RAW_INPUT_BATCH;
+		RAWINPUT* buffer = (RAWINPUT*)_scratch.get<BYTE>(size);
+		if (!buffer) return;
+		UINT count = GetRawInputBuffer(buffer, &size, sizeof(RAWINPUTHEADER));
+		if (count == 0 || count == (UINT)-1) return;
+
+		RAWINPUT* block = buffer;
+		for (UINT i = 0; i < count; i++)
+		{
+			if (block->header.dwType == RIM_TYPEHID)
+				decodeHidReports(block->header.hDevice, *(RAWHID*)((BYTE*)&block->data + _rawHeaderPadding));
+			block = NEXTRAWINPUTBLOCK(block);
+		}
+	}
+}
+
+void decodeHidReports(HANDLE device, const RAWHID& hid)
+{
+	_currentDevice = deviceIndex(device);
+	HidDigitizer& digitizer = _digitizers[_currentDevice];
+	if (digitizer.device() != device)
+	{
+		// Devices beyond MAX_DEVICES share the last index, only the first of them is read.
+		if (digitizer.device() != NULL) return;
+		if (!digitizer.load(device))
+		{
+			log(LOG_WARNING, L"Raw input device %p is not a multitouch digitizer.", device);
+			return;
+		}
+
+		digitizer.setScreenRect(_deviceInfos[_currentDevice].displayRect);
+	}
+	if (!digitizer.isLoaded()) return;
+
+	HidContact contacts[MAX_HID_COLLECTIONS];
+	BYTE* report = (BYTE*)hid.bRawData;
+	for (DWORD i = 0; i < hid.dwCount; i++, report += hid.dwSizeHid)
+	{
+		bool frameEnd;
+		UINT32 count = digitizer.decode(report, hid.dwSizeHid, _messageTime, contacts, MAX_HID_COLLECTIONS, frameEnd);
+		UINT64 timestamp = digitizer.timestamp();
+		for (UINT32 j = 0; j < count; j++) emitHidContact(digitizer, contacts[j], timestamp);
+		if (!frameEnd) continue;
+
+		// In hybrid mode a frame spans several reports, it is counted once when its last report arrives.
+		_context->stats.countFrame(digitizer.frameContacts());
+
+		// Some devices stop reporting a lifted contact instead of sending it once more without the tip switch.
+		HidTrackedContact* stale;
+		while ((stale = digitizer.findStale()) != NULL)
+		{
+			PointerData data {};
+			data.changedButtons = POINTER_CHANGE_FIRSTBUTTON_UP;
+			int id = hidPointerId(stale->id);
+			Vector2 position(stale->x, stale->y);
+			digitizer.untrack(stale);
+			emitPointer(id, WM_POINTERLEAVE, PT_TOUCH, position, data, timestamp);
+		}
+	}
+}
+
+void emitHidContact(HidDigitizer& digitizer, const HidContact& contact, UINT64 timestamp)
+{
+	bool added;
+	HidTrackedContact* tracked = digitizer.track(contact.id, contact.tip, added);
+	// Lifted contacts are reported with the tip switch off until their collection is reused.
+	if (!tracked) return;
+
+	const RECT& rect = digitizer.screenRect();
+	float width = (float)(rect.right - rect.left);
+	float height = (float)(rect.bottom - rect.top);
+	tracked->x = rect.left + contact.x * width;
+	tracked->y = rect.top + contact.y * height;
+
+	PointerData data {};
+	data.pressure = contact.pressure;
+	if (contact.pressure > 0) data.mask |= TOUCH_MASK_PRESSURE;
+	UINT32 area = 0;
+	if (contact.width > 0 && contact.height > 0)
+	{
+		data.mask |= TOUCH_MASK_CONTACTAREA;
+		area = (UINT32)(contact.width * width * contact.height * height);
+	}
+	if (isPalmContact(area, contact.confident ? POINTER_FLAG_CONFIDENCE : POINTER_FLAG_NONE)) data.flags |= TOUCH_FLAG_PALM;
+
+	UINT32 event = WM_POINTERUPDATE;
+	if (!contact.tip)
+	{
+		event = WM_POINTERLEAVE;
+		data.changedButtons = POINTER_CHANGE_FIRSTBUTTON_UP;
+	}
+	else if (added)
+	{
+		event = WM_POINTERDOWN;
+		data.changedButtons = POINTER_CHANGE_FIRSTBUTTON_DOWN;
+	}
+
+	Vector2 position(tracked->x, tracked->y);
+	if (!contact.tip) digitizer.untrack(tracked);
+	emitPointer(hidPointerId(contact.id), event, PT_TOUCH, position, data, timestamp);
+}
+
+// Contact ids are only unique per device.
+int hidPointerId(ULONG contactId)
+{
+	return (int)((_currentDevice << 16) | (contactId & 0xFFFF));
+}
+
+void emitPointer(int id, UINT32 event, POINTER_INPUT_TYPE type, Vector2 position, const PointerData& data, UINT64 timestamp)
+{
+	// A replay owns the pipeline until it is stopped.
+	if (_replayRecords) return;
+	// The delivery thread owns _batch while it runs.
+	bool delivering = _delivering.load(std::memory_order_relaxed);
+	if (!delivering && _batchSize == MAX_BATCH_SIZE) flushBatch();
+
+	EventRecord queued;
+	EventRecord& record = delivering ? queued : _batch[_batchSize];
+	record.id = id;
+	record.event = event;
+	record.type = type;
+	record.position = position;
+	record.data = data;
+	record.device = _currentDevice;
+	// Not all devices report PerformanceCount, WM_TOUCH doesn't have it at all.
+	record.timestamp = timestamp != 0 ? timestamp : _messageTime;
+	record.received = _messageTime;
+
+	if (delivering) queueEvent(record);
+	else if (processEvent(record)) _batchSize++;
+}
+
+// Filters the event and assigns its slot, returns false if the event was dropped.
+// Runs on the window thread, or on the delivery thread while it is active.
+bool processEvent(EventRecord& record)
+{
+	if (!filterPointer(record))
+	{
+		_context->stats.countSuppressed();
+		return false;
+	}
+
+	// The slot of an ending pointer is sent one last time and can be taken by the next new pointer.
+	if (record.event == WM_POINTERLEAVE || record.event == POINTER_CANCELLED)
+	{
+		record.slot = _context->slots.find(record.id);
+		_context->slots.release(record.slot);
+	}
+	else record.slot = _context->slots.acquire(record.id);
+
+	if (record.type == PT_TOUCH && _context == &_contexts[DEFAULT_CONTEXT]
+		&& (_options.load(std::memory_order_relaxed) & OPTION_CONTACT_AGGREGATES) != 0)
+	{
+		AcquireSRWLockExclusive(&_trackingLock);
+		if (record.event == WM_POINTERLEAVE || record.event == POINTER_CANCELLED) _contactSet.remove(record.slot);
+		else _contactSet.update(record.slot, record.device, record.position.x, record.position.y);
+		ReleaseSRWLockExclusive(&_trackingLock);
+	}
+
+	_context->stats.countEvent(record.type);
+	return true;
+}
+
+// All the window proc does with an event while the delivery thread is active, flushBatch() commits queued events.
+void queueEvent(const EventRecord& record)
+{
+	QueuedEvent queued;
+	queued.record = record;
+	queued.context = (UINT32)(_context - _contexts);
+	if (!_inputQueue.push(queued))
+	{
+		_context->stats.countDropped(1);
+		_queueDropped++;
+	}
+}
+
+// Devices beyond MAX_DEVICES share the last index.
+UINT32 deviceIndex(HANDLE device)
+{
+	for (UINT32 i = 0; i < _deviceCount; i++)
+	{
+		if (_devices[i] == device) return i;
+	}
+	if (_deviceCount == MAX_DEVICES) return MAX_DEVICES - 1;
+	_devices[_deviceCount] = device;
+	describeDevice(device, _deviceInfos[_deviceCount]);
+	_deviceInfos[_deviceCount].index = _deviceCount;
+	return _deviceCount++;
+}
+
+// Queries a new device once. Without Windows 8 pointer device functions a device is assumed to cover the monitor of the window.
+void describeDevice(HANDLE device, DeviceInfo& info)
+{
+	info.type = POINTER_DEVICE_TYPE_UNKNOWN;
+	info.maxContacts = 0;
+
+	HMONITOR monitor = NULL;
+	POINTER_DEVICE_INFO pointerDevice;
+	if (GetPointerDevice && GetPointerDevice(device, &pointerDevice))
+	{
+		info.type = pointerDevice.pointerDeviceType;
+		info.maxContacts = pointerDevice.maxActiveContacts;
+		monitor = pointerDevice.monitor;
+	}
+	else
+	{
+		RID_DEVICE_INFO rawDevice;
+		rawDevice.cbSize = sizeof(RID_DEVICE_INFO);
+		UINT size = sizeof(RID_DEVICE_INFO);
+		if (GetRawInputDeviceInfo(device, RIDI_DEVICEINFO, &rawDevice, &size) != (UINT)-1 && rawDevice.dwType == RIM_TYPEMOUSE)
+			info.type = POINTER_DEVICE_TYPE_MOUSE;
+	}
+	if (!monitor) monitor = MonitorFromWindow(_context->window, MONITOR_DEFAULTTOPRIMARY);
+
+	MONITORINFO monitorInfo;
+	monitorInfo.cbSize = sizeof(MONITORINFO);
+	if (!GetMonitorInfo(monitor, &monitorInfo)) SetRectEmpty(&monitorInfo.rcMonitor);
+	info.monitorRect = monitorInfo.rcMonitor;
+
+	RECT pointerRect;
+	if (!GetPointerDeviceRects || !GetPointerDeviceRects(device, &pointerRect, &info.displayRect)) info.displayRect = info.monitorRect;
+
+	MonitorSearch search = {monitor, 0, -1};
+	EnumDisplayMonitors(NULL, NULL, findMonitorProc, (LPARAM)&search);
+	info.monitor = search.found;
+}
+
+BOOL CALLBACK findMonitorProc(HMONITOR monitor, HDC hdc, LPRECT rect, LPARAM lParam)
+{
+	MonitorSearch* search = (MonitorSearch*)lParam;
+	if (monitor == search->monitor)
+	{
+		search->found = search->index;
+		return FALSE;
+	}
+	search->index++;
+	return TRUE;
+}
+
+// Checks a touch against palm rejection settings, area is in pixels or 0 if unknown.
+bool isPalmContact(UINT32 area, POINTER_FLAGS pointerFlags)
+{
+	if ((_options.load(std::memory_order_relaxed) & (OPTION_PALM_REJECT | OPTION_PALM_TAG)) == 0) return false;
+	AcquireSRWLockShared(&_trackingLock);
+	UINT32 maxContactArea = _filterParams.maxContactArea;
+	bool requireConfidence = _filterParams.requireConfidence;
+	ReleaseSRWLockShared(&_trackingLock);
+	if (maxContactArea > 0 && area > maxContactArea) return true;
+	if (requireConfidence && (pointerFlags & POINTER_FLAG_CONFIDENCE) == 0) return true;
+	return false;
+}
+
+// Applies stationary and palm filters to a batched event before it is sent.
+// Returns false if the event must be dropped, may turn the event into a cancel.
+bool filterPointer(EventRecord& record)
+{
+	UINT32 options = _options.load(std::memory_order_relaxed);
+	bool palms = record.type == PT_TOUCH && (options & (OPTION_PALM_REJECT | OPTION_PALM_TAG)) != 0;
+	bool stationary = (options & OPTION_STATIONARY_FILTER) != 0;
+	bool jitter = (options & OPTION_JITTER_FILTER) != 0;
+	if (!palms && !stationary && !jitter) return true;
+
+	bool ends = record.event == WM_POINTERLEAVE || record.event == POINTER_CANCELLED;
+	PointerFilter& filter = _context->filter;
+	FilterState* state = ends ? filter.find(record.id) : filter.get(record.id);
+	// Pointers which don't fit are not filtered.
+	if (!state) return true;
+
+	// Setters may run on another thread, work with a consistent copy.
+	AcquireSRWLockShared(&_trackingLock);
+	FilterParams params = _filterParams;
+	OneEuroFilter jitterFilter = _jitterFilter;
+	ReleaseSRWLockShared(&_trackingLock);
 
-		_currentWindow = FindWindowA("UnityWndClass", NULL);
-		if (api == WIN8)
+	if (palms)
+	{
+		// A contact stays a palm until it is lifted even if it gets smaller.
+		if ((record.data.flags & TOUCH_FLAG_PALM) != 0) state->palm = true;
+		if (state->palm)
 		{
-			HINSTANCE h = LoadLibrary(TEXT("user32.dll"));
-			GetPointerInfo = (GET_POINTER_INFO) GetProcAddress(h, "GetPointerInfo");
-			GetPointerTouchInfo = (GET_POINTER_TOUCH_INFO) GetProcAddress(h, "GetPointerTouchInfo");
-			GetPointerPenInfo = (GET_POINTER_PEN_INFO)GetProcAddress(h, "GetPointerPenInfo");
+			if ((options & OPTION_PALM_REJECT) != 0)
+			{
+				bool delivered = state->delivered;
+				state->delivered = false;
+				if (ends) filter.remove(state);
+				if (!delivered) return false;
+				record.event = POINTER_CANCELLED;
+				return true;
+			}
+			record.data.flags |= TOUCH_FLAG_PALM;
+		}
+	}
+
+	if (jitter) jitterFilter.apply(state->jitter, record.timestamp, record.position.x, record.position.y);
+
+	// Only buttons and contact state matter, Windows sets the rest on every update.
+	const UINT32 stateFlags = POINTER_FLAG_INRANGE | POINTER_FLAG_INCONTACT | POINTER_FLAG_FIRSTBUTTON | POINTER_FLAG_SECONDBUTTON
+		| POINTER_FLAG_THIRDBUTTON | POINTER_FLAG_FOURTHBUTTON | POINTER_FLAG_FIFTHBUTTON;
+	if (stationary && state->delivered && isPlainUpdate(record)
+		&& fabsf(record.position.x - state->x) <= params.positionEpsilon
+		&& fabsf(record.position.y - state->y) <= params.positionEpsilon
+		&& (UINT32)abs((int)(record.data.pressure - state->pressure)) <= params.pressureEpsilon
+		&& (UINT32)abs((int)(record.data.rotation - state->rotation)) <= params.rotationEpsilon
+		&& (record.data.pointerFlags & stateFlags) == (state->pointerFlags & stateFlags)) return false;
+
+	if (ends)
+	{
+		filter.remove(state);
+		return true;
+	}
+
+	state->x = record.position.x;
+	state->y = record.position.y;
+	state->pressure = record.data.pressure;
+	state->rotation = record.data.rotation;
+	state->pointerFlags = record.data.pointerFlags;
+	state->delivered = true;
+	return true;
+}
+
+// Moves positions of all batched events from screen pixels to TouchScript coordinates, two events at a time.
+void transformBatch()
+{
+	const ScreenTransform transform = _context->transform.read();
+	const __m128 scale = _mm_setr_ps(transform.scaleX, transform.scaleY, transform.scaleX, transform.scaleY);
+	const __m128 translate = _mm_setr_ps(transform.translateX, transform.translateY, transform.translateX, transform.translateY);
+
+	UINT32 i = 0;
+	for (; i + 1 < _batchSize; i += 2)
+	{
+		__m64* a = (__m64*)&_batch[i].position;
+		__m64* b = (__m64*)&_batch[i + 1].position;
+		__m128 p = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), a), b);
+		p = _mm_add_ps(_mm_mul_ps(p, scale), translate);
+		_mm_storel_pi(a, p);
+		_mm_storeh_pi(b, p);
+	}
+	if (i < _batchSize)
+	{
+		Vector2& position = _batch[i].position;
+		position.x = position.x * transform.scaleX + transform.translateX;
+		position.y = position.y * transform.scaleY + transform.translateY;
+	}
+}
+
+// Delivers all events decoded from the current message either directly through the delegate
+// or by publishing them to the event buffer in one commit for managed code to drain later.
+// While the delivery thread is active it only hands the queued events over to it.
+void flushBatch()
+{
+	if (_delivering.load(std::memory_order_relaxed))
+	{
+		_inputQueue.commit();
+		SetEvent(_deliveryWake);
+		if (_queueDropped > 0) log(LOG_WARNING, L"Delivery queue is full, dropped %u events.", _queueDropped);
+		_queueDropped = 0;
+		return;
+	}
+	publishBatch();
+}
+
+// Transforms, records and delivers the events in _batch.
+void publishBatch()
+{
+	if (_batchSize == 0) return;
+
+	transformBatch();
+	if (_capturing.load(std::memory_order_relaxed))
+	{
+		for (UINT32 i = 0; i < _batchSize; i++) _captureBuffer.push(packEvent(_batch[i]));
+		_captureBuffer.commit();
+		if (_captureBuffer.size() > CAPTURE_BUFFER_CAPACITY / 2) SetEvent(_captureWake);
+	}
+	deliverBatch();
+}
+
+// Sends transformed events from _batch to managed code.
+void deliverBatch()
+{
+	if (_batchSize == 0) return;
+	TRACE_BATCH(_traceFrameId, _batchSize);
+	// Slots of other contexts would collide with the ones of the default context.
+	bool tracked = _context == &_contexts[DEFAULT_CONTEXT];
+	if (tracked && _predicting)
+	{
+		AcquireSRWLockExclusive(&_trackingLock);
+		updatePredictor();
+		ReleaseSRWLockExclusive(&_trackingLock);
+	}
+
+	bool table = tracked && (_options.load(std::memory_order_relaxed) & OPTION_POINTER_TABLE) != 0;
+	if (table) _pointerTable.beginWrite();
 
-			_oldWindowProc = SetWindowLongPtr(_currentWindow, GWLP_WNDPROC, (LONG_PTR)wndProc8);
-			log(L"Initialized WIN8 input.");
+	InputContext& context = *_context;
+	if (context.deliveryMode.load(std::memory_order_acquire) == DELIVERY_BUFFERED)
+	{
+		UINT32 dropped = 0;
+		for (UINT32 i = 0; i < _batchSize; i++)
+		{
+			// Managed code reads plain updates from the table.
+			if (table && writePointerTable(_batch[i])) continue;
+			if (!context.eventBuffer.push(packEvent(_batch[i]))) dropped++;
 		}
-		else
+		if (dropped > 0)
+		{
+			context.stats.countDropped(dropped);
+			log(LOG_WARNING, L"Event buffer is full, dropped %u events.", dropped);
+		}
+		if (table) _pointerTable.endWrite();
+		context.eventBuffer.commit();
+		context.stats.updateRingSize(context.eventBuffer.size());
+	}
+	else
+	{
+		for (UINT32 i = 0; i < _batchSize; i++)
+		{
+			EventRecord& record = _batch[i];
+			if (table) writePointerTable(record);
+			TRACE_DELEGATE_START(_traceFrameId, record.id, record.event);
+			context.delegate(record.id, record.slot, record.device, record.event, record.type, record.position, record.data, record.received);
+			TRACE_DELEGATE_STOP(_traceFrameId);
+		}
+		if (table) _pointerTable.endWrite();
+	}
+	_batchSize = 0;
+}
+
+// Feeds transformed events from _batch to the predictor.
+void updatePredictor()
+{
+	for (UINT32 i = 0; i < _batchSize; i++)
+	{
+		const EventRecord& record = _batch[i];
+		if (record.event == WM_POINTERLEAVE || record.event == POINTER_CANCELLED)
 		{
-			RegisterTouchWindow(_currentWindow, 0);
-			_oldWindowProc = SetWindowLongPtr(_currentWindow, GWLP_WNDPROC, (LONG_PTR)wndProc7);
-			log(L"Initialized WIN7 input.");
+			_predictor.remove(record.slot);
+			continue;
 		}
+
+		PREDICTION_MODE mode = (UINT32)record.type < STATS_POINTER_TYPES ? _predictionModes[record.type] : PREDICT_NONE;
+		if (mode == PREDICT_NONE) _predictor.remove(record.slot);
+		else _predictor.update(record.slot, record.id, record.type, record.device, mode, record.timestamp, record.position.x, record.position.y);
+	}
+}
+
+// Applies the event to the pointer table, must be called between beginWrite() and endWrite().
+// Returns true if the event is a plain update which is fully described by the table row.
+bool writePointerTable(const EventRecord& record)
+{
+	int index = _pointerTable.find(record.id);
+	if (record.event == WM_POINTERLEAVE || record.event == POINTER_CANCELLED)
+	{
+		if (index >= 0) _pointerTable.remove(index);
+		return false;
 	}
 
-	void __stdcall Dispose()
+	// If the table is full the pointer is only tracked through events.
+	if (index < 0) index = _pointerTable.add(record.id);
+	if (index < 0) return false;
+
+	_pointerTable.timestamp[index] = record.timestamp;
+	_pointerTable.type[index] = record.type;
+	_pointerTable.updated[index] = _pointerTable.writeSequence();
+	_pointerTable.pointerFlags[index] = record.data.pointerFlags;
+	_pointerTable.mask[index] = record.data.mask;
+	_pointerTable.pressure[index] = record.data.pressure;
+	_pointerTable.rotation[index] = record.data.rotation;
+	_pointerTable.x[index] = record.position.x;
+	_pointerTable.y[index] = record.position.y;
+	_pointerTable.slot[index] = record.slot;
+	_pointerTable.device[index] = record.device;
+
+	return isPlainUpdate(record);
+}
+
+// An update which only changes position and pointer data, it is safe to replace it with a later one.
+bool isPlainUpdate(const EventRecord& record)
+{
+	return record.event == WM_POINTERUPDATE && record.data.changedButtons == POINTER_CHANGE_NONE;
+}
+
+bool isPlainUpdate(const PackedEvent& event)
+{
+	return event.event == WM_POINTERUPDATE && event.changedButtons == POINTER_CHANGE_NONE;
+}
+
+// Consumer. Drains the event buffer into buffer replacing each pointer's pending update with the next one
+// until a transition of this pointer comes in. Keeps popping while merging frees up space.
+UINT32 popCoalesced(InputContext& context, PackedEvent* buffer, UINT32 capacity, UINT32 available, bool keepHistory)
+{
+	UINT32 count = 0;
+	_coalesceCount = 0;
+
+	for (;;)
 	{
-		if (_oldWindowProc)
+		UINT32 space = capacity - count < available ? capacity - count : available;
+		UINT32 end = count + context.eventBuffer.pop(buffer + count, space);
+		if (end == count) break;
+		available -= end - count;
+
+		for (UINT32 i = count; i < end; i++)
 		{
-			SetWindowLongPtr(_currentWindow, GWLP_WNDPROC, (LONG_PTR)_oldWindowProc);
-			_oldWindowProc = 0;
-			if (_api == WIN7)
+			int id = buffer[i].id;
+			UINT32 slot = 0;
+			while (slot < _coalesceCount && _coalesceIds[slot] != id) slot++;
+
+			if (isPlainUpdate(buffer[i]))
+			{
+				if (slot < _coalesceCount)
+				{
+					PackedEvent& pending = buffer[_coalesceIndices[slot]];
+					if (keepHistory && _coalescedCount < MAX_COALESCED_EVENTS) _coalescedEvents[_coalescedCount++] = pending;
+					context.stats.countCoalesced();
+					pending = buffer[i];
+					continue;
+				}
+				if (_coalesceCount < MAX_FRAME_POINTERS)
+				{
+					_coalesceIds[_coalesceCount] = id;
+					_coalesceIndices[_coalesceCount] = count;
+					_coalesceCount++;
+				}
+			}
+			else if (slot < _coalesceCount)
 			{
-				UnregisterTouchWindow(_currentWindow);
+				// Updates after a transition must stay after it.
+				_coalesceCount--;
+				_coalesceIds[slot] = _coalesceIds[_coalesceCount];
+				_coalesceIndices[slot] = _coalesceIndices[_coalesceCount];
 			}
+
+			if (i != count) buffer[count] = buffer[i];
+			count++;
 		}
+
+		if (count == capacity) break;
 	}
 
-	void __stdcall SetScreenParams(int width, int height, float offsetX, float offsetY, float scaleX, float scaleY)
+	return count;
+}
+
+DWORD WINAPI syntheticLoadThread(LPVOID param)
+{
+	const RECT area = _syntheticArea;
+	const UINT32 count = _syntheticContactCount;
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	const UINT64 period = frequency.QuadPart / _syntheticHz;
+
+	initSyntheticContacts(area);
+	UINT64 next = getTimestamp();
+	UINT32 frame = 0;
+	while (_syntheticRunning.load(std::memory_order_acquire))
+	{
+		for (UINT32 i = 0; i < count; i++)
+		{
+			SyntheticContact& contact = _syntheticContacts[i];
+			if (!contact.down)
+			{
+				// Swipes land again at the left edge after they were lifted.
+				if (frame > 0 && _syntheticPattern == SYNTHETIC_SWIPE_STORM) contact.x = (float)area.left;
+				fillSyntheticInfo(_syntheticInfos[i], i, (POINTER_FLAGS)(POINTER_FLAG_DOWN | POINTER_FLAG_INRANGE | POINTER_FLAG_INCONTACT));
+				contact.down = true;
+			}
+			else if (updateSyntheticContact(i, frame, area))
+			{
+				fillSyntheticInfo(_syntheticInfos[i], i, (POINTER_FLAGS)(POINTER_FLAG_UPDATE | POINTER_FLAG_INRANGE | POINTER_FLAG_INCONTACT));
+			}
+			else
+			{
+				fillSyntheticInfo(_syntheticInfos[i], i, POINTER_FLAG_UP);
+				contact.down = false;
+			}
+		}
+		// Fails when the window loses focus or the desktop is locked.
+		if (!InjectTouchInput(count, _syntheticInfos)) break;
+
+		frame++;
+		next += period;
+		UINT64 now = getTimestamp();
+		// Don't try to catch up with frames missed while the thread was preempted.
+		if (now > next + period) next = now;
+		waitUntil(next, frequency.QuadPart);
+	}
+
+	// Lift everything still on the screen, otherwise Windows keeps the contacts alive.
+	UINT32 lifted = 0;
+	for (UINT32 i = 0; i < count; i++)
 	{
-		_screenWidth = width;
-		_screenHeight = height;
-		_offsetX = offsetX;
-		_offsetY = offsetY;
-		_scaleX = scaleX;
-		_scaleY = scaleY;
+		if (!_syntheticContacts[i].down) continue;
+		fillSyntheticInfo(_syntheticInfos[lifted++], i, POINTER_FLAG_UP);
+		_syntheticContacts[i].down = false;
 	}
+	if (lifted > 0) InjectTouchInput(lifted, _syntheticInfos);
 
+	_syntheticRunning.store(false, std::memory_order_release);
+	return 0;
 }
 
-LRESULT CALLBACK wndProc8(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+void initSyntheticContacts(const RECT& area)
 {
-	switch (msg)
+	float width = (float)(area.right - area.left);
+	float height = (float)(area.bottom - area.top);
+	UINT32 count = _syntheticContactCount;
+
+	for (UINT32 i = 0; i < count; i++)
 	{
-	case WM_TOUCH:
-		CloseTouchInputHandle((HTOUCHINPUT)lParam);
+		SyntheticContact& contact = _syntheticContacts[i];
+		contact.down = false;
+		switch (_syntheticPattern)
+		{
+		case SYNTHETIC_SWIPE_STORM:
+			// Rows with staggered starting points, every swipe crosses the window in half a second.
+			contact.x = area.left + fmodf(i * .37f, 1) * (width - 1);
+			contact.y = area.top + (i + .5f) * height / count;
+			contact.dx = width * 2 / _syntheticHz;
+			contact.dy = 0;
+			break;
+		case SYNTHETIC_PINCH:
+			contact.dx = contact.dy = 0;
+			updateSyntheticContact(i, 0, area);
+			break;
+		default:
+			contact.x = area.left + (float)rand() / RAND_MAX * (width - 1);
+			contact.y = area.top + (float)rand() / RAND_MAX * (height - 1);
+			contact.dx = ((float)rand() / RAND_MAX - .5f) * 8;
+			contact.dy = ((float)rand() / RAND_MAX - .5f) * 8;
+			break;
+		}
+	}
+}
+
+// Moves a contact to its position in the given frame, returns false if the contact must be lifted.
+bool updateSyntheticContact(UINT32 index, UINT32 frame, const RECT& area)
+{
+	SyntheticContact& contact = _syntheticContacts[index];
+	float right = (float)(area.right - 1);
+	float bottom = (float)(area.bottom - 1);
+
+	switch (_syntheticPattern)
+	{
+	case SYNTHETIC_SWIPE_STORM:
+		if (contact.x + contact.dx > right) return false;
+		contact.x += contact.dx;
 		break;
-	case WM_POINTERENTER:
-	case WM_POINTERLEAVE:
-	case WM_POINTERDOWN:
-	case WM_POINTERUP:
-	case WM_POINTERUPDATE:
-	case WM_POINTERCAPTURECHANGED:
-		decodeWin8Touches(msg, wParam, lParam);
+	case SYNTHETIC_PINCH:
+	{
+		const float pi2 = 6.2831853f;
+		float time = (float)frame / _syntheticHz;
+		float centerX = (area.left + right) * .5f;
+		float centerY = (area.top + bottom) * .5f;
+		float size = (right - area.left < bottom - area.top ? right - area.left : bottom - area.top) * .5f;
+		// One pinch in and out every two seconds while slowly rotating.
+		float radius = size * (.45f + .4f * sinf(time * pi2 * .5f));
+		float angle = pi2 * index / _syntheticContactCount + time * .5f;
+		contact.x = centerX + cosf(angle) * radius;
+		contact.y = centerY + sinf(angle) * radius;
 		break;
+	}
 	default:
-		return CallWindowProc((WNDPROC)_oldWindowProc, hwnd, msg, wParam, lParam);
+		contact.dx += ((float)rand() / RAND_MAX - .5f);
+		contact.dy += ((float)rand() / RAND_MAX - .5f);
+		if (contact.dx > 8) contact.dx = 8;
+		else if (contact.dx < -8) contact.dx = -8;
+		if (contact.dy > 8) contact.dy = 8;
+		else if (contact.dy < -8) contact.dy = -8;
+		contact.x += contact.dx;
+		contact.y += contact.dy;
+		if (contact.x < area.left) { contact.x = (float)area.left; contact.dx = -contact.dx; }
+		else if (contact.x > right) { contact.x = right; contact.dx = -contact.dx; }
+		if (contact.y < area.top) { contact.y = (float)area.top; contact.dy = -contact.dy; }
+		else if (contact.y > bottom) { contact.y = bottom; contact.dy = -contact.dy; }
+		break;
+	}
+	return true;
+}
+
+void fillSyntheticInfo(POINTER_TOUCH_INFO& info, UINT32 index, POINTER_FLAGS flags)
+{
+	const SyntheticContact& contact = _syntheticContacts[index];
+	LONG x = (LONG)contact.x;
+	LONG y = (LONG)contact.y;
+
+	memset(&info, 0, sizeof(POINTER_TOUCH_INFO));
+	info.pointerInfo.pointerType = PT_TOUCH;
+	info.pointerInfo.pointerId = index;
+	info.pointerInfo.pointerFlags = flags;
+	info.pointerInfo.ptPixelLocation.x = x;
+	info.pointerInfo.ptPixelLocation.y = y;
+	info.touchFlags = TOUCH_FLAG_NONE;
+	info.touchMask = (TOUCH_MASK)(TOUCH_MASK_CONTACTAREA | TOUCH_MASK_ORIENTATION | TOUCH_MASK_PRESSURE);
+	info.rcContact.left = x - 2;
+	info.rcContact.right = x + 2;
+	info.rcContact.top = y - 2;
+	info.rcContact.bottom = y + 2;
+	info.orientation = 90;
+	info.pressure = 512;
+}
+
+// Sleep only has millisecond granularity, so the last part of the wait is spent yielding.
+void waitUntil(UINT64 time, UINT64 frequency)
+{
+	UINT64 now = getTimestamp();
+	while (now < time)
+	{
+		UINT64 remaining = (time - now) * 1000 / frequency;
+		Sleep(remaining > 2 ? 1 : 0);
+		now = getTimestamp();
+	}
+}
+
+// Publishes queued events until StopDeliveryThread(), then whatever is left in the queue.
+DWORD WINAPI deliveryThread(LPVOID param)
+{
+	QueuedEvent chunk[MAX_BATCH_SIZE];
+
+	for (;;)
+	{
+		bool running = _delivering.load(std::memory_order_acquire);
+		UINT32 count;
+		while ((count = _inputQueue.pop(chunk, MAX_BATCH_SIZE)) > 0) publishQueued(chunk, count);
+		if (!running) break;
+		WaitForSingleObject(_deliveryWake, INFINITE);
 	}
 	return 0;
 }
 
-LRESULT CALLBACK wndProc7(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+// Runs the queued events through the same pipeline the window proc uses, one batch per run of events of one context.
+void publishQueued(const QueuedEvent* events, UINT32 count)
 {
-	switch (msg)
+	for (UINT32 i = 0; i < count; i++)
 	{
-	case WM_TOUCH:
-		decodeWin7Touches(msg, wParam, lParam);
-		break;
-	default:
-		return CallWindowProc((WNDPROC)_oldWindowProc, hwnd, msg, wParam, lParam);
+		InputContext* context = &_contexts[events[i].context];
+		if (context != _context || _batchSize == MAX_BATCH_SIZE)
+		{
+			publishBatch();
+			_context = context;
+		}
+
+		EventRecord& record = _batch[_batchSize];
+		record = events[i].record;
+		if (processEvent(record)) _batchSize++;
+	}
+	publishBatch();
+}
+
+DWORD WINAPI captureThread(LPVOID param)
+{
+	PackedEvent chunk[MAX_BATCH_SIZE];
+	bool ok = true;
+
+	while (ok && _capturing.load(std::memory_order_acquire))
+	{
+		WaitForSingleObject(_captureWake, CAPTURE_FLUSH_INTERVAL);
+		ok = writeCapture(chunk, MAX_BATCH_SIZE);
 	}
+	// Events pushed before the capture was stopped.
+	if (ok) writeCapture(chunk, MAX_BATCH_SIZE);
 	return 0;
 }
 
-void decodeWin8Touches(UINT msg, WPARAM wParam, LPARAM lParam)
+// Appends everything in the capture buffer to the file.
+bool writeCapture(PackedEvent* chunk, UINT32 capacity)
 {
-	int pointerId = GET_POINTERID_WPARAM(wParam);
+	UINT32 count;
+	while ((count = _captureBuffer.pop(chunk, capacity)) > 0)
+	{
+		DWORD written;
+		if (!WriteFile(_captureFile, chunk, count * sizeof(PackedEvent), &written, NULL)) return false;
+	}
+	return true;
+}
 
-	POINTER_INFO pointerInfo;
-	if (!GetPointerInfo(pointerId, &pointerInfo)) return;
+// Sleeps in select() until datagrams arrive or the receiver is stopped.
+DWORD WINAPI tuioThread(LPVOID param)
+{
+	while (_tuioRunning.load(std::memory_order_acquire))
+	{
+		fd_set readable;
+		FD_ZERO(&readable);
+		FD_SET(_tuioSocket, &readable);
+		timeval timeout = {0, TUIO_POLL_INTERVAL * 1000};
+		int ready = select(0, &readable, NULL, NULL, &timeout);
+		if (ready == SOCKET_ERROR)
+		{
+			log(LOG_ERROR, L"TUIO receive failed, error %d.", WSAGetLastError());
+			break;
+		}
+		if (ready > 0) receiveTuio(getTimestamp());
+	}
+	return 0;
+}
 
-	POINT p;
-	p.x = pointerInfo.ptPixelLocation.x;
-	p.y = pointerInfo.ptPixelLocation.y;
-	ScreenToClient(_currentWindow, &p);
+// Decodes every datagram which is already waiting and publishes their events with one commit.
+void receiveTuio(UINT64 timestamp)
+{
+	for (;;)
+	{
+		int length = recv(_tuioSocket, _tuioPacket, TUIO_MAX_PACKET, 0);
+		if (length == SOCKET_ERROR)
+		{
+			int error = WSAGetLastError();
+			// Oversized datagrams are gone, ICMP errors of earlier sends don't matter to a receiver.
+			if (error == WSAEMSGSIZE || error == WSAECONNRESET) continue;
+			break;
+		}
 
-	Vector2 position = Vector2(((float)p.x - _offsetX) * _scaleX, _screenHeight - ((float)p.y - _offsetY) * _scaleY);
-	PointerData data {};
-	data.pointerFlags = pointerInfo.pointerFlags;
-	data.changedButtons = pointerInfo.ButtonChangeType;
+		UINT32 count = _tuioDecoder.decode(_tuioPacket, length, _tuioEvents, TUIO_MAX_EVENTS);
+		for (UINT32 i = 0; i < count; i++) pushTuioEvent(_tuioEvents[i], timestamp);
+	}
+	_tuioBuffer.commit();
+}
 
-	if ((pointerInfo.pointerFlags & POINTER_FLAG_CANCELED) != 0
-		|| msg == WM_POINTERCAPTURECHANGED) msg = POINTER_CANCELLED;
+void pushTuioEvent(const TuioEvent& event, UINT64 timestamp)
+{
+	EventRecord record;
+	record.id = event.id;
+	record.type = event.kind == TUIO_CURSOR ? PT_TOUCH : PT_POINTER;
+	record.position.x = event.x;
+	record.position.y = event.y;
+	record.device = 0;
+	record.timestamp = record.received = timestamp;
 
-	switch (pointerInfo.pointerType)
+	memset(&record.data, 0, sizeof(PointerData));
+	record.data.mask = event.kind;
+	record.data.flags = (UINT32)event.classId;
+	float degrees = event.angle * (180 / 3.14159265f);
+	degrees -= 360 * floorf(degrees / 360);
+	record.data.rotation = (UINT32)(degrees * TUIO_ANGLE_SCALE + .5f) % (360 * TUIO_ANGLE_SCALE);
+	record.data.tiltX = (INT32)(event.width * TUIO_SIZE_SCALE);
+	record.data.tiltY = (INT32)(event.height * TUIO_SIZE_SCALE);
+
+	switch (event.change)
 	{
-	case PT_MOUSE:
+	case TUIO_ADDED:
+		record.event = WM_POINTERDOWN;
+		record.slot = _tuioSlots.acquire(event.id);
 		break;
-	case PT_TOUCH:
-		POINTER_TOUCH_INFO touchInfo;
-		GetPointerTouchInfo(pointerId, &touchInfo);
-		data.flags = touchInfo.touchFlags;
-		data.mask = touchInfo.touchMask;
-		data.rotation = touchInfo.orientation;
-		data.pressure = touchInfo.pressure;
+	case TUIO_UPDATED:
+		record.event = WM_POINTERUPDATE;
+		record.slot = _tuioSlots.find(event.id);
 		break;
-	case PT_PEN:
-		POINTER_PEN_INFO penInfo;
-		GetPointerPenInfo(pointerId, &penInfo);
-		data.flags = penInfo.penFlags;
-		data.mask = penInfo.penMask;
-		data.rotation = penInfo.rotation;
-		data.pressure = penInfo.pressure;
-		data.tiltX = penInfo.tiltX;
-		data.tiltY = penInfo.tiltY;
+	default:
+		record.event = WM_POINTERUP;
+		record.slot = _tuioSlots.find(event.id);
+		if (record.slot >= 0) _tuioSlots.release(record.slot);
 		break;
 	}
+	_tuioBuffer.push(packEvent(record));
+}
 
-	_delegate(pointerId, msg, pointerInfo.pointerType, position, data);
+UINT64 getTimestamp()
+{
+	LARGE_INTEGER time;
+	QueryPerformanceCounter(&time);
+	return time.QuadPart;
 }
 
-void decodeWin7Touches(UINT msg, WPARAM wParam, LPARAM lParam)
+void log(LOG_LEVEL level, const wchar_t* format, ...)
 {
-	UINT cInputs = LOWORD(wParam);
-	PTOUCHINPUT pInputs = new TOUCHINPUT[cInputs];
+	if (!_logBuffer.isEnabled(level)) return;
 
-	if (!pInputs) return;
-	if (!GetTouchInputInfo((HTOUCHINPUT)lParam, cInputs, pInputs, sizeof(TOUCHINPUT))) return;
+	va_list args;
+	va_start(args, format);
+	_logBuffer.write(level, format, args);
+	va_end(args);
+}
 
-	for (UINT i = 0; i < cInputs; i++)
+void UNITY_INTERFACE_API onGraphicsDeviceEvent(UnityGfxDeviceEventType eventType)
+{
+	switch (eventType)
+	{
+	case kUnityGfxDeviceEventInitialize:
+		_unityRenderer = _unityGraphics->GetRenderer();
+		log(LOG_INFO, L"Graphics device %d initialized.", _unityRenderer);
+		break;
+	case kUnityGfxDeviceEventShutdown:
+		_unityRenderer = kUnityGfxRendererNull;
+		break;
+	default:
+		break;
+	}
+}
+
+// The main window of this process. FindWindow could return a window of another Unity application.
+HWND findUnityWindow()
+{
+	HWND result = NULL;
+	EnumWindows(findUnityWindowProc, (LPARAM)&result);
+	return result;
+}
+
+// Returns the context or NULL. The default context always exists, so its params can be set before Init().
+InputContext* getContext(int index)
+{
+	if (index < 0 || index >= MAX_CONTEXTS) return NULL;
+	if (index != DEFAULT_CONTEXT && !_contexts[index].window) return NULL;
+	return &_contexts[index];
+}
+
+InputContext* findContext(HWND window)
+{
+	for (UINT32 i = 0; i < MAX_CONTEXTS; i++)
 	{
-		TOUCHINPUT touch = pInputs[i];
+		if (_contexts[i].window == window) return &_contexts[i];
+	}
+	return NULL;
+}
 
-		POINT p;
-		p.x = touch.x / 100;
-		p.y = touch.y / 100;
-		ScreenToClient(_currentWindow, &p);
+// Subclasses the window with the window proc of the current API. Screen params and delivery mode of the context are kept.
+void hookWindow(InputContext& context, HWND window, PointerDelegatePtr delegate)
+{
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	context.stats.setFrequency(frequency.QuadPart);
+	context.delegate = delegate;
+	context.window = window;
+	updateClientOrigin(context);
 
-		Vector2 position = Vector2(((float)p.x - _offsetX) * _scaleX, _screenHeight - ((float)p.y - _offsetY) * _scaleY);
-		PointerData data {};
+	WNDPROC proc = _api == WIN8 ? wndProc8 : _api == RAW ? wndProcRaw : wndProc7;
+	if (_api == WIN7) RegisterTouchWindow(window, 0);
+	context.oldWindowProc = SetWindowLongPtr(window, GWLP_WNDPROC, (LONG_PTR)proc);
+}
 
-		if ((touch.dwFlags & TOUCHEVENTF_DOWN) != 0)
-		{
-			msg = WM_POINTERDOWN;
-			data.changedButtons = POINTER_CHANGE_FIRSTBUTTON_DOWN;
-		}
-		else if ((touch.dwFlags & TOUCHEVENTF_UP) != 0)
-		{
-			msg = WM_POINTERLEAVE;
-			data.changedButtons = POINTER_CHANGE_FIRSTBUTTON_UP;
-		}
-		else if ((touch.dwFlags & TOUCHEVENTF_MOVE) != 0)
+void unhookWindow(InputContext& context)
+{
+	if (!context.window) return;
+
+	if (context.oldWindowProc)
+	{
+		SetWindowLongPtr(context.window, GWLP_WNDPROC, context.oldWindowProc);
+		if (_api == WIN7) UnregisterTouchWindow(context.window);
+	}
+	if (_context == &context) _context = &_contexts[DEFAULT_CONTEXT];
+	context.window = NULL;
+	context.oldWindowProc = 0;
+	context.deliveryMode.store(DELIVERY_CALLBACK, std::memory_order_release);
+	context.eventBuffer.release();
+	context.frameMark.store(0, std::memory_order_relaxed);
+	context.stats.reset();
+	context.filter.clear();
+	context.slots.clear();
+}
+
+BOOL CALLBACK findUnityWindowProc(HWND hwnd, LPARAM lParam)
+{
+	DWORD process;
+	GetWindowThreadProcessId(hwnd, &process);
+	if (process != GetCurrentProcessId()) return TRUE;
+
+	char className[32];
+	if (GetClassNameA(hwnd, className, sizeof(className)) == 0 || strcmp(className, "UnityWndClass") != 0) return TRUE;
+
+	*(HWND*)lParam = hwnd;
+	return FALSE;
+}
+
+void UNITY_INTERFACE_API onRenderEvent(int eventId)
+{
+	switch (eventId)
+	{
+	case RENDER_EVENT_LATCH_POSITIONS:
+		latchPositions();
+		break;
+	default:
+		break;
+	}
+}
+
+// Copies positions from the pointer table to the latch, the mouse is refreshed from the cursor position.
+// Requires OPTION_POINTER_TABLE. Pending messages can only be dispatched on the window thread.
+// Only reads the pointer table, messages which haven't been dispatched yet are picked up by the next latch.
+bool latchPositions()
+{
+	if ((_options.load(std::memory_order_relaxed) & OPTION_POINTER_TABLE) == 0) return false;
+
+	LatchedPosition entries[MAX_TABLE_POINTERS];
+	UINT32 count = readPointerTable(entries);
+	if (count == 0xFFFFFFFF) return false;
+
+	POINT cursor;
+	if (GetCursorPos(&cursor))
+	{
+		// There is one cursor, it is latched in coordinates of the default context.
+		const ScreenTransform transform = _contexts[DEFAULT_CONTEXT].transform.read();
+		for (UINT32 i = 0; i < count; i++)
 		{
-			msg = WM_POINTERUPDATE;
+			if (entries[i].type != PT_MOUSE) continue;
+			entries[i].x = (float)cursor.x * transform.scaleX + transform.translateX;
+			entries[i].y = (float)cursor.y * transform.scaleY + transform.translateY;
 		}
-
-		_delegate(touch.dwID, msg, PT_TOUCH, position, data);
 	}
 
-	CloseTouchInputHandle((HTOUCHINPUT)lParam);
-	delete[] pInputs;
+	if (!_positionLatch.beginWrite()) return false;
+	LatchedPosition* target = _positionLatch.entries();
+	for (UINT32 i = 0; i < count; i++) target[i] = entries[i];
+	_positionLatch.setCount(count);
+	_positionLatch.endWrite();
+	return true;
 }
 
-void log(const wchar_t* str)
+// Returns the number of rows or 0xFFFFFFFF if the window thread kept writing the table.
+UINT32 readPointerTable(LatchedPosition* entries)
 {
-#if _DEBUG
-	BSTR bstr = SysAllocString(str);
-	_log(bstr);
-	SysFreeString(bstr);
-#endif
-}
\ No newline at end of file
+	for (UINT32 attempt = 0; attempt < MAX_TABLE_READ_ATTEMPTS; attempt++)
+	{
+		UINT32 sequence = _pointerTable.sequence.load(std::memory_order_acquire);
+		if ((sequence & 1) != 0) continue;
+
+		UINT32 count = _pointerTable.count;
+		if (count > MAX_TABLE_POINTERS) continue;
+		for (UINT32 i = 0; i < count; i++)
+		{
+			entries[i].id = _pointerTable.id[i];
+			entries[i].slot = _pointerTable.slot[i];
+			entries[i].type = _pointerTable.type[i];
+			entries[i].device = _pointerTable.device[i];
+			entries[i].x = _pointerTable.x[i];
+			entries[i].y = _pointerTable.y[i];
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (_pointerTable.sequence.load(std::memory_order_relaxed) == sequence) return count;
+	}
+	return 0xFFFFFFFF;
+}
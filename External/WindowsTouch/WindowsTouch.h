@@ -5,16 +5,98 @@
 #define WINVER				_WIN32_WINNT_WIN7
 #define _WIN32_WINNT		_WIN32_WINNT_WIN7
 
+// Must come before windows.h, which would pull in the old winsock.h instead.
+#include <winsock2.h>
 #include <windows.h>
+#include <atomic>
+#include <math.h>
+#include <stdlib.h>
+#include <xmmintrin.h>
+#include "ClusterSplit.h"
+#include "ContactSet.h"
+#include "HidDigitizer.h"
+#include "InputStats.h"
+#include "LogBuffer.h"
+#include "PackedEvent.h"
+#include "PointerFilter.h"
+#include "PointerPredictor.h"
+#include "PointerSlots.h"
+#include "PointerTable.h"
+#include "PositionLatch.h"
+#include "RingBuffer.h"
+#include "ScratchArena.h"
+#include "Tracing.h"
+#include "TuioDecoder.h"
+#include "UnityPluginApi.h"
 
 #define EXPORT_API __declspec(dllexport) 
 
+#pragma comment(lib, "ws2_32.lib")
+
+#ifndef WINDOWSTOUCH_NO_TRACING
+TRACELOGGING_DEFINE_PROVIDER(_traceProvider, "TouchScript.WindowsTouch",
+	(0xb97484da, 0x705f, 0x514b, 0x58, 0xda, 0x88, 0xf2, 0x0b, 0x03, 0x97, 0x25));
+#endif
+
 typedef enum
 {
 	WIN7,
-	WIN8
+	WIN8,
+	// HID multitouch reports read through WM_INPUT, touch only.
+	RAW
 } TOUCH_API;
 
+typedef enum
+{
+	DELIVERY_CALLBACK,
+	DELIVERY_BUFFERED
+} DELIVERY_MODE;
+
+typedef enum
+{
+	OPTION_NONE				= 0x00000000,
+	// Read all contacts of a frame with one call and skip the rest of the messages of this frame.
+	OPTION_FRAME_DECODE		= 0x00000001,
+	// Send all samples Windows coalesced into one update, each with its own timestamp.
+	OPTION_HISTORY			= 0x00000002,
+	// Keep the state of active pointers in PointerTable, in buffered mode plain updates are then only stored there.
+	OPTION_POINTER_TABLE	= 0x00000004,
+	// When events are drained, merge consecutive updates of every pointer into the latest one. Transitions are never merged.
+	OPTION_COALESCE			= 0x00000008,
+	// Keep updates removed by OPTION_COALESCE, managed code reads them with GetCoalescedEvents().
+	OPTION_COALESCE_HISTORY	= 0x00000010,
+	// Drop updates which don't move the pointer or change its pressure or rotation beyond SetFilterParams() epsilons.
+	OPTION_STATIONARY_FILTER = 0x00000020,
+	// Drop touches classified as palms, a palm which was already sent as a touch is cancelled.
+	OPTION_PALM_REJECT		= 0x00000040,
+	// Send touches classified as palms with TOUCH_FLAG_PALM set.
+	OPTION_PALM_TAG			= 0x00000080,
+	// Track positions of active touches for GetContactAggregates().
+	OPTION_CONTACT_AGGREGATES = 0x00000100,
+	// GetPointerEvents() doesn't return events committed after the last BeginFrame().
+	OPTION_FRAME_SYNC		= 0x00000200,
+	// Smooth positions with OneEuroFilter before the stationary filter sees them.
+	OPTION_JITTER_FILTER	= 0x00000400
+} PLUGIN_OPTIONS;
+
+typedef enum
+{
+	// Every contact moves in its own random direction, bouncing off the window edges.
+	SYNTHETIC_RANDOM_WALK,
+	// Contacts sit on a rotating circle around the window center whose radius oscillates.
+	SYNTHETIC_PINCH,
+	// Contacts sweep across the window in rows, lifting at the right edge and landing again at the left.
+	SYNTHETIC_SWIPE_STORM
+} SYNTHETIC_PATTERN;
+
+typedef enum
+{
+	// Deliver recorded events spaced as they were captured.
+	REPLAY_ORIGINAL_TIMING,
+	// Deliver as many recorded events as every UpdateReplay() call allows.
+	REPLAY_FAST
+} REPLAY_MODE;
+
 // <Windows 8 touch API>
 
 #define WM_POINTERENTER				0x0249
@@ -23,8 +105,14 @@ typedef enum
 #define WM_POINTERDOWN				0x0246
 #define WM_POINTERUP				0x0247
 #define WM_POINTERCAPTURECHANGED    0x024C
+#define WM_POINTERFIRST				0x0245
+#define WM_POINTERLAST				0x0257
 #define POINTER_CANCELLED			0x1000
 
+#ifndef WM_DPICHANGED
+#define WM_DPICHANGED				0x02E0
+#endif
+
 #define GET_POINTERID_WPARAM(wParam)	(LOWORD(wParam))
 
 typedef enum {
@@ -72,7 +160,9 @@ typedef enum {
 } POINTER_BUTTON_CHANGE_TYPE;
 
 typedef enum {
-	TOUCH_FLAG_NONE			= 0x00000000
+	TOUCH_FLAG_NONE			= 0x00000000,
+	// Not a Windows flag, set by the plugin on touches classified as palms.
+	TOUCH_FLAG_PALM			= 0x00010000
 } TOUCH_FLAGS;
 
 typedef enum {
@@ -139,10 +229,70 @@ typedef struct {
 typedef BOOL (WINAPI *GET_POINTER_INFO)(UINT32 pointerId, POINTER_INFO *pointerInfo);
 typedef BOOL (WINAPI *GET_POINTER_TOUCH_INFO)(UINT32 pointerId, POINTER_TOUCH_INFO *pointerInfo);
 typedef BOOL (WINAPI *GET_POINTER_PEN_INFO)(UINT32 pointerId, POINTER_PEN_INFO *pointerInfo);
+typedef BOOL (WINAPI *GET_POINTER_FRAME_TOUCH_INFO)(UINT32 pointerId, UINT32 *pointerCount, POINTER_TOUCH_INFO *touchInfo);
+typedef BOOL (WINAPI *GET_POINTER_FRAME_PEN_INFO)(UINT32 pointerId, UINT32 *pointerCount, POINTER_PEN_INFO *penInfo);
+typedef BOOL (WINAPI *GET_POINTER_INFO_HISTORY)(UINT32 pointerId, UINT32 *entriesCount, POINTER_INFO *pointerInfo);
+typedef BOOL (WINAPI *GET_POINTER_TOUCH_INFO_HISTORY)(UINT32 pointerId, UINT32 *entriesCount, POINTER_TOUCH_INFO *touchInfo);
+typedef BOOL (WINAPI *GET_POINTER_PEN_INFO_HISTORY)(UINT32 pointerId, UINT32 *entriesCount, POINTER_PEN_INFO *penInfo);
+typedef BOOL (WINAPI *GET_POINTER_FRAME_TOUCH_INFO_HISTORY)(UINT32 pointerId, UINT32 *entriesCount, UINT32 *pointerCount, POINTER_TOUCH_INFO *touchInfo);
+typedef BOOL (WINAPI *GET_POINTER_FRAME_PEN_INFO_HISTORY)(UINT32 pointerId, UINT32 *entriesCount, UINT32 *pointerCount, POINTER_PEN_INFO *penInfo);
 
 GET_POINTER_INFO			GetPointerInfo;
 GET_POINTER_TOUCH_INFO		GetPointerTouchInfo;
 GET_POINTER_PEN_INFO		GetPointerPenInfo;
+GET_POINTER_FRAME_TOUCH_INFO	GetPointerFrameTouchInfo;
+GET_POINTER_FRAME_PEN_INFO	GetPointerFramePenInfo;
+GET_POINTER_INFO_HISTORY	GetPointerInfoHistory;
+GET_POINTER_TOUCH_INFO_HISTORY	GetPointerTouchInfoHistory;
+GET_POINTER_PEN_INFO_HISTORY	GetPointerPenInfoHistory;
+GET_POINTER_FRAME_TOUCH_INFO_HISTORY	GetPointerFrameTouchInfoHistory;
+GET_POINTER_FRAME_PEN_INFO_HISTORY	GetPointerFramePenInfoHistory;
+
+typedef enum {
+	POINTER_DEVICE_TYPE_UNKNOWN	= 0x00000000,	// not a Windows value, the device couldn't be queried
+	POINTER_DEVICE_TYPE_INTEGRATED_PEN = 0x00000001,
+	POINTER_DEVICE_TYPE_EXTERNAL_PEN = 0x00000002,
+	POINTER_DEVICE_TYPE_TOUCH	= 0x00000003,
+	POINTER_DEVICE_TYPE_TOUCH_PAD = 0x00000004,
+	POINTER_DEVICE_TYPE_MOUSE	= 0x00000100	// not a Windows value, a mouse told apart by raw input
+} POINTER_DEVICE_TYPE;
+
+#define POINTER_DEVICE_PRODUCT_STRING_MAX	520
+
+typedef struct {
+	DWORD					displayOrientation;
+	HANDLE					device;
+	POINTER_DEVICE_TYPE		pointerDeviceType;
+	HMONITOR				monitor;
+	ULONG					startingCursorId;
+	USHORT					maxActiveContacts;
+	WCHAR					productString[POINTER_DEVICE_PRODUCT_STRING_MAX];
+} POINTER_DEVICE_INFO;
+
+typedef BOOL (WINAPI *GET_POINTER_DEVICE)(HANDLE device, POINTER_DEVICE_INFO *pointerDevice);
+typedef BOOL (WINAPI *GET_POINTER_DEVICE_RECTS)(HANDLE device, RECT *pointerDeviceRect, RECT *displayRect);
+
+// Also used to describe WM_TOUCH and raw input devices when Windows has them.
+GET_POINTER_DEVICE			GetPointerDevice;
+GET_POINTER_DEVICE_RECTS	GetPointerDeviceRects;
+
+typedef BOOL (WINAPI *ENABLE_MOUSE_IN_POINTER)(BOOL enable);
+typedef BOOL (WINAPI *IS_MOUSE_IN_POINTER_ENABLED)();
+
+ENABLE_MOUSE_IN_POINTER		EnableMouseInPointer;
+IS_MOUSE_IN_POINTER_ENABLED	IsMouseInPointerEnabled;
+
+#define HID_GENERIC_DESKTOP_PAGE	0x01
+#define HID_GENERIC_MOUSE			0x02
+
+#define TOUCH_FEEDBACK_NONE			0x3
+#define MAX_TOUCH_COUNT				256
+
+typedef BOOL (WINAPI *INITIALIZE_TOUCH_INJECTION)(UINT32 maxCount, DWORD dwMode);
+typedef BOOL (WINAPI *INJECT_TOUCH_INPUT)(UINT32 count, const POINTER_TOUCH_INFO *contacts);
+
+INITIALIZE_TOUCH_INJECTION	InitializeTouchInjection;
+INJECT_TOUCH_INPUT		InjectTouchInput;
 
 // </Windows 8 touch API>
 
@@ -150,6 +300,8 @@ struct Vector2
 {
 	float x, y;
 
+	Vector2() : x(0), y(0) {}
+
 	Vector2(float x, float y)
 	{
 		this->x = x;
@@ -169,30 +321,416 @@ struct PointerData
 	INT32					tiltY;
 };
 
-typedef void(__stdcall * PointerDelegatePtr)(int id, UINT32 event, POINTER_INPUT_TYPE type, Vector2 position, PointerData data);
-typedef void(__stdcall * LogFuncPtr)(BSTR log);
-
-PointerDelegatePtr			_delegate;
-LogFuncPtr					_log;
-HWND						_currentWindow;
-int							_screenWidth;
-int							_screenHeight;
-float						_offsetX = 0;
-float						_offsetY = 0;
-float						_scaleX = 1;
-float						_scaleY = 1;
+// Maps screen pixels to TouchScript coordinates: position * scale + translate.
+// Pairs are stored as (x, y) so that two points can be transformed with one SSE operation.
+struct ScreenTransform
+{
+	float					scaleX, scaleY;
+	float					translateX, translateY;
+};
+
+// A ScreenTransform one thread replaces while another one reads it, readers never wait for the writer.
+// Sequence lock like PointerTable, writers must be serialized by the caller.
+struct PublishedTransform
+{
+	std::atomic<UINT32>		sequence;
+	ScreenTransform			value;
+
+	PublishedTransform() : sequence(0)
+	{
+		value.scaleX = 1;
+		value.scaleY = -1;
+		value.translateX = 0;
+		value.translateY = 0;
+	}
+
+	void write(const ScreenTransform& transform)
+	{
+		sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		value = transform;
+		sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	ScreenTransform read() const
+	{
+		for (;;)
+		{
+			UINT32 start = sequence.load(std::memory_order_acquire);
+			if ((start & 1) != 0)
+			{
+				YieldProcessor();
+				continue;
+			}
+			ScreenTransform transform = value;
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (sequence.load(std::memory_order_relaxed) == start) return transform;
+		}
+	}
+};
+
+// A single decoded pointer event as it goes through the pipeline and to the delegate.
+// Event buffers, capture files and TUIO get it as a PackedEvent.
+struct EventRecord
+{
+	int						id;
+	UINT32					event;
+	POINTER_INPUT_TYPE		type;
+	Vector2					position;
+	PointerData				data;
+	INT32					slot;		// dense index from PointerSlots, -1 if all slots were taken
+	UINT32					device;		// index of the source device, see GetDevices()
+	UINT64					timestamp;	// QPC time of the sample, POINTER_INFO.PerformanceCount when available
+	UINT64					received;	// QPC time when the message entered the window proc
+};
+
+// Capture files start with this header followed by PackedEvents exactly as they were delivered.
+struct CaptureHeader
+{
+	UINT32					magic;
+	UINT16					version;
+	UINT16					recordSize;
+	UINT64					frequency;	// QPC frequency of the machine which recorded the file
+};
+
+// An event decoded by a window proc and waiting for the delivery thread, see StartDeliveryThread().
+// Position is still in screen pixels and the event is not filtered yet.
+struct QueuedEvent
+{
+	EventRecord				record;
+	UINT32					context;
+};
+
+// Stationary and palm filter settings, see SetFilterParams().
+struct FilterParams
+{
+	float					positionEpsilon;
+	UINT32					pressureEpsilon;
+	UINT32					rotationEpsilon;
+	// Touches with a larger contact area in pixels are palms, 0 disables the check.
+	UINT32					maxContactArea;
+	// Touches without POINTER_FLAG_CONFIDENCE are palms.
+	bool					requireConfidence;
+};
+
+// TUIO events are PackedEvents too: WM_POINTERDOWN, WM_POINTERUPDATE or WM_POINTERUP, PT_TOUCH for cursors and PT_POINTER
+// for objects and blobs, position in normalized TUIO coordinates with y pointing down. The other fields carry the rest:
+// mask is the TUIO_KIND, flags the class id of an object, rotation the angle in TUIO_ANGLE_SCALE units of a degree,
+// tiltX and tiltY the width and height of a blob in TUIO_SIZE_SCALE units of the screen size.
+#define TUIO_ANGLE_SCALE			100
+#define TUIO_SIZE_SCALE				10000
+#define TUIO_BUFFER_CAPACITY		2048
+// Largest UDP payload, bigger datagrams are truncated and dropped.
+#define TUIO_MAX_PACKET				65536
+#define TUIO_MAX_EVENTS				1024
+#define TUIO_RECEIVE_BUFFER			(1024 * 1024)
+// How often in ms the receiver thread checks if it was stopped while no packets arrive.
+#define TUIO_POLL_INTERVAL			50
+
+#define CAPTURE_MAGIC				0x43505354	// "TSPC"
+#define CAPTURE_VERSION				4
+#define CAPTURE_BUFFER_CAPACITY		8192
+#define CAPTURE_FLUSH_INTERVAL		50
+
+#define DEFAULT_BUFFER_CAPACITY		1024
+#define DELIVERY_QUEUE_CAPACITY		4096
+#define MAX_BATCH_SIZE				256
+#define MAX_FRAME_POINTERS			128
+#define MAX_COALESCED_EVENTS		1024
+#define DEFAULT_SCRATCH_SIZE		(MAX_FRAME_POINTERS * sizeof(POINTER_TOUCH_INFO))
+#define MAX_SYNTHETIC_HZ			1000
+#define MAX_DEVICES					16
+#define MAX_TABLE_READ_ATTEMPTS		64
+// How many raw input blocks of the first block's size are read with one GetRawInputBuffer call.
+#define RAW_INPUT_BATCH				64
+#define MAX_CONTEXTS				8
+// Context of the Unity window hooked by Init(), exports without a context argument use it.
+#define DEFAULT_CONTEXT				0
+
+// Ids of GL.IssuePluginEvent events handled by the function GetRenderEventFunc() returns.
+typedef enum
+{
+	// Snapshots the freshest pointer positions, GetLatchedPositions() returns them.
+	RENDER_EVENT_LATCH_POSITIONS = 1
+} RENDER_EVENT;
+
+// State of one injected contact.
+struct SyntheticContact
+{
+	float					x, y;
+	float					dx, dy;
+	bool					down;
+};
+
+// A source device in the order it was first seen, the position in GetDevices() output is its device index.
+// Must match NativeDeviceInfo in managed code.
+struct DeviceInfo
+{
+	UINT32					index;
+	POINTER_DEVICE_TYPE		type;
+	UINT32					maxContacts;	// 0 if unknown
+	INT32					monitor;		// in EnumDisplayMonitors order, -1 if unknown
+	RECT					displayRect;	// screen pixels the device maps to
+	RECT					monitorRect;
+};
+
+// State of findMonitorProc() which counts monitors until it finds the one it looks for.
+struct MonitorSearch
+{
+	HMONITOR				monitor;
+	INT32					index;
+	INT32					found;
+};
+
+typedef void(__stdcall * PointerDelegatePtr)(int id, int slot, UINT32 device, UINT32 event, POINTER_INPUT_TYPE type, Vector2 position, PointerData data, UINT64 received);
+
+// State of one hooked window: its transform, event buffer, stats, filter state and slots.
+// Decoding state like the batch is shared, so all hooked windows must belong to one thread.
+// Pointer table, prediction and contact aggregates are indexed by slot and only cover the default context.
+struct InputContext
+{
+	HWND					window;		// NULL if the context is free
+	PointerDelegatePtr		delegate;
+	LONG_PTR				oldWindowProc;
+	// Guards screen params and client origin, which SetContextScreenParams() and the window proc both change.
+	SRWLOCK					lock;
+	int						screenWidth;
+	int						screenHeight;
+	float					offsetX, offsetY;
+	float					scaleX, scaleY;
+	// Screen position of the client area, updated on WM_MOVE, WM_SIZE and WM_DPICHANGED.
+	POINT					clientOrigin;
+	PublishedTransform		transform;
+	std::atomic<int>		deliveryMode;
+	RingBuffer<PackedEvent>	eventBuffer;
+	// Committed events in the event buffer when the current frame began.
+	std::atomic<UINT32>		frameMark;
+	StatsCounters			stats;
+	// Pointers of every context are filtered and slotted on their own, so slots are only unique within a context.
+	PointerFilter			filter;
+	PointerSlots			slots;
+
+	InputContext() : window(NULL), delegate(NULL), oldWindowProc(0), screenWidth(0), screenHeight(0),
+		offsetX(0), offsetY(0), scaleX(1), scaleY(1), deliveryMode(DELIVERY_CALLBACK), frameMark(0)
+	{
+		InitializeSRWLock(&lock);
+		clientOrigin.x = clientOrigin.y = 0;
+	}
+};
+
+InputContext				_contexts[MAX_CONTEXTS];
+// Context of the window whose message is being decoded, or whose events the delivery thread is publishing.
+thread_local InputContext*	_context = &_contexts[DEFAULT_CONTEXT];
+// Delivery thread. While it runs window procs only decode events and queue them, the thread does everything else.
+std::atomic<bool>			_delivering(false);
+RingBuffer<QueuedEvent>		_inputQueue;
+HANDLE						_deliveryThread = NULL;
+HANDLE						_deliveryWake = NULL;
+// Events which didn't fit into the queue since the last flush.
+UINT32						_queueDropped = 0;
+// Guards the predictor and the contact set, which the delivery thread updates while the main thread reads them.
+SRWLOCK						_trackingLock = SRWLOCK_INIT;
+// Set when Unity loaded the plugin through UnityPluginLoad.
+IUnityInterfaces*			_unityInterfaces = NULL;
+IUnityGraphics*				_unityGraphics = NULL;
+UnityGfxRenderer			_unityRenderer = kUnityGfxRendererNull;
 TOUCH_API					_api;
-LONG_PTR					_oldWindowProc;
+
+EventRecord					_batch[MAX_BATCH_SIZE];
+UINT32						_batchSize = 0;
+
+std::atomic<UINT32>			_options(OPTION_NONE);
+UINT64						_messageTime = 0;
+UINT32						_lastFrameId = 0;
+HANDLE						_lastFrameDevice = NULL;
+PointerTable				_pointerTable;
+PositionLatch				_positionLatch;
+PointerPredictor			_predictor;
+// Written under _trackingLock, the delivery thread reads them while it feeds the predictor.
+PREDICTION_MODE				_predictionModes[STATS_POINTER_TYPES] = {PREDICT_NONE};
+// Set if any pointer type is predicted, otherwise the predictor is never touched.
+std::atomic<bool>			_predicting(false);
+// Written under _trackingLock, filterPointer() copies them under it since it runs on the delivery thread too.
+FilterParams				_filterParams = {.5f, 0, 0, 0, false};
+OneEuroFilter				_jitterFilter;
+ContactSet					_contactSet;
+// Source devices in the order they were first seen, a device index is a position in these arrays.
+HANDLE						_devices[MAX_DEVICES];
+DeviceInfo					_deviceInfos[MAX_DEVICES];
+UINT32						_deviceCount = 0;
+// Device index of the message being decoded.
+UINT32						_currentDevice = 0;
+// Set by SetMouseInPointer(). WM_POINTER mouse messages of all mice have the same source device,
+// so the mouse which sent the last raw input is taken as the source instead.
+bool						_mouseInPointer = false;
+HANDLE						_mouseDevice = NULL;
+// Set if SetMouseInPointer() registered for raw mouse input, a registration made by Unity is left alone.
+bool						_ownsRawMice = false;
+// Report layouts of raw input devices by device index.
+HidDigitizer				_digitizers[MAX_DEVICES];
+// GetRawInputBuffer returns 64 bit headers to 32 bit processes on 64 bit Windows.
+UINT32						_rawHeaderPadding = 0;
+// Consumer side state of OPTION_COALESCE: pointers whose latest update can still be replaced and where it is.
+// Merged away updates of all contexts end up in _coalescedEvents.
+int							_coalesceIds[MAX_FRAME_POINTERS];
+UINT32						_coalesceIndices[MAX_FRAME_POINTERS];
+UINT32						_coalesceCount = 0;
+PackedEvent					_coalescedEvents[MAX_COALESCED_EVENTS];
+UINT32						_coalescedCount = 0;
+// Memory for GetPointer*Info and GetTouchInputInfo calls, reused between messages.
+ScratchArena				_scratch;
+// Frame of the message being decoded for trace events, WM_TOUCH messages are numbered by the plugin.
+UINT32						_traceFrameId = 0;
+bool						_traceRegistered = false;
+LogBuffer					_logBuffer;
+// Synthetic load generator, the thread only runs while _syntheticRunning is set.
+HANDLE						_syntheticThread = NULL;
+std::atomic<bool>			_syntheticRunning(false);
+UINT32						_syntheticContactCount = 0;
+UINT32						_syntheticHz = 0;
+SYNTHETIC_PATTERN			_syntheticPattern = SYNTHETIC_RANDOM_WALK;
+// Screen rectangle of the client area when the load was started.
+RECT						_syntheticArea;
+// Capture, the window thread pushes delivered events which the capture thread appends to the file.
+std::atomic<bool>			_capturing(false);
+RingBuffer<PackedEvent>		_captureBuffer;
+HANDLE						_captureFile = INVALID_HANDLE_VALUE;
+HANDLE						_captureThread = NULL;
+HANDLE						_captureWake = NULL;
+// Replay of a memory mapped capture, live input is ignored while it is active.
+HANDLE						_replayFile = INVALID_HANDLE_VALUE;
+HANDLE						_replayMapping = NULL;
+const PackedEvent*			_replayRecords = NULL;
+UINT32						_replayCount = 0;
+UINT32						_replayIndex = 0;
+REPLAY_MODE					_replayMode = REPLAY_ORIGINAL_TIMING;
+UINT64						_replayStart = 0;
+// Recorded QPC ticks per local QPC tick.
+double						_replayTickScale = 1;
+// TUIO receiver, the thread decodes datagrams and pushes events which GetTuioEvents() pops on the main thread.
+std::atomic<bool>			_tuioRunning(false);
+HANDLE						_tuioThread = NULL;
+SOCKET						_tuioSocket = INVALID_SOCKET;
+RingBuffer<PackedEvent>		_tuioBuffer;
+// Only touched by the receiver thread.
+TuioDecoder					_tuioDecoder;
+PointerSlots				_tuioSlots;
+char						_tuioPacket[TUIO_MAX_PACKET];
+TuioEvent					_tuioEvents[TUIO_MAX_EVENTS];
+SyntheticContact			_syntheticContacts[MAX_TOUCH_COUNT];
+POINTER_TOUCH_INFO			_syntheticInfos[MAX_TOUCH_COUNT];
 
 extern "C" 
 {
-	EXPORT_API void __stdcall Init(TOUCH_API api, LogFuncPtr logFunc, PointerDelegatePtr delegate);
+	UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API UnityPluginLoad(IUnityInterfaces* unityInterfaces);
+	UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API UnityPluginUnload();
+	EXPORT_API void __stdcall Init(TOUCH_API api, PointerDelegatePtr delegate);
 	EXPORT_API void __stdcall SetScreenParams(int width, int height, float offsetX, float offsetY, float scaleX, float scaleY);
+	EXPORT_API void __stdcall SetJitterFilterParams(float minCutoff, float beta, float derivativeCutoff);
 	EXPORT_API void __stdcall Dispose();
+	EXPORT_API int __stdcall CreateContext(HWND window, PointerDelegatePtr delegate);
+	EXPORT_API void __stdcall DestroyContext(int context);
+	EXPORT_API void __stdcall SetContextScreenParams(int context, int width, int height, float offsetX, float offsetY, float scaleX, float scaleY);
+	EXPORT_API void __stdcall SetContextDeliveryMode(int context, DELIVERY_MODE mode, int capacity);
+	EXPORT_API int __stdcall GetContextPointerEvents(int context, PackedEvent* buffer, int capacity);
+	EXPORT_API void __stdcall GetContextInputStats(int context, InputStats* stats);
+	EXPORT_API void __stdcall SetDeliveryMode(DELIVERY_MODE mode, int capacity);
+	EXPORT_API BOOL __stdcall StartDeliveryThread();
+	EXPORT_API void __stdcall StopDeliveryThread();
+	EXPORT_API void __stdcall SetOptions(UINT32 options);
+	EXPORT_API BOOL __stdcall SetMouseInPointer(BOOL enable);
+	EXPORT_API void __stdcall SetFilterParams(float positionEpsilon, UINT32 pressureEpsilon, UINT32 rotationEpsilon, UINT32 maxContactArea, BOOL requireConfidence);
+	EXPORT_API void __stdcall BeginFrame();
+	EXPORT_API int __stdcall GetPointerEvents(PackedEvent* buffer, int capacity);
+	EXPORT_API int __stdcall GetCoalescedEvents(PackedEvent* buffer, int capacity);
+	EXPORT_API PointerTable* __stdcall GetPointerTable();
+	EXPORT_API UnityRenderingEvent __stdcall GetRenderEventFunc();
+	EXPORT_API BOOL __stdcall LatchPositions();
+	EXPORT_API int __stdcall GetLatchedPositions(LatchedPosition* buffer, int capacity);
+	EXPORT_API void __stdcall SetPrediction(POINTER_INPUT_TYPE type, PREDICTION_MODE mode);
+	EXPORT_API void __stdcall SetPredictionParams(float processNoise, float measurementNoise, float maxHorizon);
+	EXPORT_API int __stdcall PredictPositions(UINT64 target, LatchedPosition* buffer, int capacity);
+	EXPORT_API int __stdcall GetContactAggregates(ContactAggregate* buffer, int capacity);
+	EXPORT_API int __stdcall GetDevices(DeviceInfo* buffer, int capacity);
+	EXPORT_API int __stdcall SplitClusters(const Vector2* points, int count, int* assignments, Vector2* centers);
+	EXPORT_API BOOL __stdcall StartSyntheticLoad(int contacts, int hz, SYNTHETIC_PATTERN pattern);
+	EXPORT_API void __stdcall StopSyntheticLoad();
+	EXPORT_API BOOL __stdcall StartCapture(LPCWSTR path);
+	EXPORT_API void __stdcall StopCapture();
+	EXPORT_API BOOL __stdcall StartReplay(LPCWSTR path, REPLAY_MODE mode);
+	EXPORT_API int __stdcall UpdateReplay(int maxEvents);
+	EXPORT_API void __stdcall StopReplay();
+	EXPORT_API BOOL __stdcall StartTuio(int port);
+	EXPORT_API void __stdcall StopTuio();
+	EXPORT_API int __stdcall GetTuioEvents(PackedEvent* buffer, int capacity);
+	EXPORT_API UINT32 __stdcall GetEventFormat();
+	EXPORT_API void __stdcall GetInputStats(InputStats* stats);
+	EXPORT_API void __stdcall ResetInputStats();
+	EXPORT_API void __stdcall SetLogLevel(LOG_LEVEL level);
+	EXPORT_API int __stdcall GetLogEntry(LOG_LEVEL* level, wchar_t* text, int capacity);
 }
 
-void log(const wchar_t* str);
+void log(LOG_LEVEL level, const wchar_t* format, ...);
+void UNITY_INTERFACE_API onGraphicsDeviceEvent(UnityGfxDeviceEventType eventType);
+HWND findUnityWindow();
+InputContext* getContext(int index);
+InputContext* findContext(HWND window);
+void hookWindow(InputContext& context, HWND window, PointerDelegatePtr delegate);
+void unhookWindow(InputContext& context);
+void UNITY_INTERFACE_API onRenderEvent(int eventId);
+bool latchPositions();
+UINT32 readPointerTable(LatchedPosition* entries);
+BOOL CALLBACK findUnityWindowProc(HWND hwnd, LPARAM lParam);
 LRESULT CALLBACK wndProc8(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 LRESULT CALLBACK wndProc7(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
-void decodeWin8Touches(UINT msg, WPARAM wParam, LPARAM lParam);
-void decodeWin7Touches(UINT msg, WPARAM wParam, LPARAM lParam);
\ No newline at end of file
+LRESULT CALLBACK wndProcRaw(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
+bool decodeWin8Touches(UINT msg, WPARAM wParam, LPARAM lParam);
+bool decodeWin7Touches(UINT msg, WPARAM wParam, LPARAM lParam);
+bool registerRawInput(bool add);
+void registerRawMice(bool add);
+void trackMouseDevice(HRAWINPUT handle);
+bool ownsRawInputBuffer();
+void decodeRawInput(HRAWINPUT handle);
+void decodeRawInputBuffer();
+void decodeHidReports(HANDLE device, const RAWHID& hid);
+void emitHidContact(HidDigitizer& digitizer, const HidContact& contact, UINT64 timestamp);
+int hidPointerId(ULONG contactId);
+bool decodeWin8Frame(int pointerId, const POINTER_INFO& pointerInfo, UINT32 entries);
+bool decodeWin8History(int pointerId, const POINTER_INFO& pointerInfo, UINT32 entries);
+template <typename T> void emitFrames(T* infos, UINT32 entries, UINT32 count);
+void emitFramePointer(const POINTER_INFO& pointerInfo, const PointerData& data);
+void updateClientOrigin(InputContext& context);
+void updateTransform(InputContext& context);
+Vector2 screenPosition(POINT p);
+void fillPointerData(PointerData& data, const POINTER_TOUCH_INFO& touchInfo);
+void fillPointerData(PointerData& data, const POINTER_PEN_INFO& penInfo);
+UINT32 deviceIndex(HANDLE device);
+void describeDevice(HANDLE device, DeviceInfo& info);
+BOOL CALLBACK findMonitorProc(HMONITOR monitor, HDC hdc, LPRECT rect, LPARAM lParam);
+bool isPalmContact(UINT32 area, POINTER_FLAGS pointerFlags);
+bool filterPointer(EventRecord& record);
+void emitPointer(int id, UINT32 event, POINTER_INPUT_TYPE type, Vector2 position, const PointerData& data, UINT64 timestamp);
+bool processEvent(EventRecord& record);
+void queueEvent(const EventRecord& record);
+void transformBatch();
+bool writePointerTable(const EventRecord& record);
+bool isPlainUpdate(const EventRecord& record);
+bool isPlainUpdate(const PackedEvent& event);
+UINT32 popCoalesced(InputContext& context, PackedEvent* buffer, UINT32 capacity, UINT32 available, bool keepHistory);
+void flushBatch();
+void publishBatch();
+void deliverBatch();
+void updatePredictor();
+DWORD WINAPI deliveryThread(LPVOID param);
+void publishQueued(const QueuedEvent* events, UINT32 count);
+DWORD WINAPI captureThread(LPVOID param);
+DWORD WINAPI tuioThread(LPVOID param);
+void receiveTuio(UINT64 timestamp);
+void pushTuioEvent(const TuioEvent& event, UINT64 timestamp);
+bool writeCapture(PackedEvent* chunk, UINT32 capacity);
+DWORD WINAPI syntheticLoadThread(LPVOID param);
+void initSyntheticContacts(const RECT& area);
+bool updateSyntheticContact(UINT32 index, UINT32 frame, const RECT& area);
+void fillSyntheticInfo(POINTER_TOUCH_INFO& info, UINT32 index, POINTER_FLAGS flags);
+void waitUntil(UINT64 time, UINT64 frequency);
+UINT64 getTimestamp();
\ No newline at end of file
@@ -16,9 +16,10 @@ namespace TouchScript.Editor.Behaviors.Visualizer
         public static readonly GUIContent TEXT_CURSORS_HEADER = new GUIContent("Cursors", "Cursor prefabs used for different pointer types.");
         public static readonly GUIContent TEXT_POINTER_SIZE = new GUIContent("Pointer size (cm)", "Pointer size in cm based on current DPI.");
         public static readonly GUIContent TEXT_POINTER_PIXEL_SIZE = new GUIContent("Pointer size (px)", "Pointer size in pixels.");
+        public static readonly GUIContent TEXT_LATE_LATCH = new GUIContent("Late Latch", "Move cursors to the freshest pointer positions right before canvases are drawn. Needs Shared Pointer Table on Standard Input in Windows builds.");
 
         private SerializedProperty mousePointerProxy, touchPointerProxy, penPointerProxy, objectPointerProxy;
-        private SerializedProperty useDPI, cursorSize, cursorPixelSize;
+        private SerializedProperty useDPI, cursorSize, cursorPixelSize, lateLatch;
         private SerializedProperty cursorsProps;
 
         private void OnEnable()
@@ -31,6 +32,7 @@ namespace TouchScript.Editor.Behaviors.Visualizer
             useDPI = serializedObject.FindProperty("useDPI");
             cursorSize = serializedObject.FindProperty("cursorSize");
             cursorPixelSize = serializedObject.FindProperty("cursorPixelSize");
+            lateLatch = serializedObject.FindProperty("lateLatch");
 
             cursorsProps = serializedObject.FindProperty("cursorsProps");
         }
@@ -50,6 +52,7 @@ namespace TouchScript.Editor.Behaviors.Visualizer
             {
                 EditorGUILayout.PropertyField(cursorPixelSize, TEXT_POINTER_PIXEL_SIZE);
             }
+            EditorGUILayout.PropertyField(lateLatch, TEXT_LATE_LATCH);
 
             var display = GUIElements.Header(TEXT_CURSORS_HEADER, cursorsProps);
             if (display)
@@ -15,6 +15,7 @@ namespace TouchScript.Editor.InputSources
         public static readonly GUIContent TEXT_GENERAL_HEADER = new GUIContent("General", "General settings.");
         public static readonly GUIContent TEXT_WINDOWS_HEADER = new GUIContent("Windows", "Windows specific settings.");
         public static readonly GUIContent TEXT_WEBGL_HEADER = new GUIContent("WebGL", "WebGL specific settings.");
+        public static readonly GUIContent TEXT_LINUX_HEADER = new GUIContent("Linux", "Linux specific settings.");
 
         public static readonly GUIContent TEXT_EMULATE_MOUSE = new GUIContent("Emulate Second Mouse Pointer", "If selected, you can press ALT to make a stationary mouse pointer. This is used to simulate multi-touch.");
 
@@ -24,15 +25,28 @@ namespace TouchScript.Editor.InputSources
         public static readonly GUIContent TEXT_WINDOWS8_MOUSE = new GUIContent("Enable Mouse on Windows 8+");
         public static readonly GUIContent TEXT_WINDOWS7_MOUSE = new GUIContent("Enable Mouse on Windows 7");
         public static readonly GUIContent TEXT_UWP_MOUSE = new GUIContent("Enable Mouse on UWP");
+        public static readonly GUIContent TEXT_WINDOWS8_FRAMES = new GUIContent("Decode Whole Frames on Windows 8+", "If selected, WindowsTouch.dll reads all contacts of a digitizer frame with one call instead of querying every pointer separately.");
+        public static readonly GUIContent TEXT_WINDOWS8_HISTORY = new GUIContent("Pointer History on Windows 8+", "If selected, WindowsTouch.dll sends all samples Windows coalesced into one update instead of only the latest one.");
+        public static readonly GUIContent TEXT_WINDOWS_BUFFERED = new GUIContent("Buffered Input", "If selected, WindowsTouch.dll buffers pointer events and they are processed once per frame instead of calling managed code for every event.");
+        public static readonly GUIContent TEXT_WINDOWS_POINTER_TABLE = new GUIContent("Shared Pointer Table", "If selected, WindowsTouch.dll keeps a table of active pointers. With Buffered Input pointer updates are read from it once per frame instead of processing every event.");
+        public static readonly GUIContent TEXT_WINDOWS_COALESCE = new GUIContent("Coalesce Updates", "If selected, WindowsTouch.dll merges consecutive updates of every pointer between frames into the latest one. Presses, releases and cancels are not merged. Works with Buffered Input.");
+        public static readonly GUIContent TEXT_WINDOWS_STATIONARY = new GUIContent("Suppress Stationary Updates", "If selected, WindowsTouch.dll drops updates of resting contacts which do not change position, pressure or rotation.");
+        public static readonly GUIContent TEXT_WINDOWS_PALM = new GUIContent("Palm Rejection", "If selected, WindowsTouch.dll drops touches which are too large or which the digitizer is not confident about.");
+        public static readonly GUIContent TEXT_WINDOWS_AGGREGATES = new GUIContent("Contact Aggregates", "Compute centroid, bounds, spread and angle of active touches in the native plugin.");
+        public static readonly GUIContent TEXT_WINDOWS_FRAME_SYNC = new GUIContent("Frame Sync", "If selected, WindowsTouch.dll holds buffered events which arrive after the frame began until the next frame. Works with Buffered Input.");
+        public static readonly GUIContent TEXT_WINDOWS_JITTER_FILTER = new GUIContent("Jitter Filter", "Smooth jittery pointer positions with a One Euro filter in the native plugin before they reach TouchScript.");
+        public static readonly GUIContent TEXT_WINDOWS_DELIVERY_THREAD = new GUIContent("Delivery Thread", "Filter, transform and publish pointer events on a native thread so that the window proc only decodes them. Requires Buffered Input.");
+
+        public static readonly GUIContent TEXT_LINUX_TOUCH = new GUIContent("Enable Touch on Linux", "If selected, libLinuxTouch.so reads multitouch screens through evdev. The user needs read access to /dev/input/event*, usually through the input group.");
 
         public static readonly GUIContent TEXT_HELP = new GUIContent("This component gathers input data from various devices like touch, mouse and pen on all platforms.");
 
         private SerializedProperty basicEditor;
 
         private SerializedProperty windows8Touch, windows7Touch, webGLTouch, windows8Mouse,
-                                   windows7Mouse, universalWindowsMouse, emulateSecondMousePointer;
+                                   windows7Mouse, universalWindowsMouse, windowsBufferedInput, windows8FrameDecoding, windows8PointerHistory, windowsPointerTable, windowsCoalesceUpdates, windowsSuppressStationary, windowsPalmRejection, windowsContactAggregates, windowsFrameSync, windowsJitterFilter, windowsDeliveryThread, linuxTouch, emulateSecondMousePointer;
 
-        private SerializedProperty generalProps, windowsProps, webglProps;
+        private SerializedProperty generalProps, windowsProps, webglProps, linuxProps;
 
         private StandardInput instance;
 
@@ -48,11 +62,24 @@ namespace TouchScript.Editor.InputSources
             windows8Mouse = serializedObject.FindProperty("windows8Mouse");
             windows7Mouse = serializedObject.FindProperty("windows7Mouse");
             universalWindowsMouse = serializedObject.FindProperty("universalWindowsMouse");
+            windowsBufferedInput = serializedObject.FindProperty("windowsBufferedInput");
+            windows8FrameDecoding = serializedObject.FindProperty("windows8FrameDecoding");
+            windows8PointerHistory = serializedObject.FindProperty("windows8PointerHistory");
+            windowsPointerTable = serializedObject.FindProperty("windowsPointerTable");
+            windowsCoalesceUpdates = serializedObject.FindProperty("windowsCoalesceUpdates");
+            windowsSuppressStationary = serializedObject.FindProperty("windowsSuppressStationary");
+            windowsPalmRejection = serializedObject.FindProperty("windowsPalmRejection");
+            windowsContactAggregates = serializedObject.FindProperty("windowsContactAggregates");
+            windowsFrameSync = serializedObject.FindProperty("windowsFrameSync");
+            windowsJitterFilter = serializedObject.FindProperty("windowsJitterFilter");
+            windowsDeliveryThread = serializedObject.FindProperty("windowsDeliveryThread");
+            linuxTouch = serializedObject.FindProperty("linuxTouch");
             emulateSecondMousePointer = serializedObject.FindProperty("emulateSecondMousePointer");
 
             generalProps = serializedObject.FindProperty("generalProps");
             windowsProps = serializedObject.FindProperty("windowsProps");
             webglProps = serializedObject.FindProperty("webglProps");
+            linuxProps = serializedObject.FindProperty("linuxProps");
         }
 
         public override void OnInspectorGUI()
@@ -85,6 +112,7 @@ namespace TouchScript.Editor.InputSources
                 drawGeneral();
                 drawWindows();
                 drawWebGL();
+                drawLinux();
             }
 
             serializedObject.ApplyModifiedProperties();
@@ -119,6 +147,17 @@ namespace TouchScript.Editor.InputSources
                 EditorGUILayout.PropertyField(windows8Mouse, TEXT_WINDOWS8_MOUSE);
                 EditorGUILayout.PropertyField(windows7Mouse, TEXT_WINDOWS7_MOUSE);
                 EditorGUILayout.PropertyField(universalWindowsMouse, TEXT_UWP_MOUSE);
+                EditorGUILayout.PropertyField(windowsBufferedInput, TEXT_WINDOWS_BUFFERED);
+                EditorGUILayout.PropertyField(windowsPointerTable, TEXT_WINDOWS_POINTER_TABLE);
+                EditorGUILayout.PropertyField(windowsCoalesceUpdates, TEXT_WINDOWS_COALESCE);
+                EditorGUILayout.PropertyField(windowsSuppressStationary, TEXT_WINDOWS_STATIONARY);
+                EditorGUILayout.PropertyField(windowsPalmRejection, TEXT_WINDOWS_PALM);
+                EditorGUILayout.PropertyField(windowsContactAggregates, TEXT_WINDOWS_AGGREGATES);
+                EditorGUILayout.PropertyField(windowsFrameSync, TEXT_WINDOWS_FRAME_SYNC);
+                EditorGUILayout.PropertyField(windowsJitterFilter, TEXT_WINDOWS_JITTER_FILTER);
+                EditorGUILayout.PropertyField(windowsDeliveryThread, TEXT_WINDOWS_DELIVERY_THREAD);
+                EditorGUILayout.PropertyField(windows8FrameDecoding, TEXT_WINDOWS8_FRAMES);
+                EditorGUILayout.PropertyField(windows8PointerHistory, TEXT_WINDOWS8_HISTORY);
                 EditorGUI.indentLevel--;
             }
         }
@@ -133,5 +172,16 @@ namespace TouchScript.Editor.InputSources
                 EditorGUI.indentLevel--;
             }
         }
+
+        private void drawLinux()
+        {
+            var display = GUIElements.Header(TEXT_LINUX_HEADER, linuxProps);
+            if (display)
+            {
+                EditorGUI.indentLevel++;
+                EditorGUILayout.PropertyField(linuxTouch, TEXT_LINUX_TOUCH);
+                EditorGUI.indentLevel--;
+            }
+        }
     }
 }
\ No newline at end of file
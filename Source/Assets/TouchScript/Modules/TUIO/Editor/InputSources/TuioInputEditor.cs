@@ -13,10 +13,12 @@ namespace TouchScript.Editor.InputSources
     internal sealed class TuioInputEditor : InputSourceEditor
     {
         private static readonly GUIContent INPUT_TYPES = new GUIContent("Input Types", "Supported input types.");
+        private static readonly GUIContent NATIVE_RECEIVER = new GUIContent("Native Receiver", "Receive and decode TUIO in WindowsTouch.dll. Windows standalone builds only, also supports TUIO 2.0.");
 
         private TuioInput instance;
         private SerializedProperty supportedInputs;
         private SerializedProperty tuioPort;
+        private SerializedProperty nativeReceiver;
 
         protected override void OnEnable()
         {
@@ -25,6 +27,7 @@ namespace TouchScript.Editor.InputSources
             instance = target as TuioInput;
             supportedInputs = serializedObject.FindProperty("supportedInputs");
             tuioPort = serializedObject.FindProperty("tuioPort");
+            nativeReceiver = serializedObject.FindProperty("nativeReceiver");
         }
 
         public override void OnInspectorGUI()
@@ -49,6 +52,8 @@ namespace TouchScript.Editor.InputSources
             }
             EditorGUI.EndProperty();
 
+            EditorGUILayout.PropertyField(nativeReceiver, NATIVE_RECEIVER);
+
             serializedObject.ApplyModifiedProperties();
             base.OnInspectorGUI();
         }
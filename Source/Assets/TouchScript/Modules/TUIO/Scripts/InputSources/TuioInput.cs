@@ -6,6 +6,10 @@
 #if UNITY_EDITOR || UNITY_STANDALONE || UNITY_IOS || UNITY_ANDROID
 using System;
 using System.Collections.Generic;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+using System.Runtime.InteropServices;
+using TouchScript.InputSources.InputHandlers;
+#endif
 using TouchScript.Pointers;
 using TouchScript.Utils;
 using TUIOsharp;
@@ -18,6 +22,10 @@ namespace TouchScript.InputSources
     /// <summary>
     /// Processes TUIO 1.1 input.
     /// </summary>
+    /// <remarks>
+    /// On Windows the native receiver in WindowsTouch.dll can be used instead of TUIOsharp, see <see cref="NativeReceiver"/>.
+    /// It also understands TUIO 2.0.
+    /// </remarks>
     [AddComponentMenu("TouchScript/Input Sources/TUIO Input")]
     [HelpURL("http://touchscript.github.io/docs/html/T_TouchScript_InputSources_TuioInput.htm")]
     public sealed class TuioInput : InputSource
@@ -46,6 +54,22 @@ namespace TouchScript.InputSources
             Objects = 1 << 2
         }
 
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+        // Must match TUIO_* constants in WindowsTouch.h.
+        private const int NATIVE_ANGLE_SCALE = 100;
+        private const int NATIVE_SIZE_SCALE = 10000;
+        private const int NATIVE_MAX_SLOTS = 256;
+        private const int NATIVE_BUFFER_SIZE = 256;
+
+        private const uint NATIVE_EVENT_DOWN = 0x0246;
+        private const uint NATIVE_EVENT_UPDATE = 0x0245;
+        private const uint NATIVE_EVENT_UP = 0x0247;
+
+        private const uint NATIVE_KIND_CURSOR = 0;
+        private const uint NATIVE_KIND_OBJECT = 1;
+        private const uint NATIVE_KIND_BLOB = 2;
+#endif
+
         #endregion
 
         #region Public properties
@@ -78,6 +102,24 @@ namespace TouchScript.InputSources
             }
         }
 
+        /// <summary>
+        /// Should datagrams be received and decoded by WindowsTouch.dll on its own thread. Only available in Windows standalone builds.
+        /// </summary>
+        /// <remarks>
+        /// Events are read once per frame without allocations or locks. Only one TuioInput can use the native receiver at a time.
+        /// If the receiver fails to start TUIOsharp is used.
+        /// </remarks>
+        public bool NativeReceiver
+        {
+            get { return nativeReceiver; }
+            set
+            {
+                if (nativeReceiver == value) return;
+                nativeReceiver = value;
+                connect();
+            }
+        }
+
         #endregion
 
         #region Private variables
@@ -88,6 +130,9 @@ namespace TouchScript.InputSources
         [SerializeField]
         private InputType supportedInputs = InputType.Cursors | InputType.Blobs | InputType.Objects;
 
+        [SerializeField]
+        private bool nativeReceiver = false;
+
         private TuioServer server;
         private CursorProcessor cursorProcessor;
         private ObjectProcessor objectProcessor;
@@ -102,6 +147,13 @@ namespace TouchScript.InputSources
         private ObjectPool<TouchPointer> touchPool;
         private ObjectPool<ObjectPointer> objectPool;
 
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+        private bool nativeConnected;
+        private NativePackedEvent[] nativeEvents;
+        // Pointers of native sessions by slot.
+        private Pointer[] nativePointers = new Pointer[NATIVE_MAX_SLOTS];
+#endif
+
         #endregion
 
         #region Constructor
@@ -124,6 +176,10 @@ namespace TouchScript.InputSources
             screenWidth = Screen.width;
             screenHeight = Screen.height;
 
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (nativeConnected) updateNative();
+#endif
+
             return true;
         }
 
@@ -131,6 +187,9 @@ namespace TouchScript.InputSources
         public override bool CancelPointer(Pointer pointer, bool shouldReturn)
         {
             base.CancelPointer(pointer, shouldReturn);
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (nativeConnected) return cancelNativePointer(pointer, shouldReturn);
+#endif
             lock (this)
             {
                 if (pointer.Type == Pointer.PointerType.Touch)
@@ -313,7 +372,24 @@ namespace TouchScript.InputSources
         private void connect()
         {
             if (!Application.isPlaying) return;
-            if (server != null) disconnect();
+            disconnect();
+
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (nativeReceiver)
+            {
+                if (GetEventFormat() != NativePackedEvent.FORMAT)
+                {
+                    Debug.LogWarning("[TouchScript] WindowsTouch.dll stores events in a different format, using TUIOsharp instead.");
+                }
+                else
+                {
+                    if (nativeEvents == null) nativeEvents = new NativePackedEvent[NATIVE_BUFFER_SIZE];
+                    nativeConnected = StartTuio(TuioPort);
+                    if (nativeConnected) return;
+                    Debug.LogWarning("[TouchScript] Failed to start the native TUIO receiver, using TUIOsharp instead.");
+                }
+            }
+#endif
 
             server = new TuioServer(TuioPort);
             server.Connect();
@@ -329,6 +405,20 @@ namespace TouchScript.InputSources
                 server = null;
             }
 
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (nativeConnected)
+            {
+                StopTuio();
+                nativeConnected = false;
+            }
+            for (var i = 0; i < nativePointers.Length; i++)
+            {
+                if (nativePointers[i] == null) continue;
+                cancelPointer(nativePointers[i]);
+                nativePointers[i] = null;
+            }
+#endif
+
             foreach (var i in cursorToInternalId) cancelPointer(i.Value);
             foreach (var i in blobToInternalId) cancelPointer(i.Value);
             foreach (var i in objectToInternalId) cancelPointer(i.Value);
@@ -367,6 +457,97 @@ namespace TouchScript.InputSources
             p.INTERNAL_Reset();
         }
 
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+        private void updateNative()
+        {
+            int count;
+            do
+            {
+                count = GetTuioEvents(nativeEvents, nativeEvents.Length);
+                for (var i = 0; i < count; i++) processNativeEvent(ref nativeEvents[i]);
+            } while (count == nativeEvents.Length);
+        }
+
+        private void processNativeEvent(ref NativePackedEvent record)
+        {
+            if (record.Slot < 0 || record.Slot >= NATIVE_MAX_SLOTS) return;
+
+            var kind = (uint) record.Mask;
+            switch (kind)
+            {
+                case NATIVE_KIND_CURSOR:
+                    if ((supportedInputs & InputType.Cursors) == 0) return;
+                    break;
+                case NATIVE_KIND_OBJECT:
+                    if ((supportedInputs & InputType.Objects) == 0) return;
+                    break;
+                default:
+                    if ((supportedInputs & InputType.Blobs) == 0) return;
+                    break;
+            }
+
+            var position = new Vector2(record.Position.x * screenWidth, (1 - record.Position.y) * screenHeight);
+            var pointer = nativePointers[record.Slot];
+            switch ((uint) record.Event)
+            {
+                case NATIVE_EVENT_DOWN:
+                    if (pointer != null) return;
+                    if (kind == NATIVE_KIND_CURSOR)
+                    {
+                        nativePointers[record.Slot] = internalAddTouch(position);
+                    }
+                    else
+                    {
+                        var obj = internalAddObject(position);
+                        updateNativeProperties(obj, ref record);
+                        nativePointers[record.Slot] = obj;
+                    }
+                    break;
+                case NATIVE_EVENT_UPDATE:
+                    if (pointer == null) return;
+                    pointer.Position = remapCoordinates(position);
+                    if (kind != NATIVE_KIND_CURSOR) updateNativeProperties(pointer as ObjectPointer, ref record);
+                    updatePointer(pointer);
+                    break;
+                case NATIVE_EVENT_UP:
+                    if (pointer == null) return;
+                    nativePointers[record.Slot] = null;
+                    releasePointer(pointer);
+                    removePointer(pointer);
+                    break;
+            }
+        }
+
+        private void updateNativeProperties(ObjectPointer obj, ref NativePackedEvent record)
+        {
+            obj.Angle = record.Rotation * Mathf.Deg2Rad / NATIVE_ANGLE_SCALE;
+            if (record.Mask == NATIVE_KIND_OBJECT)
+            {
+                obj.ObjectId = (int) record.Flags;
+            }
+            else
+            {
+                obj.Width = (float) record.TiltX / NATIVE_SIZE_SCALE;
+                obj.Height = (float) record.TiltY / NATIVE_SIZE_SCALE;
+            }
+        }
+
+        private bool cancelNativePointer(Pointer pointer, bool shouldReturn)
+        {
+            for (var i = 0; i < nativePointers.Length; i++)
+            {
+                if (nativePointers[i] == null || nativePointers[i].Id != pointer.Id) continue;
+
+                cancelPointer(pointer);
+                if (!shouldReturn) nativePointers[i] = null;
+                else if (pointer.Type == Pointer.PointerType.Touch) nativePointers[i] = internalReturnTouch(pointer as TouchPointer);
+                else nativePointers[i] = internalReturnObject(pointer as ObjectPointer, pointer.Position);
+                return true;
+            }
+            return false;
+        }
+#endif
+
         #endregion
 
         #region Event handlers
@@ -501,6 +682,26 @@ namespace TouchScript.InputSources
         }
 
         #endregion
+
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+
+        #region p/invoke
+
+        [DllImport("WindowsTouch", EntryPoint = "StartTuio", CallingConvention = CallingConvention.StdCall)]
+        private static extern bool StartTuio(int port);
+
+        [DllImport("WindowsTouch", EntryPoint = "StopTuio", CallingConvention = CallingConvention.StdCall)]
+        private static extern void StopTuio();
+
+        [DllImport("WindowsTouch", EntryPoint = "GetTuioEvents", CallingConvention = CallingConvention.StdCall)]
+        private static extern int GetTuioEvents([Out] NativePackedEvent[] buffer, int capacity);
+
+        [DllImport("WindowsTouch", EntryPoint = "GetEventFormat", CallingConvention = CallingConvention.StdCall)]
+        private static extern uint GetEventFormat();
+
+        #endregion
+
+#endif
     }
 }
 
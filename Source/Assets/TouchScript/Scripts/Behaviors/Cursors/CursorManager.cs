@@ -3,6 +3,7 @@
  */
 
 using System.Collections.Generic;
+using TouchScript.InputSources;
 using TouchScript.Utils;
 using TouchScript.Pointers;
 using TouchScript.Utils.Attributes;
@@ -97,6 +98,17 @@ namespace TouchScript.Behaviors.Cursors
             }
         }
 
+        /// <summary>
+        /// Gets or sets whether cursors are moved to the freshest pointer positions right before canvases are drawn.
+        /// </summary>
+        /// <value> <c>true</c> to latch positions late; otherwise, <c>false</c>. </value>
+        /// <remarks> Only Windows standalone builds with <see cref="StandardInput.WindowsPointerTable"/> turned on have fresher positions than the ones pointers got this frame. </remarks>
+        public bool LateLatch
+        {
+            get { return lateLatch; }
+            set { lateLatch = value; }
+        }
+
         #endregion
 
         #region Private variables
@@ -126,12 +138,17 @@ namespace TouchScript.Behaviors.Cursors
         [SerializeField]
         private uint cursorPixelSize = 64;
 
+        [SerializeField]
+        [ToggleLeft]
+        private bool lateLatch = false;
+
         private RectTransform rect;
         private ObjectPool<PointerCursor> mousePool;
         private ObjectPool<PointerCursor> touchPool;
         private ObjectPool<PointerCursor> penPool;
         private ObjectPool<PointerCursor> objectPool;
         private Dictionary<int, PointerCursor> cursors = new Dictionary<int, PointerCursor>(10);
+        private StandardInput standardInput;
 
 #if UNITY_5_6_OR_NEWER
 		private CustomSampler cursorSampler;
@@ -178,6 +195,7 @@ namespace TouchScript.Behaviors.Cursors
                 TouchManager.Instance.PointersUpdated += PointersUpdatedHandler;
                 TouchManager.Instance.PointersCancelled += pointersCancelledHandler;
             }
+            Canvas.willRenderCanvases += willRenderCanvasesHandler;
         }
 
         private void OnDisable()
@@ -191,6 +209,7 @@ namespace TouchScript.Behaviors.Cursors
                 TouchManager.Instance.PointersUpdated -= PointersUpdatedHandler;
                 TouchManager.Instance.PointersCancelled -= pointersCancelledHandler;
             }
+            Canvas.willRenderCanvases -= willRenderCanvasesHandler;
         }
 
         #endregion
@@ -227,6 +246,20 @@ namespace TouchScript.Behaviors.Cursors
             if (useDPI) cursorPixelSize = (uint) (cursorSize * TouchManager.Instance.DotsPerCentimeter);
         }
 
+        private StandardInput getStandardInput()
+        {
+            if (standardInput != null || TouchManager.Instance == null) return standardInput;
+
+            var inputs = TouchManager.Instance.Inputs;
+            var count = inputs.Count;
+            for (var i = 0; i < count; i++)
+            {
+                standardInput = inputs[i] as StandardInput;
+                if (standardInput != null) break;
+            }
+            return standardInput;
+        }
+
         #endregion
 
         #region Event handlers
@@ -376,6 +409,28 @@ namespace TouchScript.Behaviors.Cursors
             pointersRemovedHandler(sender, e);
         }
 
+        private void willRenderCanvasesHandler()
+        {
+            if (!lateLatch || cursors.Count == 0) return;
+            var input = getStandardInput();
+            if (input == null) return;
+
+#if UNITY_5_6_OR_NEWER
+			cursorSampler.Begin();
+#endif
+
+            input.LatchWindowsPositions();
+            foreach (var pair in cursors)
+            {
+                Vector2 position;
+                if (input.TryGetWindowsLatchedPosition(pair.Key, out position)) pair.Value.UpdatePosition(position);
+            }
+
+#if UNITY_5_6_OR_NEWER
+			cursorSampler.End();
+#endif
+        }
+
         #endregion
     }
 }
\ No newline at end of file
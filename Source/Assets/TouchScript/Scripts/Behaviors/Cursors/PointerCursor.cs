@@ -244,6 +244,15 @@ namespace TouchScript.Behaviors.Cursors
             update(pointer);
         }
 
+        /// <summary>
+        /// Moves the cursor without updating the rest of its state. Used to show positions latched right before drawing.
+        /// </summary>
+        /// <param name="position">New position.</param>
+        public void UpdatePosition(Vector2 position)
+        {
+            rect.anchoredPosition = position;
+        }
+
         /// <summary>
         /// Sets the state of the cursor.
         /// </summary>
@@ -76,6 +76,9 @@ namespace TouchScript.Clusters
         private List<Pointer> cluster2 = new List<Pointer>();
         private float minPointDistance, minPointDistanceSqr;
         private bool hasClusters = false;
+        private Vector2[] positions = new Vector2[16];
+        private int[] assignments = new int[16];
+        private Vector2[] centers = new Vector2[2];
 
         #endregion
 
@@ -210,77 +213,20 @@ namespace TouchScript.Clusters
             hasClusters = checkClusters();
             if (!hasClusters) return;
 
-            cluster1.Add(points[0]);
-            cluster2.Add(points[1]);
-
             var total = points.Count;
-            if (total == 2) return;
-
-            var oldHash1 = "";
-            var oldHash2 = "";
-            var hash1 = "#";
-            var hash2 = "#";
-
-            while (oldHash1 != hash1 || oldHash2 != hash2)
+            if (positions.Length < total)
             {
-                var center1 = ClusterUtils.Get2DCenterPosition(cluster1);
-                var center2 = ClusterUtils.Get2DCenterPosition(cluster2);
-                Pointer obj1 = null;
-                Pointer obj2 = null;
-
-                // Take most distant points from cluster1 and cluster2
-                var maxDist1 = -float.MaxValue;
-                var maxDist2 = -float.MaxValue;
-                for (var i = 0; i < total; i++)
-                {
-                    var obj = points[i];
-                    var dist = (center1 - obj.Position).sqrMagnitude;
-                    if (dist > maxDist2)
-                    {
-                        maxDist2 = dist;
-                        obj2 = obj;
-                    }
-
-                    dist = (center2 - obj.Position).sqrMagnitude;
-                    if (dist > maxDist1)
-                    {
-                        maxDist1 = dist;
-                        obj1 = obj;
-                    }
-                }
-
-                // If it is the same point it means that this point is too far away from both clusters and has to be in a separate cluster
-                if (obj1 == obj2)
-                {
-                    center1 = (center1 + center2) * .5f;
-                    center2 = obj2.Position;
-                }
-                else
-                {
-                    center1 = obj1.Position;
-                    center2 = obj2.Position;
-                }
-
-                cluster1.Clear();
-                cluster2.Clear();
-
-                for (var i = 0; i < total; i++)
-                {
-                    var obj = points[i];
-                    if ((center1 - obj.Position).sqrMagnitude < (center2 - obj.Position).sqrMagnitude)
-                    {
-                        cluster1.Add(obj);
-                    }
-                    else
-                    {
-                        cluster2.Add(obj);
-                    }
-                }
+                var capacity = Mathf.NextPowerOfTwo(total);
+                positions = new Vector2[capacity];
+                assignments = new int[capacity];
+            }
+            for (var i = 0; i < total; i++) positions[i] = points[i].Position;
 
-                oldHash1 = hash1;
-                oldHash2 = hash2;
-                hash1 = ClusterUtils.GetPointsHash(cluster1);
-                hash2 = ClusterUtils.GetPointsHash(cluster2);
+            ClusterUtils.Split2D(positions, total, assignments, centers);
+            for (var i = 0; i < total; i++)
+            {
+                if (assignments[i] == CLUSTER1) cluster1.Add(points[i]);
+                else cluster2.Add(points[i]);
             }
 
             markClean();
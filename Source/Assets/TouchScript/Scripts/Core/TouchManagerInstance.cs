@@ -244,6 +244,8 @@ namespace TouchScript.Core
             (l) => l.Clear());
 
         private int nextPointerId = 0;
+        // TUIOsharp raises its events on the socket thread, so pointer changes may come from any thread.
+        // Native Windows input is drained once per frame on the main thread, so the lock is uncontended there.
         private object pointerLock = new object();
 
 		// Cache delegates
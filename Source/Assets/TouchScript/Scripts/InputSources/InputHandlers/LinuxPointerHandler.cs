@@ -0,0 +1,303 @@
+/*
+ * @author Valentin Simonov / http://va.lent.in/
+ */
+
+#if UNITY_STANDALONE_LINUX
+
+using System.Runtime.InteropServices;
+using TouchScript.Pointers;
+using UnityEngine;
+
+namespace TouchScript.InputSources.InputHandlers
+{
+    /// <summary>
+    /// Linux touch handling implementation which can be embedded to other (input) classes. Uses libLinuxTouch.so to read multitouch screens through evdev on a native thread.
+    /// </summary>
+    /// <remarks>
+    /// <para>libLinuxTouch.so has the same exports and event records as WindowsTouch.dll. Events are always buffered and drained once per frame.</para>
+    /// <para>Touchscreens are expected to cover the display the window is fullscreen on. The user needs read access to /dev/input/event*, usually through the input group.</para>
+    /// </remarks>
+    public class LinuxPointerHandler : NativePointerHandler
+    {
+        #region Consts
+
+        /// <summary>
+        /// Number of events the native event buffer can hold between two frames.
+        /// </summary>
+        public const int EVENT_BUFFER_CAPACITY = 1024;
+
+        private const int LOG_ENTRY_LENGTH = 120;
+
+        private delegate void NativePointerDelegate(int id, int slot, uint device, uint evt, uint type, Vector2 position, PointerData data, ulong received);
+
+        #endregion
+
+        #region Private variables
+
+        // Never called in buffered mode, Init() only needs a valid delegate.
+        private NativePointerDelegate nativePointerDelegate;
+        private char[] logBuffer = new char[LOG_ENTRY_LENGTH];
+        private NativePackedEvent[] eventBuffer = new NativePackedEvent[EVENT_BUFFER_CAPACITY];
+        private bool eventFormatMatches;
+
+        #endregion
+
+        #region Constructor
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="LinuxPointerHandler"/> class.
+        /// </summary>
+        /// <param name="addPointer">A function called when a new pointer is detected.</param>
+        /// <param name="updatePointer">A function called when a pointer is moved or its parameter is updated.</param>
+        /// <param name="pressPointer">A function called when a pointer touches the surface.</param>
+        /// <param name="releasePointer">A function called when a pointer is lifted off.</param>
+        /// <param name="removePointer">A function called when a pointer is removed.</param>
+        /// <param name="cancelPointer">A function called when a pointer is cancelled.</param>
+        public LinuxPointerHandler(PointerDelegate addPointer, PointerDelegate updatePointer, PointerDelegate pressPointer, PointerDelegate releasePointer, PointerDelegate removePointer, PointerDelegate cancelPointer) : base(addPointer, updatePointer, pressPointer, releasePointer, removePointer, cancelPointer)
+        {
+            nativePointerDelegate = nativePointer;
+
+            SetLogLevel(LOG_LEVEL.LOG_WARNING);
+            Init(TOUCH_API.WIN8, nativePointerDelegate);
+            eventFormatMatches = GetEventFormat() == NativePackedEvent.FORMAT;
+            if (eventFormatMatches)
+            {
+                SetDeliveryMode(DELIVERY_MODE.DELIVERY_BUFFERED, EVENT_BUFFER_CAPACITY);
+            }
+            else
+            {
+                Debug.LogError("[TouchScript] libLinuxTouch.so stores events in a different format, touch input is disabled. Update the plugin.");
+                DisposePlugin();
+            }
+            setScaling();
+            drainLog();
+        }
+
+        #endregion
+
+        #region Public methods
+
+        /// <inheritdoc />
+        public override bool UpdateInput()
+        {
+            drainLog();
+            if (!eventFormatMatches) return false;
+
+            int count;
+            do
+            {
+                count = GetPointerEvents(eventBuffer, eventBuffer.Length);
+                for (var i = 0; i < count; i++) processPointer(ref eventBuffer[i]);
+            } while (count == eventBuffer.Length);
+
+            return touchCount > 0;
+        }
+
+        /// <inheritdoc />
+        public override void UpdateResolution()
+        {
+            setScaling();
+        }
+
+        /// <inheritdoc />
+        public override void Dispose()
+        {
+            base.Dispose();
+
+            DisposePlugin();
+            drainLog();
+        }
+
+        /// <summary>
+        /// Copies the current values of native input counters. Messages are evdev reads, frames are SYN_REPORTs with contacts.
+        /// </summary>
+        /// <param name="stats">The snapshot to fill.</param>
+        public void GetInputStats(NativeInputStats stats)
+        {
+            GetNativeInputStats(stats.Values);
+        }
+
+        /// <summary>
+        /// Resets native input counters to zero.
+        /// </summary>
+        public void ResetInputStats()
+        {
+            ResetNativeInputStats();
+        }
+
+        /// <summary>
+        /// Copies touchscreens the native plugin reads to the buffer.
+        /// </summary>
+        /// <param name="buffer">The buffer to fill.</param>
+        /// <returns>Number of devices copied.</returns>
+        public int GetDevices(NativeDeviceInfo[] buffer)
+        {
+            if (buffer == null || buffer.Length == 0) return 0;
+            return GetNativeDevices(buffer, buffer.Length);
+        }
+
+        #endregion
+
+        #region Private functions
+
+        private void processPointer(ref NativePackedEvent record)
+        {
+            // All slots were taken when this pointer appeared.
+            var slot = record.Slot;
+            if (slot < 0 || slot >= MAX_POINTER_SLOTS) return;
+
+            TouchPointer touchPointer;
+            switch ((PointerEvent) record.Event)
+            {
+                case PointerEvent.Down:
+                    touchPointer = beginTouch(slot, record.Position, record.Device);
+                    updateTouch(touchPointer, ref record);
+                    break;
+                case PointerEvent.Update:
+                    touchPointer = touchSlots[slot];
+                    if (touchPointer == null) return;
+                    touchPointer.Position = remapCoordinates(record.Position, touchPointer.DeviceIndex);
+                    updateTouch(touchPointer, ref record);
+                    updatePointer(touchPointer);
+                    break;
+                case PointerEvent.Up:
+                    endTouch(slot);
+                    break;
+            }
+        }
+
+        private void updateTouch(TouchPointer pointer, ref NativePackedEvent record)
+        {
+            pointer.Pressure = (record.Mask & TOUCH_MASK_PRESSURE) != 0 ? record.Pressure / 1024f : TouchPointer.DEFAULT_PRESSURE;
+            pointer.Rotation = (record.Mask & TOUCH_MASK_ORIENTATION) != 0 ? record.Rotation / 180f * Mathf.PI : TouchPointer.DEFAULT_ROTATION;
+        }
+
+        // Same parameters WindowsPointerHandler sends, the plugin derives the display size from them.
+        private void setScaling()
+        {
+            var screenWidth = Screen.width;
+            var screenHeight = Screen.height;
+
+            if (!Screen.fullScreen)
+            {
+                SetScreenParams(screenWidth, screenHeight, 0, 0, 1, 1);
+                return;
+            }
+
+            var resolution = Screen.currentResolution;
+            float scale = Mathf.Max(screenWidth / ((float) resolution.width), screenHeight / ((float) resolution.height));
+            SetScreenParams(screenWidth, screenHeight, (resolution.width - screenWidth / scale) * .5f, (resolution.height - screenHeight / scale) * .5f, scale, scale);
+        }
+
+        private void drainLog()
+        {
+            LOG_LEVEL level;
+            int length;
+            while ((length = GetLogEntry(out level, logBuffer, logBuffer.Length)) >= 0)
+            {
+                var message = "[libLinuxTouch.so]: " + new string(logBuffer, 0, length);
+                switch (level)
+                {
+                    case LOG_LEVEL.LOG_WARNING:
+                        Debug.LogWarning(message);
+                        break;
+                    case LOG_LEVEL.LOG_ERROR:
+                        Debug.LogError(message);
+                        break;
+                    default:
+                        Debug.Log(message);
+                        break;
+                }
+            }
+        }
+
+        private void nativePointer(int id, int slot, uint device, uint evt, uint type, Vector2 position, PointerData data, ulong received) {}
+
+        #endregion
+
+        #region p/invoke
+
+        // Must match LinuxTouch.h, which keeps the values of WindowsTouch.h.
+        private enum TOUCH_API
+        {
+            WIN7,
+            WIN8,
+            RAW
+        }
+
+        private enum DELIVERY_MODE
+        {
+            DELIVERY_CALLBACK,
+            DELIVERY_BUFFERED
+        }
+
+        private enum LOG_LEVEL
+        {
+            LOG_DEBUG,
+            LOG_INFO,
+            LOG_WARNING,
+            LOG_ERROR,
+            LOG_NONE
+        }
+
+        private enum PointerEvent : uint
+        {
+            Update = 0x0245,
+            Down = 0x0246,
+            Up = 0x0247
+        }
+
+        private const uint TOUCH_MASK_ORIENTATION = 0x00000002;
+        private const uint TOUCH_MASK_PRESSURE = 0x00000004;
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct PointerData
+        {
+            public uint PointerFlags;
+            public uint Flags;
+            public uint Mask;
+            public uint ChangedButtons;
+            public uint Rotation;
+            public uint Pressure;
+            public int TiltX;
+            public int TiltY;
+        }
+
+        [DllImport("LinuxTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern void Init(TOUCH_API api, NativePointerDelegate pointerDelegate);
+
+        [DllImport("LinuxTouch", EntryPoint = "Dispose", CallingConvention = CallingConvention.StdCall)]
+        private static extern void DisposePlugin();
+
+        [DllImport("LinuxTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetScreenParams(int width, int height, float offsetX, float offsetY, float scaleX, float scaleY);
+
+        [DllImport("LinuxTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetDeliveryMode(DELIVERY_MODE mode, int capacity);
+
+        [DllImport("LinuxTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern int GetPointerEvents([Out] NativePackedEvent[] buffer, int capacity);
+
+        [DllImport("LinuxTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern uint GetEventFormat();
+
+        [DllImport("LinuxTouch", EntryPoint = "GetDevices", CallingConvention = CallingConvention.StdCall)]
+        private static extern int GetNativeDevices([Out] NativeDeviceInfo[] buffer, int capacity);
+
+        [DllImport("LinuxTouch", EntryPoint = "GetInputStats", CallingConvention = CallingConvention.StdCall)]
+        private static extern void GetNativeInputStats([Out] long[] stats);
+
+        [DllImport("LinuxTouch", EntryPoint = "ResetInputStats", CallingConvention = CallingConvention.StdCall)]
+        private static extern void ResetNativeInputStats();
+
+        [DllImport("LinuxTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetLogLevel(LOG_LEVEL level);
+
+        [DllImport("LinuxTouch", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.StdCall)]
+        private static extern int GetLogEntry(out LOG_LEVEL level, [Out] char[] text, int capacity);
+
+        #endregion
+    }
+}
+
+#endif
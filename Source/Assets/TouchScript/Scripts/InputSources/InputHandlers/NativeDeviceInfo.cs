@@ -0,0 +1,71 @@
+/*
+ * @author Valentin Simonov / http://va.lent.in/
+ */
+
+using System.Runtime.InteropServices;
+
+namespace TouchScript.InputSources.InputHandlers
+{
+    /// <summary>
+    /// Pointer device reported by WindowsTouch.dll or libLinuxTouch.so.
+    /// </summary>
+    /// <remarks>Layout must match DeviceInfo in WindowsTouch.h and LinuxTouch.h.</remarks>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct NativeDeviceInfo
+    {
+        /// <summary>
+        /// Kind of a pointer device, matches POINTER_DEVICE_TYPE. <see cref="Mouse"/> is not a Windows value, mice are told apart by raw input when mouse in pointer is on.
+        /// </summary>
+        public enum DeviceType
+        {
+            Unknown = 0,
+            IntegratedPen = 1,
+            ExternalPen = 2,
+            Touch = 3,
+            TouchPad = 4,
+            Mouse = 0x100
+        }
+
+        /// <summary>
+        /// A rectangle in screen pixels.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        public struct ScreenRect
+        {
+            public int Left;
+            public int Top;
+            public int Right;
+            public int Bottom;
+        }
+
+        /// <summary>
+        /// Device index, the <see cref="TouchScript.Pointers.Pointer.DeviceIndex"/> of pointers from this device.
+        /// </summary>
+        public uint Index;
+
+        /// <summary>
+        /// Kind of the device.
+        /// </summary>
+        public DeviceType Type;
+
+        /// <summary>
+        /// Maximum number of simultaneous contacts, 0 if unknown.
+        /// </summary>
+        public uint MaxContacts;
+
+        /// <summary>
+        /// Index of the monitor the device is attached to in system order, -1 if unknown.
+        /// </summary>
+        public int Monitor;
+
+        /// <summary>
+        /// Screen area the device maps to.
+        /// </summary>
+        public ScreenRect DisplayRect;
+
+        /// <summary>
+        /// Screen area of the monitor the device is attached to.
+        /// </summary>
+        public ScreenRect MonitorRect;
+    }
+}
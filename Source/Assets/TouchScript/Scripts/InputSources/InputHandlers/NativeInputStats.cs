@@ -0,0 +1,170 @@
+/*
+ * @author Valentin Simonov / http://va.lent.in/
+ */
+
+namespace TouchScript.InputSources.InputHandlers
+{
+    /// <summary>
+    /// Snapshot of the counters WindowsTouch.dll or libLinuxTouch.so keeps for its input path.
+    /// </summary>
+    /// <remarks>
+    /// <para>All counters are cumulative since the input was initialized or the counters were reset.</para>
+    /// <para>Layout of <see cref="Values"/> must match InputStats in InputStats.h.</para>
+    /// </remarks>
+    public sealed class NativeInputStats
+    {
+        #region Consts
+
+        /// <summary>
+        /// Number of decode time buckets, bucket i counts messages decoded in less than 2^(i+1) microseconds.
+        /// </summary>
+        public const int DECODE_TIME_BUCKETS = 16;
+
+        internal const int LENGTH = DECODE_TIME + DECODE_TIME_BUCKETS;
+
+        private const int MESSAGES = 0;
+        private const int EVENTS = 1;
+        private const int FRAMES = EVENTS + 6;
+        private const int FRAME_CONTACTS = FRAMES + 1;
+        private const int MAX_FRAME_CONTACTS = FRAMES + 2;
+        private const int COALESCED = FRAMES + 3;
+        private const int SUPPRESSED = FRAMES + 4;
+        private const int RING_HIGH_WATER = FRAMES + 5;
+        private const int RING_DROPPED = FRAMES + 6;
+        private const int DECODE_TIME = FRAMES + 7;
+
+        // POINTER_INPUT_TYPE
+        private const int TYPE_TOUCH = 2;
+        private const int TYPE_PEN = 3;
+        private const int TYPE_MOUSE = 4;
+        private const int TYPE_TOUCHPAD = 5;
+
+        #endregion
+
+        #region Public properties
+
+        /// <summary>
+        /// Pointer messages handled by the native window proc.
+        /// </summary>
+        public long Messages
+        {
+            get { return Values[MESSAGES]; }
+        }
+
+        /// <summary>
+        /// Delivered touch events.
+        /// </summary>
+        public long TouchEvents
+        {
+            get { return Values[EVENTS + TYPE_TOUCH]; }
+        }
+
+        /// <summary>
+        /// Delivered pen events.
+        /// </summary>
+        public long PenEvents
+        {
+            get { return Values[EVENTS + TYPE_PEN]; }
+        }
+
+        /// <summary>
+        /// Delivered mouse events.
+        /// </summary>
+        public long MouseEvents
+        {
+            get { return Values[EVENTS + TYPE_MOUSE]; }
+        }
+
+        /// <summary>
+        /// Delivered touchpad events.
+        /// </summary>
+        public long TouchpadEvents
+        {
+            get { return Values[EVENTS + TYPE_TOUCHPAD]; }
+        }
+
+        /// <summary>
+        /// Decoded input frames. A frame is every contact a device reported at once.
+        /// </summary>
+        public long Frames
+        {
+            get { return Values[FRAMES]; }
+        }
+
+        /// <summary>
+        /// Average number of contacts in a frame.
+        /// </summary>
+        public float AverageContactsPerFrame
+        {
+            get
+            {
+                var frames = Values[FRAMES];
+                if (frames == 0) return 0;
+                return (float) Values[FRAME_CONTACTS] / frames;
+            }
+        }
+
+        /// <summary>
+        /// Largest number of contacts in a frame.
+        /// </summary>
+        public long MaxContactsPerFrame
+        {
+            get { return Values[MAX_FRAME_CONTACTS]; }
+        }
+
+        /// <summary>
+        /// Updates merged into later updates of the same pointer.
+        /// </summary>
+        public long Coalesced
+        {
+            get { return Values[COALESCED]; }
+        }
+
+        /// <summary>
+        /// Events dropped by stationary and palm filters.
+        /// </summary>
+        public long Suppressed
+        {
+            get { return Values[SUPPRESSED]; }
+        }
+
+        /// <summary>
+        /// Most events ever waiting in the native event buffer.
+        /// </summary>
+        public long RingHighWater
+        {
+            get { return Values[RING_HIGH_WATER]; }
+        }
+
+        /// <summary>
+        /// Events lost because the native event buffer was full.
+        /// </summary>
+        public long RingDropped
+        {
+            get { return Values[RING_DROPPED]; }
+        }
+
+        #endregion
+
+        #region Internal variables
+
+        internal readonly long[] Values = new long[LENGTH];
+
+        #endregion
+
+        #region Public methods
+
+        /// <summary>
+        /// Returns the number of messages in a decode time bucket.
+        /// </summary>
+        /// <param name="bucket">Bucket index, bucket i counts messages decoded in less than 2^(i+1) microseconds.</param>
+        /// <returns>Number of messages.</returns>
+        public long GetDecodeTimeCount(int bucket)
+        {
+            if (bucket < 0 || bucket >= DECODE_TIME_BUCKETS) return 0;
+            return Values[DECODE_TIME + bucket];
+        }
+
+        #endregion
+    }
+}
@@ -0,0 +1,50 @@
+/*
+ * @author Valentin Simonov / http://va.lent.in/
+ */
+
+using System.Runtime.InteropServices;
+using UnityEngine;
+
+namespace TouchScript.InputSources.InputHandlers
+{
+    /// <summary>
+    /// Pointer event as WindowsTouch.dll and libLinuxTouch.so store it in their event buffers.
+    /// </summary>
+    /// <remarks>
+    /// <para>Layout must match PackedEvent in PackedEvent.h, arrays of it are copied from native buffers as they are.</para>
+    /// <para>Check GetEventFormat() of the plugin against <see cref="FORMAT"/> before reading any events.</para>
+    /// </remarks>
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct NativePackedEvent
+    {
+        /// <summary>
+        /// Version of the layout in the high and its size in the low 16 bits, must match PACKED_EVENT_FORMAT in PackedEvent.h.
+        /// </summary>
+        public const uint FORMAT = (1 << 16) | 48;
+
+        public ulong Timestamp;
+        public Vector2 Position;
+        public int Id;
+        public uint PointerFlags;
+        public uint Flags;
+        public uint ReceivedDelta;
+        public ushort Event;
+        public byte Type;
+        public byte Device;
+        public short Slot;
+        public ushort Pressure;
+        public ushort Rotation;
+        public short TiltX;
+        public short TiltY;
+        public byte Mask;
+        public byte ChangedButtons;
+
+        /// <summary>
+        /// When the plugin received the event, in the same units as <see cref="Timestamp"/>.
+        /// </summary>
+        public ulong Received
+        {
+            get { return Timestamp + ReceivedDelta; }
+        }
+    }
+}
@@ -0,0 +1,245 @@
+/*
+ * @author Valentin Simonov / http://va.lent.in/
+ */
+
+#if UNITY_STANDALONE_WIN || UNITY_STANDALONE_LINUX
+
+using System;
+using TouchScript.Pointers;
+using TouchScript.Utils;
+using UnityEngine;
+
+namespace TouchScript.InputSources.InputHandlers
+{
+    /// <summary>
+    /// Base class for input handlers of native plugins which assign every active pointer a dense slot, WindowsTouch.dll and libLinuxTouch.so.
+    /// </summary>
+    /// <remarks>Keeps touches by slot, the touch pool and per device remappers. Derived classes decode plugin events and move touches with <see cref="beginTouch"/>, <see cref="endTouch"/> and <see cref="cancelTouch"/>.</remarks>
+    public abstract class NativePointerHandler : IInputSource, IDisposable
+    {
+        #region Consts
+
+        /// <summary>
+        /// Maximum number of devices the native plugin tells apart, devices beyond it share the last index.
+        /// </summary>
+        protected const int MAX_DEVICES = 16;
+
+        /// <summary>
+        /// Number of slots the native plugin assigns, pointers which appear when all of them are taken get slot -1.
+        /// </summary>
+        protected const int MAX_POINTER_SLOTS = 256;
+
+        #endregion
+
+        #region Public properties
+
+        /// <inheritdoc />
+        public ICoordinatesRemapper CoordinatesRemapper { get; set; }
+
+        #endregion
+
+        #region Private variables
+
+        private ICoordinatesRemapper[] deviceRemappers = new ICoordinatesRemapper[MAX_DEVICES];
+
+        protected PointerDelegate addPointer;
+        protected PointerDelegate updatePointer;
+        protected PointerDelegate pressPointer;
+        protected PointerDelegate releasePointer;
+        protected PointerDelegate removePointer;
+        protected PointerDelegate cancelPointer;
+
+        protected ObjectPool<TouchPointer> touchPool;
+        // Touches indexed by the dense slot the native plugin assigns to every active pointer.
+        protected TouchPointer[] touchSlots = new TouchPointer[MAX_POINTER_SLOTS];
+        protected int touchCount;
+
+        #endregion
+
+        #region Constructor
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="NativePointerHandler"/> class.
+        /// </summary>
+        /// <param name="addPointer">A function called when a new pointer is detected.</param>
+        /// <param name="updatePointer">A function called when a pointer is moved or its parameter is updated.</param>
+        /// <param name="pressPointer">A function called when a pointer touches the surface.</param>
+        /// <param name="releasePointer">A function called when a pointer is lifted off.</param>
+        /// <param name="removePointer">A function called when a pointer is removed.</param>
+        /// <param name="cancelPointer">A function called when a pointer is cancelled.</param>
+        protected NativePointerHandler(PointerDelegate addPointer, PointerDelegate updatePointer, PointerDelegate pressPointer, PointerDelegate releasePointer, PointerDelegate removePointer, PointerDelegate cancelPointer)
+        {
+            this.addPointer = addPointer;
+            this.updatePointer = updatePointer;
+            this.pressPointer = pressPointer;
+            this.releasePointer = releasePointer;
+            this.removePointer = removePointer;
+            this.cancelPointer = cancelPointer;
+
+            touchPool = new ObjectPool<TouchPointer>(10, () => new TouchPointer(this), null, resetPointer);
+        }
+
+        #endregion
+
+        #region Public methods
+
+        /// <inheritdoc />
+        public abstract bool UpdateInput();
+
+        /// <inheritdoc />
+        public abstract void UpdateResolution();
+
+        /// <inheritdoc />
+        public virtual bool CancelPointer(Pointer pointer, bool shouldReturn)
+        {
+            var touch = pointer as TouchPointer;
+            if (touch == null) return false;
+
+            var slot = Array.IndexOf(touchSlots, touch);
+            if (slot < 0) return false;
+
+            cancelPointer(touch);
+            touchSlots[slot] = null;
+            touchCount--;
+            if (shouldReturn) setTouchSlot(slot, internalReturnTouchPointer(touch));
+            return true;
+        }
+
+        /// <summary>
+        /// Releases resources.
+        /// </summary>
+        public virtual void Dispose()
+        {
+            for (var i = 0; i < touchSlots.Length; i++)
+            {
+                if (touchSlots[i] == null) continue;
+                cancelPointer(touchSlots[i]);
+                touchSlots[i] = null;
+            }
+            touchCount = 0;
+        }
+
+        /// <summary>
+        /// Sets a remapper used instead of <see cref="CoordinatesRemapper"/> for pointers of one device, for example to map every screen to its own part of the scene.
+        /// </summary>
+        /// <param name="device">Index of the device, the <see cref="NativeDeviceInfo.Index"/> of its pointers.</param>
+        /// <param name="remapper">The remapper or <c>null</c> to use <see cref="CoordinatesRemapper"/>.</param>
+        public void SetDeviceCoordinatesRemapper(uint device, ICoordinatesRemapper remapper)
+        {
+            if (device >= MAX_DEVICES) return;
+            deviceRemappers[device] = remapper;
+        }
+
+        #endregion
+
+        #region Internal methods
+
+        /// <inheritdoc />
+        public virtual void INTERNAL_DiscardPointer(Pointer pointer)
+        {
+            var p = pointer as TouchPointer;
+            if (p == null) return;
+
+            touchPool.Release(p);
+        }
+
+        #endregion
+
+        #region Protected methods
+
+        /// <summary>
+        /// Adds and presses a touch in a slot, a touch the plugin didn't end in this slot is removed first.
+        /// </summary>
+        protected TouchPointer beginTouch(int slot, Vector2 position, uint device)
+        {
+            endTouch(slot);
+            var touchPointer = internalAddTouchPointer(position, device);
+            setTouchSlot(slot, touchPointer);
+            return touchPointer;
+        }
+
+        /// <summary>
+        /// Releases and removes the touch in a slot if there is one.
+        /// </summary>
+        protected void endTouch(int slot)
+        {
+            var touchPointer = clearTouchSlot(slot);
+            if (touchPointer != null) internalRemoveTouchPointer(touchPointer);
+        }
+
+        /// <summary>
+        /// Cancels the touch in a slot if there is one.
+        /// </summary>
+        protected void cancelTouch(int slot)
+        {
+            var touchPointer = clearTouchSlot(slot);
+            if (touchPointer != null) cancelPointer(touchPointer);
+        }
+
+        protected TouchPointer internalAddTouchPointer(Vector2 position, uint device = 0)
+        {
+            var pointer = touchPool.Get();
+            pointer.DeviceIndex = device;
+            pointer.Position = remapCoordinates(position, device);
+            pointer.Buttons |= Pointer.PointerButtonState.FirstButtonDown | Pointer.PointerButtonState.FirstButtonPressed;
+            addPointer(pointer);
+            pressPointer(pointer);
+            return pointer;
+        }
+
+        protected TouchPointer internalReturnTouchPointer(TouchPointer pointer)
+        {
+            var newPointer = touchPool.Get();
+            newPointer.CopyFrom(pointer);
+            newPointer.Buttons |= Pointer.PointerButtonState.FirstButtonDown | Pointer.PointerButtonState.FirstButtonPressed;
+            newPointer.Flags |= Pointer.FLAG_RETURNED;
+            addPointer(newPointer);
+            pressPointer(newPointer);
+            return newPointer;
+        }
+
+        protected void internalRemoveTouchPointer(TouchPointer pointer)
+        {
+            pointer.Buttons &= ~Pointer.PointerButtonState.FirstButtonPressed;
+            pointer.Buttons |= Pointer.PointerButtonState.FirstButtonUp;
+            releasePointer(pointer);
+            removePointer(pointer);
+        }
+
+        protected void setTouchSlot(int slot, TouchPointer touchPointer)
+        {
+            if (touchSlots[slot] == null) touchCount++;
+            touchSlots[slot] = touchPointer;
+        }
+
+        protected TouchPointer clearTouchSlot(int slot)
+        {
+            var touchPointer = touchSlots[slot];
+            if (touchPointer == null) return null;
+            touchSlots[slot] = null;
+            touchCount--;
+            return touchPointer;
+        }
+
+        protected Vector2 remapCoordinates(Vector2 position)
+        {
+            if (CoordinatesRemapper != null) return CoordinatesRemapper.Remap(position);
+            return position;
+        }
+
+        protected Vector2 remapCoordinates(Vector2 position, uint device)
+        {
+            if (device < MAX_DEVICES && deviceRemappers[device] != null) return deviceRemappers[device].Remap(position);
+            return remapCoordinates(position);
+        }
+
+        protected void resetPointer(Pointer p)
+        {
+            p.INTERNAL_Reset();
+        }
+
+        #endregion
+    }
+}
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * @author Valentin Simonov / http://va.lent.in/
+ */
+
+using System.Runtime.InteropServices;
+using UnityEngine;
+
+namespace TouchScript.InputSources.InputHandlers
+{
+    /// <summary>
+    /// Shape of a group of active touches computed by WindowsTouch.dll, in screen coordinates.
+    /// </summary>
+    /// <remarks>Layout must match ContactAggregate in ContactSet.h.</remarks>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct WindowsContactAggregate
+    {
+        /// <summary>
+        /// <see cref="Device"/> value of the aggregate of all touches.
+        /// </summary>
+        public const uint ALL_DEVICES = 0xFFFFFFFF;
+
+        /// <summary>
+        /// Index of the touch device or <see cref="ALL_DEVICES"/>.
+        /// </summary>
+        public uint Device;
+
+        /// <summary>
+        /// Number of touches.
+        /// </summary>
+        public int Count;
+
+        /// <summary>
+        /// Average position of the touches.
+        /// </summary>
+        public Vector2 Centroid;
+
+        /// <summary>
+        /// Minimum corner of the bounding box.
+        /// </summary>
+        public Vector2 Min;
+
+        /// <summary>
+        /// Maximum corner of the bounding box.
+        /// </summary>
+        public Vector2 Max;
+
+        /// <summary>
+        /// Mean distance between all pairs of touches.
+        /// </summary>
+        public float MeanDistance;
+
+        /// <summary>
+        /// Direction of the principal axis of the touches in radians, from -PI/2 to PI/2.
+        /// </summary>
+        public float Angle;
+    }
+}
@@ -24,15 +24,14 @@ namespace TouchScript.InputSources.InputHandlers
         #region Public properties
 
         /// <summary>
-        /// Should the primary pointer also dispatch a mouse pointer.
+        /// Should mouse input arrive as pointer messages. Every mouse then has its own mouse pointer and device index.
         /// </summary>
         public bool MouseInPointer
         {
             get { return mouseInPointer; }
             set
             {
-                WindowsUtils.EnableMouseInPointer(value);
-                mouseInPointer = value;
+                mouseInPointer = setMouseInPointer(value);
                 if (mouseInPointer)
                 {
                     if (mousePointer == null) mousePointer = internalAddMousePointer(Vector3.zero);
@@ -41,17 +40,38 @@ namespace TouchScript.InputSources.InputHandlers
                 {
                     if (mousePointer != null)
                     {
-                        if ((mousePointer.Buttons & Pointer.PointerButtonState.AnyButtonPressed) != 0)
-                        {
-                            mousePointer.Buttons = PointerUtils.UpPressedButtons(mousePointer.Buttons);
-                            releasePointer(mousePointer);
-                        }
-                        removePointer(mousePointer);
+                        removeMousePointer(mousePointer);
+                        mousePointer = null;
                     }
+                    for (var i = 0; i < otherMice.Length; i++)
+                    {
+                        if (otherMice[i] == null) continue;
+                        removeMousePointer(otherMice[i]);
+                        otherMice[i] = null;
+                    }
+                    mouseDevice = NO_DEVICE;
                 }
             }
         }
 
+        /// <summary>
+        /// Should the native plugin read all contacts of a digitizer frame at once and skip the rest of the messages belonging to this frame.
+        /// </summary>
+        public bool FrameDecoding
+        {
+            get { return getPluginOption(PLUGIN_OPTIONS.OPTION_FRAME_DECODE); }
+            set { setPluginOption(PLUGIN_OPTIONS.OPTION_FRAME_DECODE, value); }
+        }
+
+        /// <summary>
+        /// Should the native plugin send all samples Windows coalesced into one update instead of only the latest one. Works best with <see cref="WindowsPointerHandler.BufferedInput"/>.
+        /// </summary>
+        public bool PointerHistory
+        {
+            get { return getPluginOption(PLUGIN_OPTIONS.OPTION_HISTORY); }
+            set { setPluginOption(PLUGIN_OPTIONS.OPTION_HISTORY, value); }
+        }
+
         #endregion
 
         #region Private variables
@@ -91,7 +111,16 @@ namespace TouchScript.InputSources.InputHandlers
             {
                 cancelPointer(mousePointer);
                 if (shouldReturn) mousePointer = internalReturnMousePointer(mousePointer);
-                else mousePointer = internalAddMousePointer(pointer.Position); // can't totally cancel mouse pointer
+                else mousePointer = internalAddMousePointer(pointer.Position, pointer.DeviceIndex); // can't totally cancel mouse pointer
+                return true;
+            }
+            var mouse = pointer as MousePointer;
+            var device = mouse == null ? -1 : Array.IndexOf(otherMice, mouse);
+            if (device >= 0)
+            {
+                cancelPointer(mouse);
+                if (shouldReturn) otherMice[device] = internalReturnMousePointer(mouse);
+                else otherMice[device] = internalAddMousePointer(mouse.Position, mouse.DeviceIndex);
                 return true;
             }
             if (pointer.Equals(penPointer))
@@ -111,14 +140,19 @@ namespace TouchScript.InputSources.InputHandlers
                 cancelPointer(mousePointer);
                 mousePointer = null;
             }
+            for (var i = 0; i < otherMice.Length; i++)
+            {
+                if (otherMice[i] == null) continue;
+                cancelPointer(otherMice[i]);
+                otherMice[i] = null;
+            }
             if (penPointer != null)
             {
                 cancelPointer(penPointer);
                 penPointer = null;
             }
 
-            WindowsUtils.EnableMouseInPointer(false);
-
+            // The plugin turns mouse in pointer off.
             base.Dispose();
         }
 
@@ -135,14 +169,35 @@ namespace TouchScript.InputSources.InputHandlers
         }
 
         #endregion
+
+        #region Private functions
+
+        private void removeMousePointer(MousePointer pointer)
+        {
+            if ((pointer.Buttons & Pointer.PointerButtonState.AnyButtonPressed) != 0)
+            {
+                pointer.Buttons = PointerUtils.UpPressedButtons(pointer.Buttons);
+                releasePointer(pointer);
+            }
+            removePointer(pointer);
+        }
+
+        #endregion
     }
 
     public class Windows7PointerHandler : WindowsPointerHandler
     {
         /// <inheritdoc />
-        public Windows7PointerHandler(PointerDelegate addPointer, PointerDelegate updatePointer, PointerDelegate pressPointer, PointerDelegate releasePointer, PointerDelegate removePointer, PointerDelegate cancelPointer) : base(addPointer, updatePointer, pressPointer, releasePointer, removePointer, cancelPointer)
+        public Windows7PointerHandler(PointerDelegate addPointer, PointerDelegate updatePointer, PointerDelegate pressPointer, PointerDelegate releasePointer, PointerDelegate removePointer, PointerDelegate cancelPointer) : this(addPointer, updatePointer, pressPointer, releasePointer, removePointer, cancelPointer, TOUCH_API.WIN7)
         {
-            init(TOUCH_API.WIN7);
+        }
+
+        /// <summary>
+        /// Initializes a touch only handler with the specified native API.
+        /// </summary>
+        protected Windows7PointerHandler(PointerDelegate addPointer, PointerDelegate updatePointer, PointerDelegate pressPointer, PointerDelegate releasePointer, PointerDelegate removePointer, PointerDelegate cancelPointer, TOUCH_API api) : base(addPointer, updatePointer, pressPointer, releasePointer, removePointer, cancelPointer)
+        {
+            init(api);
         }
 
         #region Public methods
@@ -151,16 +206,28 @@ namespace TouchScript.InputSources.InputHandlers
         public override bool UpdateInput()
         {
             base.UpdateInput();
-            return winTouchToInternalId.Count > 0;
+            return touchCount > 0;
         }
 
         #endregion
     }
 
+    /// <summary>
+    /// Touch handler which reads HID multitouch digitizer reports through raw input instead of WM_TOUCH or WM_POINTER messages.
+    /// Contacts go around Windows gesture processing and arrive at the digitizer's report rate.
+    /// </summary>
+    public class WindowsRawPointerHandler : Windows7PointerHandler
+    {
+        /// <inheritdoc />
+        public WindowsRawPointerHandler(PointerDelegate addPointer, PointerDelegate updatePointer, PointerDelegate pressPointer, PointerDelegate releasePointer, PointerDelegate removePointer, PointerDelegate cancelPointer) : base(addPointer, updatePointer, pressPointer, releasePointer, removePointer, cancelPointer, TOUCH_API.RAW)
+        {
+        }
+    }
+
     /// <summary>
     /// Base class for Windows 8 and Windows 7 input handlers.
     /// </summary>
-    public abstract class WindowsPointerHandler : IInputSource, IDisposable
+    public abstract class WindowsPointerHandler : NativePointerHandler
     {
         #region Consts
 
@@ -169,51 +236,319 @@ namespace TouchScript.InputSources.InputHandlers
         /// </summary>
         public const string PRESS_AND_HOLD_ATOM = "MicrosoftTabletPenServiceProperty";
 
+        /// <summary>
+        /// Number of events the native event buffer can hold between two frames in buffered mode.
+        /// </summary>
+        public const int EVENT_BUFFER_CAPACITY = 1024;
+
+        /// <summary>
+        /// Device index of <see cref="mousePointer"/> before any mouse sent input.
+        /// </summary>
+        protected const uint NO_DEVICE = uint.MaxValue;
+
+        /// <summary>
+        /// Id of the <c>GL.IssuePluginEvent</c> event which latches pointer positions on the render thread. Issue it with <see cref="RenderEventFunc"/>.
+        /// </summary>
+        public const int RENDER_EVENT_LATCH_POSITIONS = 1;
+
+        private const int LOG_ENTRY_LENGTH = 120;
+        private const int MAX_LATCHED_POSITIONS = 64;
+        private const int PREDICTION_TYPES = 6;
+
+        /// <summary>
+        /// Movement of synthetic touches injected by <see cref="StartSyntheticLoad"/>.
+        /// </summary>
+        public enum SyntheticLoadPattern
+        {
+            /// <summary>
+            /// Every touch moves in its own random direction.
+            /// </summary>
+            RandomWalk,
+
+            /// <summary>
+            /// Touches sit on a rotating circle which grows and shrinks.
+            /// </summary>
+            Pinch,
+
+            /// <summary>
+            /// Rows of touches swipe across the window again and again.
+            /// </summary>
+            SwipeStorm
+        }
+
+        /// <summary>
+        /// How the native plugin extrapolates pointer positions, see <see cref="SetPrediction"/>.
+        /// </summary>
+        public enum PredictionMode
+        {
+            /// <summary>
+            /// Positions are not predicted.
+            /// </summary>
+            None,
+
+            /// <summary>
+            /// Velocity between the last two samples.
+            /// </summary>
+            Linear,
+
+            /// <summary>
+            /// Velocity and acceleration of the last three samples.
+            /// </summary>
+            ConstantAcceleration,
+
+            /// <summary>
+            /// Velocity estimated by a Kalman filter, smooths out noisy digitizers.
+            /// </summary>
+            Kalman
+        }
+
         /// <summary>
         /// The method delegate used to pass data from the native DLL.
         /// </summary>
         /// <param name="id">Pointer id.</param>
+        /// <param name="slot">Dense slot of the pointer, -1 if all slots were taken.</param>
+        /// <param name="device">Index of the device the pointer came from.</param>
         /// <param name="evt">Current event.</param>
         /// <param name="type">Pointer type.</param>
         /// <param name="position">Pointer position.</param>
         /// <param name="data">Pointer data.</param>
-        protected delegate void NativePointerDelegate(int id, PointerEvent evt, PointerType type, Vector2 position, PointerData data);
+        /// <param name="received">QPC time the native plugin received the message at.</param>
+        protected delegate void NativePointerDelegate(int id, int slot, uint device, PointerEvent evt, PointerType type, Vector2 position, PointerData data, ulong received);
+
+        #endregion
+
+        #region Public properties
 
         /// <summary>
-        /// The method delegate used to pass log messages from the native DLL.
+        /// Should the native plugin store pointer events in a buffer which is drained once per frame instead of calling managed code for every event.
         /// </summary>
-        /// <param name="log">The log message.</param>
-        protected delegate void NativeLog([MarshalAs(UnmanagedType.BStr)] string log);
+        public bool BufferedInput
+        {
+            get { return bufferedInput; }
+            set
+            {
+                if (bufferedInput == value) return;
+                if (value)
+                {
+                    if (!eventFormatMatches)
+                    {
+                        Debug.LogError("[TouchScript] WindowsTouch.dll stores events in a different format, buffered input is disabled. Update the plugin.");
+                        return;
+                    }
+                    if (eventBuffer == null) eventBuffer = new NativePackedEvent[EVENT_BUFFER_CAPACITY];
+                    SetDeliveryMode(DELIVERY_MODE.DELIVERY_BUFFERED, EVENT_BUFFER_CAPACITY);
+                }
+                else
+                {
+                    DeliveryThread = false;
+                    SetDeliveryMode(DELIVERY_MODE.DELIVERY_CALLBACK, 0);
+                    // Process events which were buffered before the switch.
+                    drainEvents();
+                }
+                bufferedInput = value;
+            }
+        }
 
-        #endregion
+        /// <summary>
+        /// Should the native plugin keep a table of active pointers which is read once per frame. With <see cref="BufferedInput"/> plain updates are then taken from the table instead of processing every event.
+        /// </summary>
+        public bool SharedPointerTable
+        {
+            get { return getPluginOption(PLUGIN_OPTIONS.OPTION_POINTER_TABLE); }
+            set
+            {
+                if (value && pointerTable == null) pointerTable = new WindowsPointerTable(GetPointerTable());
+                setPluginOption(PLUGIN_OPTIONS.OPTION_POINTER_TABLE, value);
+            }
+        }
 
-        #region Public properties
+        /// <summary>
+        /// Should the native plugin merge consecutive updates of every pointer into the latest one when <see cref="BufferedInput"/> events are drained. Presses, releases and cancels are kept as they are.
+        /// </summary>
+        public bool CoalesceUpdates
+        {
+            get { return getPluginOption(PLUGIN_OPTIONS.OPTION_COALESCE); }
+            set { setPluginOption(PLUGIN_OPTIONS.OPTION_COALESCE, value); }
+        }
 
-        /// <inheritdoc />
-        public ICoordinatesRemapper CoordinatesRemapper { get; set; }
+        /// <summary>
+        /// Should positions of updates merged by <see cref="CoalesceUpdates"/> be kept. Use <see cref="GetCoalescedPositions"/> to read them.
+        /// </summary>
+        public bool KeepCoalescedHistory
+        {
+            get { return getPluginOption(PLUGIN_OPTIONS.OPTION_COALESCE_HISTORY); }
+            set
+            {
+                if (value && coalescedBuffer == null) coalescedBuffer = new NativePackedEvent[EVENT_BUFFER_CAPACITY];
+                coalescedCount = 0;
+                setPluginOption(PLUGIN_OPTIONS.OPTION_COALESCE_HISTORY, value);
+            }
+        }
+
+        /// <summary>
+        /// Should the native plugin drop updates which don't change pointer position, pressure or rotation beyond epsilons set with <see cref="SetFilterParams"/>.
+        /// </summary>
+        public bool SuppressStationary
+        {
+            get { return getPluginOption(PLUGIN_OPTIONS.OPTION_STATIONARY_FILTER); }
+            set { setPluginOption(PLUGIN_OPTIONS.OPTION_STATIONARY_FILTER, value); }
+        }
+
+        /// <summary>
+        /// Should the native plugin drop touches classified as palms. A touch which becomes a palm after it was pressed is cancelled.
+        /// </summary>
+        public bool PalmRejection
+        {
+            get { return getPluginOption(PLUGIN_OPTIONS.OPTION_PALM_REJECT); }
+            set { setPluginOption(PLUGIN_OPTIONS.OPTION_PALM_REJECT, value); }
+        }
+
+        /// <summary>
+        /// Should touches classified as palms be marked with <see cref="Pointer.FLAG_PALM"/> instead of being dropped.
+        /// </summary>
+        public bool TagPalms
+        {
+            get { return getPluginOption(PLUGIN_OPTIONS.OPTION_PALM_TAG); }
+            set { setPluginOption(PLUGIN_OPTIONS.OPTION_PALM_TAG, value); }
+        }
+
+        /// <summary>
+        /// Should the native plugin track active touches so that <see cref="GetContactAggregates"/> can compute their centroid, bounds, spread and angle.
+        /// </summary>
+        public bool ContactAggregates
+        {
+            get { return getPluginOption(PLUGIN_OPTIONS.OPTION_CONTACT_AGGREGATES); }
+            set { setPluginOption(PLUGIN_OPTIONS.OPTION_CONTACT_AGGREGATES, value); }
+        }
+
+        /// <summary>
+        /// Should buffered events which arrive after the frame began wait for the next frame instead of being delivered in the middle of it. Works with <see cref="BufferedInput"/>.
+        /// </summary>
+        public bool FrameSync
+        {
+            get { return getPluginOption(PLUGIN_OPTIONS.OPTION_FRAME_SYNC); }
+            set { setPluginOption(PLUGIN_OPTIONS.OPTION_FRAME_SYNC, value); }
+        }
+
+        /// <summary>
+        /// Should the native plugin smooth jittery pointer positions with a One Euro filter set up with <see cref="SetJitterFilterParams"/>. Smoothed updates which don't move beyond the position epsilon are dropped by <see cref="SuppressStationary"/>.
+        /// </summary>
+        public bool JitterFilter
+        {
+            get { return getPluginOption(PLUGIN_OPTIONS.OPTION_JITTER_FILTER); }
+            set { setPluginOption(PLUGIN_OPTIONS.OPTION_JITTER_FILTER, value); }
+        }
+
+        /// <summary>
+        /// Should a native thread filter, transform and publish pointer events so that the window proc only decodes and queues them. Requires <see cref="BufferedInput"/>, not available during a replay.
+        /// </summary>
+        public bool DeliveryThread
+        {
+            get { return deliveryThread; }
+            set
+            {
+                if (deliveryThread == value) return;
+                if (value) deliveryThread = StartDeliveryThread();
+                else
+                {
+                    StopDeliveryThread();
+                    deliveryThread = false;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Is the handler replaying a capture file instead of processing live input.
+        /// </summary>
+        public bool IsReplaying
+        {
+            get { return replaying; }
+        }
+
+        /// <summary>
+        /// How far ahead in seconds pointer positions are predicted every frame, usually the time until the frame is displayed. See <see cref="SetPrediction"/>.
+        /// </summary>
+        public float PredictionTime
+        {
+            get { return predictionTime; }
+            set { predictionTime = Mathf.Max(0, value); }
+        }
+
+        /// <summary>
+        /// Should the handler measure time from a pointer message entering the native window proc to TouchScript processing it.
+        /// </summary>
+        public bool MeasureLatency
+        {
+            get { return measureLatency; }
+            set
+            {
+                if (measureLatency == value) return;
+                var manager = TouchManager.Instance;
+                if (value)
+                {
+                    if (manager == null) return;
+                    if (latency == null) latency = new LatencyHistogram();
+                    if (pendingTimestamps == null) pendingTimestamps = new long[EVENT_BUFFER_CAPACITY];
+                    pendingTimestampCount = 0;
+                    manager.FrameStarted += frameStartedHandler;
+                }
+                else if (manager != null)
+                {
+                    manager.FrameStarted -= frameStartedHandler;
+                }
+                measureLatency = value;
+            }
+        }
+
+        /// <summary>
+        /// Latency of pointer events in milliseconds from the native window proc to the start of TouchScript pointer processing. Collected while <see cref="MeasureLatency"/> is on.
+        /// </summary>
+        public LatencyHistogram Latency
+        {
+            get { return latency; }
+        }
 
         #endregion
 
         #region Private variables
 
         private NativePointerDelegate nativePointerDelegate;
-        private NativeLog nativeLogDelegate;
-
-        protected PointerDelegate addPointer;
-        protected PointerDelegate updatePointer;
-        protected PointerDelegate pressPointer;
-        protected PointerDelegate releasePointer;
-        protected PointerDelegate removePointer;
-        protected PointerDelegate cancelPointer;
+        // Passed to contexts, which are switched to buffered delivery before their window proc can run.
+        private NativePointerDelegate contextPointerDelegate;
+        private List<ContextHandler> contextHandlers = new List<ContextHandler>();
+        private char[] logBuffer = new char[LOG_ENTRY_LENGTH];
+        private bool bufferedInput = false;
+        private bool deliveryThread = false;
+        private PLUGIN_OPTIONS pluginOptions = PLUGIN_OPTIONS.OPTION_NONE;
+        private bool eventFormatMatches = false;
+        private NativePackedEvent[] eventBuffer;
+        private WindowsPointerTable pointerTable;
+        private NativePackedEvent[] coalescedBuffer;
+        private int coalescedCount;
+        private LatchedPosition[] latchBuffer;
+        private PredictionMode[] predictionModes = new PredictionMode[PREDICTION_TYPES];
+        private bool predicting = false;
+        private float predictionTime = .016f;
+        private long qpcFrequency;
+        private LatchedPosition[] predictionBuffer;
+        private Dictionary<int, Vector2> latchedPositions = new Dictionary<int, Vector2>(10);
+
+        private bool replaying = false;
+        private bool measureLatency = false;
+        private LatencyHistogram latency;
+        private long[] pendingTimestamps;
+        private int pendingTimestampCount;
 
         protected IntPtr hMainWindow;
         protected ushort pressAndHoldAtomID;
-        protected Dictionary<int, TouchPointer> winTouchToInternalId = new Dictionary<int, TouchPointer>(10);
 
-        protected ObjectPool<TouchPointer> touchPool;
         protected ObjectPool<MousePointer> mousePool;
         protected ObjectPool<PenPointer> penPool;
         protected MousePointer mousePointer;
+        // Device index of the mouse mousePointer belongs to, the first mouse which sends input takes it.
+        protected uint mouseDevice = NO_DEVICE;
+        // Pointers of other mice by device index, added when a mouse sends its first input.
+        protected MousePointer[] otherMice = new MousePointer[MAX_DEVICES];
         protected PenPointer penPointer;
 
         #endregion
@@ -229,19 +564,10 @@ namespace TouchScript.InputSources.InputHandlers
         /// <param name="releasePointer">A function called when a pointer is lifted off.</param>
         /// <param name="removePointer">A function called when a pointer is removed.</param>
         /// <param name="cancelPointer">A function called when a pointer is cancelled.</param>
-        public WindowsPointerHandler(PointerDelegate addPointer, PointerDelegate updatePointer, PointerDelegate pressPointer, PointerDelegate releasePointer, PointerDelegate removePointer, PointerDelegate cancelPointer)
+        public WindowsPointerHandler(PointerDelegate addPointer, PointerDelegate updatePointer, PointerDelegate pressPointer, PointerDelegate releasePointer, PointerDelegate removePointer, PointerDelegate cancelPointer) : base(addPointer, updatePointer, pressPointer, releasePointer, removePointer, cancelPointer)
         {
-            this.addPointer = addPointer;
-            this.updatePointer = updatePointer;
-            this.pressPointer = pressPointer;
-            this.releasePointer = releasePointer;
-            this.removePointer = removePointer;
-            this.cancelPointer = cancelPointer;
-
-            nativeLogDelegate = nativeLog;
             nativePointerDelegate = nativePointer;
-
-            touchPool = new ObjectPool<TouchPointer>(10, () => new TouchPointer(this), null, resetPointer);
+            contextPointerDelegate = contextPointer;
 
             hMainWindow = WindowsUtils.GetActiveWindow();
             disablePressAndHold();
@@ -253,105 +579,330 @@ namespace TouchScript.InputSources.InputHandlers
         #region Public methods
 
         /// <inheritdoc />
-        public virtual bool UpdateInput()
+        public override bool UpdateInput()
         {
+            drainLog();
+            if (replaying && UpdateReplay(bufferedInput ? EVENT_BUFFER_CAPACITY : 0) == 0) StopReplay();
+            if (bufferedInput)
+            {
+                if (getPluginOption(PLUGIN_OPTIONS.OPTION_FRAME_SYNC)) BeginFrame();
+                drainEvents();
+                if (getPluginOption(PLUGIN_OPTIONS.OPTION_POINTER_TABLE)) applyPointerTable();
+            }
+            for (var i = 0; i < contextHandlers.Count; i++) contextHandlers[i].UpdateInput();
+            if (predicting) applyPrediction();
             return false;
         }
 
         /// <inheritdoc />
-        public virtual void UpdateResolution()
+        public override void UpdateResolution()
         {
             setScaling();
             if (mousePointer != null) TouchManager.Instance.CancelPointer(mousePointer.Id);
+            for (var i = 0; i < otherMice.Length; i++)
+            {
+                if (otherMice[i] != null) TouchManager.Instance.CancelPointer(otherMice[i].Id);
+            }
         }
 
         /// <inheritdoc />
-        public virtual bool CancelPointer(Pointer pointer, bool shouldReturn)
+        public override void Dispose()
+        {
+            base.Dispose();
+
+            DeliveryThread = false;
+            while (contextHandlers.Count > 0) contextHandlers[contextHandlers.Count - 1].Dispose();
+            MeasureLatency = false;
+
+            enablePressAndHold();
+            DisposePlugin();
+            drainLog();
+        }
+
+        /// <summary>
+        /// Sets parameters of native stationary and palm filters.
+        /// </summary>
+        /// <param name="positionEpsilon">Maximum movement in pixels of an update which is considered stationary.</param>
+        /// <param name="pressureEpsilon">Maximum pressure change in native units (0-1024) of a stationary update.</param>
+        /// <param name="rotationEpsilon">Maximum rotation change in degrees of a stationary update.</param>
+        /// <param name="maxContactArea">Touches with a larger contact area in pixels are palms, 0 to not check the area.</param>
+        /// <param name="requireConfidence">Treat touches the digitizer is not confident about as palms. Only supported by Windows 8 API.</param>
+        public void SetFilterParams(float positionEpsilon, int pressureEpsilon, int rotationEpsilon, int maxContactArea, bool requireConfidence)
         {
-            var touch = pointer as TouchPointer;
-            if (touch == null) return false;
+            SetNativeFilterParams(positionEpsilon, (uint) Mathf.Max(0, pressureEpsilon), (uint) Mathf.Max(0, rotationEpsilon), (uint) Mathf.Max(0, maxContactArea), requireConfidence);
+        }
+
+        /// <summary>
+        /// Sets parameters of the native One Euro jitter filter.
+        /// </summary>
+        /// <param name="minCutoff">Cutoff frequency in Hz of a resting pointer, lower values remove more jitter.</param>
+        /// <param name="beta">How fast the cutoff grows with pointer speed in px/s, higher values reduce lag.</param>
+        /// <param name="derivativeCutoff">Cutoff frequency in Hz used to smooth pointer speed.</param>
+        public void SetJitterFilterParams(float minCutoff, float beta, float derivativeCutoff)
+        {
+            SetNativeJitterFilterParams(minCutoff, beta, derivativeCutoff);
+        }
+
+        /// <summary>
+        /// Starts injecting synthetic touches into the window from a native thread. They go through the same path as touches from a digitizer.
+        /// </summary>
+        /// <param name="contacts">Number of simultaneous touches, at most 256.</param>
+        /// <param name="hz">Injected frames per second, at most 1000.</param>
+        /// <param name="pattern">How the touches move.</param>
+        /// <returns><c>true</c> if injection started. Touch injection requires Windows 8 or later.</returns>
+        public bool StartSyntheticLoad(int contacts, int hz, SyntheticLoadPattern pattern)
+        {
+            return StartNativeSyntheticLoad(contacts, hz, (SYNTHETIC_PATTERN) pattern);
+        }
+
+        /// <summary>
+        /// Stops injecting synthetic touches and lifts all of them.
+        /// </summary>
+        public void StopSyntheticLoad()
+        {
+            StopNativeSyntheticLoad();
+        }
 
-            int internalTouchId = -1;
-            foreach (var t in winTouchToInternalId)
+        /// <summary>
+        /// Starts recording every pointer event delivered by the native plugin to a binary file.
+        /// </summary>
+        /// <param name="path">Path of the capture file, an existing file is overwritten.</param>
+        /// <returns><c>true</c> if the file was created.</returns>
+        public bool StartCapture(string path)
+        {
+            return StartNativeCapture(path);
+        }
+
+        /// <summary>
+        /// Stops recording and closes the capture file.
+        /// </summary>
+        public void StopCapture()
+        {
+            StopNativeCapture();
+        }
+
+        /// <summary>
+        /// Replays a file recorded with <see cref="StartCapture"/>, live input is ignored until the replay ends or <see cref="StopReplay"/> is called.
+        /// </summary>
+        /// <param name="path">Path of the capture file.</param>
+        /// <param name="originalTiming">Deliver events spaced as they were recorded, otherwise deliver them as fast as possible.</param>
+        /// <returns><c>true</c> if the file was opened.</returns>
+        public bool StartReplay(string path, bool originalTiming)
+        {
+            replaying = StartNativeReplay(path, originalTiming ? REPLAY_MODE.REPLAY_ORIGINAL_TIMING : REPLAY_MODE.REPLAY_FAST);
+            return replaying;
+        }
+
+        /// <summary>
+        /// Stops the replay and returns to live input.
+        /// </summary>
+        public void StopReplay()
+        {
+            replaying = false;
+            StopNativeReplay();
+        }
+
+        /// <summary>
+        /// Copies the current values of native input counters.
+        /// </summary>
+        /// <param name="stats">The snapshot to fill.</param>
+        public void GetInputStats(NativeInputStats stats)
+        {
+            GetNativeInputStats(stats.Values);
+        }
+
+        /// <summary>
+        /// Resets native input counters to zero.
+        /// </summary>
+        public void ResetInputStats()
+        {
+            ResetNativeInputStats();
+        }
+
+        /// <summary>
+        /// Computes aggregates of active touches natively. The first one is of all touches, it is followed by one for every touch device with active touches.
+        /// </summary>
+        /// <param name="buffer">The buffer to fill.</param>
+        /// <returns>Number of aggregates written, 0 if <see cref="ContactAggregates"/> is off.</returns>
+        public int GetContactAggregates(WindowsContactAggregate[] buffer)
+        {
+            if (!ContactAggregates || buffer == null || buffer.Length == 0) return 0;
+            return GetNativeContactAggregates(buffer, buffer.Length);
+        }
+
+        /// <summary>
+        /// Describes every pointer device seen so far. Position of a device in the list is the <see cref="Pointer.DeviceIndex"/> of its pointers.
+        /// </summary>
+        /// <param name="buffer">The buffer to fill.</param>
+        /// <returns>Number of devices written.</returns>
+        public int GetDevices(NativeDeviceInfo[] buffer)
+        {
+            if (buffer == null || buffer.Length == 0) return 0;
+            return GetNativeDevices(buffer, buffer.Length);
+        }
+
+        /// <summary>
+        /// Hooks another window of the Unity window thread, for example the one of a secondary display, and returns a handler for touches on it.
+        /// </summary>
+        /// <remarks>The handler is updated and disposed with this one. <see cref="SharedPointerTable"/>, prediction and <see cref="ContactAggregates"/> only cover the main window.</remarks>
+        /// <param name="window">Handle of the window.</param>
+        /// <param name="width">Width of the client area of the window in pixels.</param>
+        /// <param name="height">Height of the client area of the window in pixels.</param>
+        /// <returns>The handler or <c>null</c> if the window couldn't be hooked.</returns>
+        public ContextHandler CreateContextHandler(IntPtr window, int width, int height)
+        {
+            if (!eventFormatMatches) return null;
+
+            var context = CreateContext(window, contextPointerDelegate);
+            if (context >= 0)
             {
-                if (t.Value == touch)
-                {
-                    internalTouchId = t.Key;
-                    break;
-                }
+                SetContextDeliveryMode(context, DELIVERY_MODE.DELIVERY_BUFFERED, EVENT_BUFFER_CAPACITY);
+                var handler = new ContextHandler(this, context, width, height, addPointer, updatePointer, pressPointer, releasePointer, removePointer, cancelPointer);
+                contextHandlers.Add(handler);
+                drainLog();
+                return handler;
             }
-            if (internalTouchId > -1)
+            drainLog();
+            return null;
+        }
+
+        /// <summary>
+        /// Returns the handler of a window hooked by <see cref="CreateContextHandler"/>.
+        /// </summary>
+        /// <param name="context">Native context of the window, see <see cref="ContextHandler.Context"/>.</param>
+        /// <returns>The handler or <c>null</c> if there is none for the context.</returns>
+        public ContextHandler GetContextHandler(int context)
+        {
+            for (var i = 0; i < contextHandlers.Count; i++)
             {
-                cancelPointer(touch);
-                winTouchToInternalId.Remove(internalTouchId);
-                if (shouldReturn) winTouchToInternalId[internalTouchId] = internalReturnTouchPointer(touch);
-                return true;
+                if (contextHandlers[i].Context == context) return contextHandlers[i];
             }
-            return false;
+            return null;
         }
 
         /// <summary>
-        /// Releases resources.
+        /// Pointer to the native function to pass to <c>GL.IssuePluginEvent</c> with <see cref="RENDER_EVENT_LATCH_POSITIONS"/>.
         /// </summary>
-        public virtual void Dispose()
+        public static IntPtr RenderEventFunc
         {
-            foreach (var i in winTouchToInternalId) cancelPointer(i.Value);
-            winTouchToInternalId.Clear();
-
-            enablePressAndHold();
-            DisposePlugin();
+            get { return GetRenderEventFunc(); }
         }
 
-        #endregion
-
-        #region Internal methods
+        /// <summary>
+        /// Takes the freshest positions of active pointers right now. Requires <see cref="SharedPointerTable"/>.
+        /// </summary>
+        /// <remarks>Call it as late as possible before drawing, for example from <c>Canvas.willRenderCanvases</c>, and read results with <see cref="TryGetLatchedPosition"/>.</remarks>
+        /// <returns><c>false</c> if the pointer table is off or was being written the whole time; <c>true</c> otherwise.</returns>
+        public bool LatchPositions()
+        {
+            if (!SharedPointerTable || !LatchNativePositions())
+            {
+                latchedPositions.Clear();
+                return false;
+            }
+            ReadLatchedPositions();
+            return true;
+        }
 
-        /// <inheritdoc />
-        public virtual void INTERNAL_DiscardPointer(Pointer pointer)
+        /// <summary>
+        /// Reads positions latched last either by <see cref="LatchPositions"/> or by <see cref="RENDER_EVENT_LATCH_POSITIONS"/> on the render thread.
+        /// </summary>
+        public void ReadLatchedPositions()
         {
-            var p = pointer as TouchPointer;
-            if (p == null) return;
+            latchedPositions.Clear();
+            if (!SharedPointerTable) return;
+            if (latchBuffer == null) latchBuffer = new LatchedPosition[MAX_LATCHED_POSITIONS];
 
-            touchPool.Release(p);
+            var count = GetLatchedPositions(latchBuffer, latchBuffer.Length);
+            for (var i = 0; i < count; i++)
+            {
+                var pointer = getPointer(latchBuffer[i].Slot, latchBuffer[i].Device, latchBuffer[i].Type);
+                if (pointer == null) continue;
+                latchedPositions[pointer.Id] = remapCoordinates(latchBuffer[i].Position, pointer.DeviceIndex);
+            }
         }
 
-        #endregion
-
-        #region Protected methods
+        /// <summary>
+        /// Returns the latched position of a pointer.
+        /// </summary>
+        /// <param name="pointerId">Id of the pointer.</param>
+        /// <param name="position">Latched position.</param>
+        /// <returns><c>true</c> if the pointer was active when positions were latched; <c>false</c> otherwise.</returns>
+        public bool TryGetLatchedPosition(int pointerId, out Vector2 position)
+        {
+            return latchedPositions.TryGetValue(pointerId, out position);
+        }
 
-        protected TouchPointer internalAddTouchPointer(Vector2 position)
+        /// <summary>
+        /// Sets how positions of a pointer type are predicted. Predicted positions replace the ones of the last sample every frame.
+        /// </summary>
+        /// <param name="type">Pointer type, touch, pen or mouse.</param>
+        /// <param name="mode">Prediction mode.</param>
+        public void SetPrediction(Pointer.PointerType type, PredictionMode mode)
         {
-            var pointer = touchPool.Get();
-            pointer.Position = remapCoordinates(position);
-            pointer.Buttons |= Pointer.PointerButtonState.FirstButtonDown | Pointer.PointerButtonState.FirstButtonPressed;
-            addPointer(pointer);
-            pressPointer(pointer);
-            return pointer;
+            PointerType nativeType;
+            switch (type)
+            {
+                case Pointer.PointerType.Touch:
+                    nativeType = PointerType.Touch;
+                    break;
+                case Pointer.PointerType.Pen:
+                    nativeType = PointerType.Pen;
+                    break;
+                case Pointer.PointerType.Mouse:
+                    nativeType = PointerType.Mouse;
+                    break;
+                default:
+                    return;
+            }
+
+            predictionModes[(int) nativeType] = mode;
+            predicting = false;
+            for (var i = 0; i < predictionModes.Length; i++)
+            {
+                if (predictionModes[i] != PredictionMode.None) predicting = true;
+            }
+            SetNativePrediction(nativeType, mode);
         }
 
-        protected TouchPointer internalReturnTouchPointer(TouchPointer pointer)
+        /// <summary>
+        /// Sets parameters of native position prediction.
+        /// </summary>
+        /// <param name="processNoise">Variance of acceleration in (px/s^2)^2 the Kalman filter expects.</param>
+        /// <param name="measurementNoise">Variance of sample positions in px^2 the Kalman filter expects.</param>
+        /// <param name="maxHorizon">Pointers whose last sample is older than this many seconds are not extrapolated.</param>
+        public void SetPredictionParams(float processNoise, float measurementNoise, float maxHorizon)
         {
-            var newPointer = touchPool.Get();
-            newPointer.CopyFrom(pointer);
-            pointer.Buttons |= Pointer.PointerButtonState.FirstButtonDown | Pointer.PointerButtonState.FirstButtonPressed;
-            newPointer.Flags |= Pointer.FLAG_RETURNED;
-            addPointer(newPointer);
-            pressPointer(newPointer);
-            return newPointer;
+            SetNativePredictionParams(processNoise, measurementNoise, maxHorizon);
         }
 
-        protected void internalRemoveTouchPointer(TouchPointer pointer)
+        /// <summary>
+        /// Adds positions of updates which were merged into the latest update of the pointer this frame, oldest first.
+        /// </summary>
+        /// <param name="pointer">The pointer.</param>
+        /// <param name="positions">The list to add positions to.</param>
+        /// <returns>Number of positions added.</returns>
+        public int GetCoalescedPositions(Pointer pointer, List<Vector2> positions)
         {
-            pointer.Buttons &= ~Pointer.PointerButtonState.FirstButtonPressed;
-            pointer.Buttons |= Pointer.PointerButtonState.FirstButtonUp;
-            releasePointer(pointer);
-            removePointer(pointer);
+            var added = 0;
+            for (var i = 0; i < coalescedCount; i++)
+            {
+                if (getPointer(coalescedBuffer[i].Slot, coalescedBuffer[i].Device, (PointerType) coalescedBuffer[i].Type) != pointer) continue;
+                positions.Add(coalescedBuffer[i].Position);
+                added++;
+            }
+            return added;
         }
 
-        protected MousePointer internalAddMousePointer(Vector2 position)
+        #endregion
+
+        #region Protected methods
+
+        protected MousePointer internalAddMousePointer(Vector2 position, uint device = 0)
         {
             var pointer = mousePool.Get();
-            pointer.Position = remapCoordinates(position);
+            pointer.DeviceIndex = device;
+            pointer.Position = remapCoordinates(position, device);
             addPointer(pointer);
             return pointer;
         }
@@ -371,11 +922,12 @@ namespace TouchScript.InputSources.InputHandlers
             return newPointer;
         }
 
-        protected PenPointer internalAddPenPointer(Vector2 position)
+        protected PenPointer internalAddPenPointer(Vector2 position, uint device = 0)
         {
             if (penPointer != null) throw new InvalidOperationException("One pen pointer is already registered! Trying to add another one.");
             var pointer = penPool.Get();
-            pointer.Position = remapCoordinates(position);
+            pointer.DeviceIndex = device;
+            pointer.Position = remapCoordinates(position, device);
             addPointer(pointer);
             return pointer;
         }
@@ -403,18 +955,27 @@ namespace TouchScript.InputSources.InputHandlers
 
         protected void init(TOUCH_API api)
         {
-            Init(api, nativeLogDelegate, nativePointerDelegate);
+            SetLogLevel(Debug.isDebugBuild ? LOG_LEVEL.LOG_DEBUG : LOG_LEVEL.LOG_WARNING);
+            Init(api, nativePointerDelegate);
+            eventFormatMatches = GetEventFormat() == NativePackedEvent.FORMAT;
+            if (!eventFormatMatches) Debug.LogError("[TouchScript] WindowsTouch.dll event format doesn't match, buffered input will not be available.");
+        }
+
+        protected bool setMouseInPointer(bool value)
+        {
+            return SetNativeMouseInPointer(value);
         }
 
-        protected Vector2 remapCoordinates(Vector2 position)
+        protected bool getPluginOption(PLUGIN_OPTIONS option)
         {
-            if (CoordinatesRemapper != null) return CoordinatesRemapper.Remap(position);
-            return position;
+            return (pluginOptions & option) != 0;
         }
 
-        protected void resetPointer(Pointer p)
+        protected void setPluginOption(PLUGIN_OPTIONS option, bool value)
         {
-            p.INTERNAL_Reset();
+            if (value) pluginOptions |= option;
+            else pluginOptions &= ~option;
+            SetOptions(pluginOptions);
         }
 
         #endregion
@@ -442,6 +1003,135 @@ namespace TouchScript.InputSources.InputHandlers
             }
         }
 
+        // Native code only queues log lines, they are printed here on the main thread.
+        private void drainLog()
+        {
+            LOG_LEVEL level;
+            int length;
+            while ((length = GetLogEntry(out level, logBuffer, logBuffer.Length)) >= 0)
+            {
+                var message = "[WindowsTouch.dll]: " + new string(logBuffer, 0, length);
+                switch (level)
+                {
+                    case LOG_LEVEL.LOG_WARNING:
+                        Debug.LogWarning(message);
+                        break;
+                    case LOG_LEVEL.LOG_ERROR:
+                        Debug.LogError(message);
+                        break;
+                    default:
+                        Debug.Log(message);
+                        break;
+                }
+            }
+        }
+
+        private void drainEvents()
+        {
+            if (eventBuffer == null) return;
+
+            int count;
+            do
+            {
+                count = GetPointerEvents(eventBuffer, eventBuffer.Length);
+                for (var i = 0; i < count; i++)
+                {
+                    var record = eventBuffer[i];
+                    if (measureLatency) addPendingTimestamp((long) record.Received);
+                    processPointer(record.Slot, record.Device, (PointerEvent) record.Event, (PointerType) record.Type, record.Position, getPointerData(ref record));
+                }
+            } while (count == eventBuffer.Length);
+
+            coalescedCount = 0;
+            if (coalescedBuffer != null && getPluginOption(PLUGIN_OPTIONS.OPTION_COALESCE_HISTORY))
+                coalescedCount = GetCoalescedEvents(coalescedBuffer, coalescedBuffer.Length);
+        }
+
+        private Pointer getPointer(int slot, uint device, PointerType type)
+        {
+            switch (type)
+            {
+                case PointerType.Mouse:
+                    return getMouse(device);
+                case PointerType.Pen:
+                    return penPointer;
+                case PointerType.Touch:
+                    if (slot >= 0 && slot < MAX_POINTER_SLOTS) return touchSlots[slot];
+                    break;
+            }
+            return null;
+        }
+
+        private static PointerData getPointerData(ref NativePackedEvent record)
+        {
+            return new PointerData
+            {
+                PointerFlags = (PointerFlags) record.PointerFlags,
+                Flags = record.Flags,
+                Mask = record.Mask,
+                ChangedButtons = (ButtonChangeType) record.ChangedButtons,
+                Rotation = record.Rotation,
+                Pressure = record.Pressure,
+                TiltX = record.TiltX,
+                TiltY = record.TiltY
+            };
+        }
+
+        // Mouse pointer of the device, the first mouse which sent input is mousePointer.
+        private MousePointer getMouse(uint device)
+        {
+            if (device >= MAX_DEVICES) device = MAX_DEVICES - 1;
+            if (device == mouseDevice || mouseDevice == NO_DEVICE) return mousePointer;
+            return otherMice[device];
+        }
+
+        // Moves pointers to where they are expected to be when the frame is displayed.
+        private void applyPrediction()
+        {
+            if (predictionBuffer == null) predictionBuffer = new LatchedPosition[MAX_POINTER_SLOTS];
+            if (qpcFrequency == 0) WindowsUtils.QueryPerformanceFrequency(out qpcFrequency);
+            long now;
+            WindowsUtils.QueryPerformanceCounter(out now);
+
+            var count = PredictPositions((ulong) (now + (long) (predictionTime * qpcFrequency)), predictionBuffer, predictionBuffer.Length);
+            for (var i = 0; i < count; i++)
+            {
+                var pointer = getPointer(predictionBuffer[i].Slot, predictionBuffer[i].Device, predictionBuffer[i].Type);
+                if (pointer == null) continue;
+                var position = remapCoordinates(predictionBuffer[i].Position, pointer.DeviceIndex);
+                if (pointer.Position == position) continue;
+                pointer.Position = position;
+                updatePointer(pointer);
+            }
+        }
+
+        // Updates all pointers which changed since the last frame, after drainEvents() has processed transitions.
+        private void applyPointerTable()
+        {
+            if (!pointerTable.Read()) return;
+
+            var count = pointerTable.Count;
+            for (var i = 0; i < count; i++)
+            {
+                if (!pointerTable.IsUpdated(i)) continue;
+                var data = new PointerData
+                {
+                    PointerFlags = (PointerFlags) pointerTable.PointerFlags[i],
+                    Mask = (uint) pointerTable.Mask[i],
+                    Pressure = (uint) pointerTable.Pressure[i],
+                    Rotation = (uint) pointerTable.Rotation[i]
+                };
+                processPointer(pointerTable.Slot[i], (uint) pointerTable.Device[i], PointerEvent.Update, (PointerType) pointerTable.Type[i], new Vector2(pointerTable.X[i], pointerTable.Y[i]), data);
+            }
+        }
+
+        private void addPendingTimestamp(long timestamp)
+        {
+            // If there are more events than we can track in one frame only the first ones are measured.
+            if (pendingTimestampCount == pendingTimestamps.Length) return;
+            pendingTimestamps[pendingTimestampCount++] = timestamp;
+        }
+
         private void setScaling()
         {
             var screenWidth = Screen.width;
@@ -463,45 +1153,79 @@ namespace TouchScript.InputSources.InputHandlers
 
         #region Pointer callbacks
 
-        private void nativeLog(string log)
+        private void frameStartedHandler(object sender, EventArgs e)
         {
-            Debug.Log("[WindowsTouch.dll]: " + log);
+            if (pendingTimestampCount == 0) return;
+
+            long now, frequency;
+            WindowsUtils.QueryPerformanceCounter(out now);
+            WindowsUtils.QueryPerformanceFrequency(out frequency);
+            var msPerTick = 1000.0 / frequency;
+            for (var i = 0; i < pendingTimestampCount; i++)
+            {
+                latency.Add((float) ((now - pendingTimestamps[i]) * msPerTick));
+            }
+            pendingTimestampCount = 0;
+        }
+
+        private void contextPointer(int id, int slot, uint device, PointerEvent evt, PointerType type, Vector2 position, PointerData data, ulong received) {}
+
+        private void nativePointer(int id, int slot, uint device, PointerEvent evt, PointerType type, Vector2 position, PointerData data, ulong received)
+        {
+            if (measureLatency) addPendingTimestamp((long) received);
+            processPointer(slot, device, evt, type, position, data);
         }
 
-        private void nativePointer(int id, PointerEvent evt, PointerType type, Vector2 position, PointerData data)
+        private void processPointer(int slot, uint device, PointerEvent evt, PointerType type, Vector2 position, PointerData data)
         {
             switch (type)
             {
                 case PointerType.Mouse:
+                    // With mouse in pointer every mouse has its own device index. All of them move the same cursor.
+                    if (device >= MAX_DEVICES) device = MAX_DEVICES - 1;
+                    if (mouseDevice == NO_DEVICE && mousePointer != null)
+                    {
+                        mouseDevice = device;
+                        mousePointer.DeviceIndex = device;
+                    }
+                    var mouse = getMouse(device);
+                    if (mouse == null)
+                    {
+                        // Only a mouse which starts to report gets a pointer, ending events of unknown ones are dropped.
+                        if (evt != PointerEvent.Enter && evt != PointerEvent.Update && evt != PointerEvent.Down) return;
+                        otherMice[device] = mouse = internalAddMousePointer(position, device);
+                    }
                     switch (evt)
                     {
                         // Enter and Exit are not used - mouse is always present
-                        // TODO: how does it work with 2+ mice?
                         case PointerEvent.Enter:
-                            throw new NotImplementedException("This is not supposed to be called o.O");
                         case PointerEvent.Leave:
                             break;
                         case PointerEvent.Down:
-                            mousePointer.Buttons = updateButtons(mousePointer.Buttons, data.PointerFlags, data.ChangedButtons);
-                            pressPointer(mousePointer);
+                            mouse.Buttons = updateButtons(mouse.Buttons, data.PointerFlags, data.ChangedButtons);
+                            pressPointer(mouse);
                             break;
                         case PointerEvent.Up:
-                            mousePointer.Buttons = updateButtons(mousePointer.Buttons, data.PointerFlags, data.ChangedButtons);
-                            releasePointer(mousePointer);
+                            mouse.Buttons = updateButtons(mouse.Buttons, data.PointerFlags, data.ChangedButtons);
+                            releasePointer(mouse);
                             break;
                         case PointerEvent.Update:
-                            mousePointer.Position = position;
-                            mousePointer.Buttons = updateButtons(mousePointer.Buttons, data.PointerFlags, data.ChangedButtons);
-                            updatePointer(mousePointer);
+                            mouse.Position = remapCoordinates(position, mouse.DeviceIndex);
+                            mouse.Buttons = updateButtons(mouse.Buttons, data.PointerFlags, data.ChangedButtons);
+                            updatePointer(mouse);
                             break;
                         case PointerEvent.Cancelled:
-                            cancelPointer(mousePointer);
+                            cancelPointer(mouse);
                             // can't cancel the mouse pointer, it is always present
-                            mousePointer = internalAddMousePointer(mousePointer.Position);
+                            mouse = internalAddMousePointer(mouse.Position, device);
+                            if (device == mouseDevice) mousePointer = mouse;
+                            else otherMice[device] = mouse;
                             break;
                     }
                     break;
                 case PointerType.Touch:
+                    // All slots were taken when this pointer appeared.
+                    if (slot < 0 || slot >= MAX_POINTER_SLOTS) return;
                     TouchPointer touchPointer;
                     switch (evt)
                     {
@@ -510,33 +1234,24 @@ namespace TouchScript.InputSources.InputHandlers
                         case PointerEvent.Leave:
                             // Sometimes Windows might not send Up, so have to execute touch release logic here.
                             // Has been working fine on test devices so far.
-                            if (winTouchToInternalId.TryGetValue(id, out touchPointer))
-                            {
-                                winTouchToInternalId.Remove(id);
-                                internalRemoveTouchPointer(touchPointer);
-                            }
+                            endTouch(slot);
                             break;
                         case PointerEvent.Down:
-                            touchPointer = internalAddTouchPointer(position);
-                            touchPointer.Rotation = getTouchRotation(ref data);
-                            touchPointer.Pressure = getTouchPressure(ref data);
-                            winTouchToInternalId.Add(id, touchPointer);
+                            // Ends the previous pointer in this slot if Windows didn't.
+                            touchPointer = beginTouch(slot, position, device);
+                            updateTouch(touchPointer, ref data);
                             break;
                         case PointerEvent.Up:
                             break;
                         case PointerEvent.Update:
-                            if (!winTouchToInternalId.TryGetValue(id, out touchPointer)) return;
-                            touchPointer.Position = position;
-                            touchPointer.Rotation = getTouchRotation(ref data);
-                            touchPointer.Pressure = getTouchPressure(ref data);
+                            touchPointer = touchSlots[slot];
+                            if (touchPointer == null) return;
+                            touchPointer.Position = remapCoordinates(position, touchPointer.DeviceIndex);
+                            updateTouch(touchPointer, ref data);
                             updatePointer(touchPointer);
                             break;
                         case PointerEvent.Cancelled:
-                            if (winTouchToInternalId.TryGetValue(id, out touchPointer))
-                            {
-                                winTouchToInternalId.Remove(id);
-                                cancelPointer(touchPointer);
-                            }
+                            cancelTouch(slot);
                             break;
                     }
                     break;
@@ -544,7 +1259,7 @@ namespace TouchScript.InputSources.InputHandlers
                     switch (evt)
                     {
                         case PointerEvent.Enter:
-                            penPointer = internalAddPenPointer(position);
+                            penPointer = internalAddPenPointer(position, device);
                             penPointer.Pressure = getPenPressure(ref data);
                             penPointer.Rotation = getPenRotation(ref data);
                             break;
@@ -566,7 +1281,7 @@ namespace TouchScript.InputSources.InputHandlers
                             break;
                         case PointerEvent.Update:
                             if (penPointer == null) break;
-                            penPointer.Position = position;
+                            penPointer.Position = remapCoordinates(position, penPointer.DeviceIndex);
                             penPointer.Pressure = getPenPressure(ref data);
                             penPointer.Rotation = getPenRotation(ref data);
                             penPointer.Buttons = updateButtons(penPointer.Buttons, data.PointerFlags, data.ChangedButtons);
@@ -591,28 +1306,35 @@ namespace TouchScript.InputSources.InputHandlers
             return combined;
         }
 
-        private float getTouchPressure(ref PointerData data)
+        private static void updateTouch(TouchPointer touchPointer, ref PointerData data)
+        {
+            touchPointer.Rotation = getTouchRotation(ref data);
+            touchPointer.Pressure = getTouchPressure(ref data);
+            if ((data.Flags & (uint) TouchFlags.Palm) != 0) touchPointer.Flags |= Pointer.FLAG_PALM;
+        }
+
+        private static float getTouchPressure(ref PointerData data)
         {
             var reliable = (data.Mask & (uint) TouchMask.Pressure) > 0;
             if (reliable) return data.Pressure / 1024f;
             return TouchPointer.DEFAULT_PRESSURE;
         }
 
-        private float getTouchRotation(ref PointerData data)
+        private static float getTouchRotation(ref PointerData data)
         {
             var reliable = (data.Mask & (uint) TouchMask.Orientation) > 0;
             if (reliable) return data.Rotation / 180f * Mathf.PI;
             return TouchPointer.DEFAULT_ROTATION;
         }
 
-        private float getPenPressure(ref PointerData data)
+        private static float getPenPressure(ref PointerData data)
         {
             var reliable = (data.Mask & (uint) PenMask.Pressure) > 0;
             if (reliable) return data.Pressure / 1024f;
             return PenPointer.DEFAULT_PRESSURE;
         }
 
-        private float getPenRotation(ref PointerData data)
+        private static float getPenRotation(ref PointerData data)
         {
             var reliable = (data.Mask & (uint) PenMask.Rotation) > 0;
             if (reliable) return data.Rotation / 180f * Mathf.PI;
@@ -621,12 +1343,200 @@ namespace TouchScript.InputSources.InputHandlers
 
         #endregion
 
+        #region Context handler
+
+        /// <summary>
+        /// Touch handler of another window hooked by <see cref="CreateContextHandler"/>.
+        /// </summary>
+        /// <remarks>
+        /// <para>Events of the window are always buffered, the main handler drains them every frame. Only touches are handled, the system cursor and pen belong to the main window.</para>
+        /// <para>Filters and slots are kept per window, options and filter parameters are the ones of the main handler.</para>
+        /// </remarks>
+        public sealed class ContextHandler : NativePointerHandler
+        {
+            #region Public properties
+
+            /// <summary>
+            /// Native context of the window, -1 after the handler was disposed.
+            /// </summary>
+            public int Context
+            {
+                get { return context; }
+            }
+
+            #endregion
+
+            #region Private variables
+
+            private WindowsPointerHandler owner;
+            private int context;
+            private int screenWidth;
+            private int screenHeight;
+            private NativePackedEvent[] eventBuffer = new NativePackedEvent[EVENT_BUFFER_CAPACITY];
+
+            #endregion
+
+            #region Constructor
+
+            internal ContextHandler(WindowsPointerHandler owner, int context, int width, int height, PointerDelegate addPointer, PointerDelegate updatePointer, PointerDelegate pressPointer, PointerDelegate releasePointer, PointerDelegate removePointer, PointerDelegate cancelPointer) : base(addPointer, updatePointer, pressPointer, releasePointer, removePointer, cancelPointer)
+            {
+                this.owner = owner;
+                this.context = context;
+                SetScreenSize(width, height);
+            }
+
+            #endregion
+
+            #region Public methods
+
+            /// <inheritdoc />
+            public override bool UpdateInput()
+            {
+                if (context < 0) return false;
+
+                int count;
+                do
+                {
+                    count = GetContextPointerEvents(context, eventBuffer, eventBuffer.Length);
+                    for (var i = 0; i < count; i++) processPointer(ref eventBuffer[i]);
+                } while (count == eventBuffer.Length);
+
+                return touchCount > 0;
+            }
+
+            /// <inheritdoc />
+            public override void UpdateResolution()
+            {
+                if (context < 0) return;
+                SetContextScreenParams(context, screenWidth, screenHeight, 0, 0, 1, 1);
+            }
+
+            /// <summary>
+            /// Sets the size of the client area of the window, touches are reported in its pixels.
+            /// </summary>
+            /// <param name="width">Width in pixels.</param>
+            /// <param name="height">Height in pixels.</param>
+            public void SetScreenSize(int width, int height)
+            {
+                screenWidth = width;
+                screenHeight = height;
+                UpdateResolution();
+            }
+
+            /// <summary>
+            /// Copies the current values of native input counters of the window.
+            /// </summary>
+            /// <param name="stats">The snapshot to fill.</param>
+            public void GetInputStats(NativeInputStats stats)
+            {
+                if (context < 0) return;
+                GetNativeContextInputStats(context, stats.Values);
+            }
+
+            /// <summary>
+            /// Cancels touches of the window and unhooks it.
+            /// </summary>
+            public override void Dispose()
+            {
+                if (context < 0) return;
+
+                base.Dispose();
+                DestroyContext(context);
+                context = -1;
+                owner.contextHandlers.Remove(this);
+            }
+
+            #endregion
+
+            #region Private functions
+
+            private void processPointer(ref NativePackedEvent record)
+            {
+                // All slots were taken when this pointer appeared.
+                var slot = record.Slot;
+                if ((PointerType) record.Type != PointerType.Touch || slot < 0 || slot >= MAX_POINTER_SLOTS) return;
+
+                var data = getPointerData(ref record);
+                TouchPointer touchPointer;
+                switch ((PointerEvent) record.Event)
+                {
+                    case PointerEvent.Down:
+                        touchPointer = beginTouch(slot, record.Position, record.Device);
+                        updateTouch(touchPointer, ref data);
+                        break;
+                    case PointerEvent.Update:
+                        touchPointer = touchSlots[slot];
+                        if (touchPointer == null) return;
+                        touchPointer.Position = remapCoordinates(record.Position, touchPointer.DeviceIndex);
+                        updateTouch(touchPointer, ref data);
+                        updatePointer(touchPointer);
+                        break;
+                    case PointerEvent.Leave:
+                        endTouch(slot);
+                        break;
+                    case PointerEvent.Cancelled:
+                        cancelTouch(slot);
+                        break;
+                }
+            }
+
+            #endregion
+        }
+
+        #endregion
+
         #region p/invoke
 
         protected enum TOUCH_API
         {
             WIN7,
-            WIN8
+            WIN8,
+            RAW
+        }
+
+        protected enum DELIVERY_MODE
+        {
+            DELIVERY_CALLBACK,
+            DELIVERY_BUFFERED
+        }
+
+        [Flags]
+        protected enum PLUGIN_OPTIONS : uint
+        {
+            OPTION_NONE = 0x00000000,
+            OPTION_FRAME_DECODE = 0x00000001,
+            OPTION_HISTORY = 0x00000002,
+            OPTION_POINTER_TABLE = 0x00000004,
+            OPTION_COALESCE = 0x00000008,
+            OPTION_COALESCE_HISTORY = 0x00000010,
+            OPTION_STATIONARY_FILTER = 0x00000020,
+            OPTION_PALM_REJECT = 0x00000040,
+            OPTION_PALM_TAG = 0x00000080,
+            OPTION_CONTACT_AGGREGATES = 0x00000100,
+            OPTION_FRAME_SYNC = 0x00000200,
+            OPTION_JITTER_FILTER = 0x00000400
+        }
+
+        protected enum SYNTHETIC_PATTERN
+        {
+            SYNTHETIC_RANDOM_WALK,
+            SYNTHETIC_PINCH,
+            SYNTHETIC_SWIPE_STORM
+        }
+
+        protected enum REPLAY_MODE
+        {
+            REPLAY_ORIGINAL_TIMING,
+            REPLAY_FAST
+        }
+
+        protected enum LOG_LEVEL
+        {
+            LOG_DEBUG,
+            LOG_INFO,
+            LOG_WARNING,
+            LOG_ERROR,
+            LOG_NONE
         }
 
         protected enum PointerEvent : uint
@@ -690,7 +1600,8 @@ namespace TouchScript.InputSources.InputHandlers
         [Flags]
         protected enum TouchFlags
         {
-            None = 0x00000000
+            None = 0x00000000,
+            Palm = 0x00010000
         }
 
         [Flags]
@@ -734,8 +1645,18 @@ namespace TouchScript.InputSources.InputHandlers
             public int TiltY;
         }
 
+        [StructLayout(LayoutKind.Sequential)]
+        private struct LatchedPosition
+        {
+            public int Id;
+            public int Slot;
+            public PointerType Type;
+            public uint Device;
+            public Vector2 Position;
+        }
+
         [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
-        private static extern void Init(TOUCH_API api, NativeLog log, NativePointerDelegate pointerDelegate);
+        private static extern void Init(TOUCH_API api, NativePointerDelegate pointerDelegate);
 
         [DllImport("WindowsTouch", EntryPoint = "Dispose", CallingConvention = CallingConvention.StdCall)]
         private static extern void DisposePlugin();
@@ -743,6 +1664,117 @@ namespace TouchScript.InputSources.InputHandlers
         [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
         private static extern void SetScreenParams(int width, int height, float offsetX, float offsetY, float scaleX, float scaleY);
 
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetDeliveryMode(DELIVERY_MODE mode, int capacity);
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern int CreateContext(IntPtr window, NativePointerDelegate pointerDelegate);
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern void DestroyContext(int context);
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetContextScreenParams(int context, int width, int height, float offsetX, float offsetY, float scaleX, float scaleY);
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetContextDeliveryMode(int context, DELIVERY_MODE mode, int capacity);
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern int GetContextPointerEvents(int context, [Out] NativePackedEvent[] buffer, int capacity);
+
+        [DllImport("WindowsTouch", EntryPoint = "GetContextInputStats", CallingConvention = CallingConvention.StdCall)]
+        private static extern void GetNativeContextInputStats(int context, [Out] long[] stats);
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetOptions(PLUGIN_OPTIONS options);
+
+        [DllImport("WindowsTouch", EntryPoint = "SetMouseInPointer", CallingConvention = CallingConvention.StdCall)]
+        private static extern bool SetNativeMouseInPointer(bool enable);
+
+        [DllImport("WindowsTouch", EntryPoint = "SetFilterParams", CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetNativeFilterParams(float positionEpsilon, uint pressureEpsilon, uint rotationEpsilon, uint maxContactArea, bool requireConfidence);
+
+        [DllImport("WindowsTouch", EntryPoint = "SetJitterFilterParams", CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetNativeJitterFilterParams(float minCutoff, float beta, float derivativeCutoff);
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern int GetPointerEvents([Out] NativePackedEvent[] buffer, int capacity);
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern int GetCoalescedEvents([Out] NativePackedEvent[] buffer, int capacity);
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern uint GetEventFormat();
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern IntPtr GetPointerTable();
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern void BeginFrame();
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern IntPtr GetRenderEventFunc();
+
+        [DllImport("WindowsTouch", EntryPoint = "LatchPositions", CallingConvention = CallingConvention.StdCall)]
+        private static extern bool LatchNativePositions();
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern int GetLatchedPositions([Out] LatchedPosition[] buffer, int capacity);
+
+        [DllImport("WindowsTouch", EntryPoint = "SetPrediction", CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetNativePrediction(PointerType type, PredictionMode mode);
+
+        [DllImport("WindowsTouch", EntryPoint = "SetPredictionParams", CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetNativePredictionParams(float processNoise, float measurementNoise, float maxHorizon);
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern int PredictPositions(ulong target, [Out] LatchedPosition[] buffer, int capacity);
+
+        [DllImport("WindowsTouch", EntryPoint = "GetDevices", CallingConvention = CallingConvention.StdCall)]
+        private static extern int GetNativeDevices([Out] NativeDeviceInfo[] buffer, int capacity);
+
+        [DllImport("WindowsTouch", EntryPoint = "GetContactAggregates", CallingConvention = CallingConvention.StdCall)]
+        private static extern int GetNativeContactAggregates([Out] WindowsContactAggregate[] buffer, int capacity);
+
+        [DllImport("WindowsTouch", EntryPoint = "StartSyntheticLoad", CallingConvention = CallingConvention.StdCall)]
+        private static extern bool StartNativeSyntheticLoad(int contacts, int hz, SYNTHETIC_PATTERN pattern);
+
+        [DllImport("WindowsTouch", EntryPoint = "StopSyntheticLoad", CallingConvention = CallingConvention.StdCall)]
+        private static extern void StopNativeSyntheticLoad();
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern bool StartDeliveryThread();
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern void StopDeliveryThread();
+
+        [DllImport("WindowsTouch", EntryPoint = "StartCapture", CallingConvention = CallingConvention.StdCall)]
+        private static extern bool StartNativeCapture([MarshalAs(UnmanagedType.LPWStr)] string path);
+
+        [DllImport("WindowsTouch", EntryPoint = "StopCapture", CallingConvention = CallingConvention.StdCall)]
+        private static extern void StopNativeCapture();
+
+        [DllImport("WindowsTouch", EntryPoint = "StartReplay", CallingConvention = CallingConvention.StdCall)]
+        private static extern bool StartNativeReplay([MarshalAs(UnmanagedType.LPWStr)] string path, REPLAY_MODE mode);
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern int UpdateReplay(int maxEvents);
+
+        [DllImport("WindowsTouch", EntryPoint = "StopReplay", CallingConvention = CallingConvention.StdCall)]
+        private static extern void StopNativeReplay();
+
+        [DllImport("WindowsTouch", EntryPoint = "GetInputStats", CallingConvention = CallingConvention.StdCall)]
+        private static extern void GetNativeInputStats([Out] long[] stats);
+
+        [DllImport("WindowsTouch", EntryPoint = "ResetInputStats", CallingConvention = CallingConvention.StdCall)]
+        private static extern void ResetNativeInputStats();
+
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetLogLevel(LOG_LEVEL level);
+
+        [DllImport("WindowsTouch", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.StdCall)]
+        private static extern int GetLogEntry(out LOG_LEVEL level, [Out] char[] text, int capacity);
+
         #endregion
     }
 }
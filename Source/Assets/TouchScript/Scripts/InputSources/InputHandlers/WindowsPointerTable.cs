@@ -0,0 +1,177 @@
+/*
+ * @author Valentin Simonov / http://va.lent.in/
+ */
+
+#if UNITY_STANDALONE_WIN
+
+using System;
+using System.Runtime.InteropServices;
+using System.Threading;
+
+namespace TouchScript.InputSources.InputHandlers
+{
+    /// <summary>
+    /// Reads the table of active pointers WindowsTouch.dll keeps in native memory.
+    /// </summary>
+    /// <remarks>
+    /// <para>The table is a structure of arrays guarded by a sequence counter. <see cref="Read"/> copies it in one pass and retries if the window thread changed it meanwhile.</para>
+    /// <para>Layout must match PointerTable in PointerTable.h.</para>
+    /// </remarks>
+    internal sealed class WindowsPointerTable
+    {
+        #region Consts
+
+        /// <summary>
+        /// Maximum number of pointers in the table.
+        /// </summary>
+        public const int MAX_POINTERS = 64;
+
+        private const int MAX_READ_ATTEMPTS = 16;
+
+        private const int SEQUENCE_OFFSET = 0;
+        private const int COUNT_OFFSET = 4;
+        private const int TIMESTAMP_OFFSET = 8;
+        private const int ID_OFFSET = TIMESTAMP_OFFSET + 8 * MAX_POINTERS;
+        private const int TYPE_OFFSET = ID_OFFSET + 4 * MAX_POINTERS;
+        private const int UPDATED_OFFSET = TYPE_OFFSET + 4 * MAX_POINTERS;
+        private const int POINTER_FLAGS_OFFSET = UPDATED_OFFSET + 4 * MAX_POINTERS;
+        private const int MASK_OFFSET = POINTER_FLAGS_OFFSET + 4 * MAX_POINTERS;
+        private const int PRESSURE_OFFSET = MASK_OFFSET + 4 * MAX_POINTERS;
+        private const int ROTATION_OFFSET = PRESSURE_OFFSET + 4 * MAX_POINTERS;
+        private const int X_OFFSET = ROTATION_OFFSET + 4 * MAX_POINTERS;
+        private const int Y_OFFSET = X_OFFSET + 4 * MAX_POINTERS;
+        private const int SLOT_OFFSET = Y_OFFSET + 4 * MAX_POINTERS;
+        private const int DEVICE_OFFSET = SLOT_OFFSET + 4 * MAX_POINTERS;
+
+        #endregion
+
+        #region Public properties
+
+        /// <summary>
+        /// Number of pointers in the last snapshot.
+        /// </summary>
+        public int Count
+        {
+            get { return count; }
+        }
+
+        #endregion
+
+        #region Public fields
+
+        public readonly long[] Timestamp = new long[MAX_POINTERS];
+        public readonly int[] Id = new int[MAX_POINTERS];
+        public readonly int[] Type = new int[MAX_POINTERS];
+        public readonly int[] PointerFlags = new int[MAX_POINTERS];
+        public readonly int[] Mask = new int[MAX_POINTERS];
+        public readonly int[] Pressure = new int[MAX_POINTERS];
+        public readonly int[] Rotation = new int[MAX_POINTERS];
+        public readonly float[] X = new float[MAX_POINTERS];
+        public readonly float[] Y = new float[MAX_POINTERS];
+        public readonly int[] Slot = new int[MAX_POINTERS];
+        public readonly int[] Device = new int[MAX_POINTERS];
+
+        #endregion
+
+        #region Private variables
+
+        private IntPtr table;
+        private IntPtr timestampPtr, idPtr, typePtr, updatedPtr, pointerFlagsPtr, maskPtr, pressurePtr, rotationPtr, xPtr, yPtr, slotPtr, devicePtr;
+        private int[] updated = new int[MAX_POINTERS];
+        private int count;
+        private int sequence;
+        private int previousSequence;
+
+        #endregion
+
+        #region Constructor
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="WindowsPointerTable"/> class.
+        /// </summary>
+        /// <param name="table">Pointer to the native table.</param>
+        public WindowsPointerTable(IntPtr table)
+        {
+            this.table = table;
+            timestampPtr = offset(TIMESTAMP_OFFSET);
+            idPtr = offset(ID_OFFSET);
+            typePtr = offset(TYPE_OFFSET);
+            updatedPtr = offset(UPDATED_OFFSET);
+            pointerFlagsPtr = offset(POINTER_FLAGS_OFFSET);
+            maskPtr = offset(MASK_OFFSET);
+            pressurePtr = offset(PRESSURE_OFFSET);
+            rotationPtr = offset(ROTATION_OFFSET);
+            xPtr = offset(X_OFFSET);
+            yPtr = offset(Y_OFFSET);
+            slotPtr = offset(SLOT_OFFSET);
+            devicePtr = offset(DEVICE_OFFSET);
+            sequence = previousSequence = Marshal.ReadInt32(table, SEQUENCE_OFFSET) & ~1;
+        }
+
+        #endregion
+
+        #region Public methods
+
+        /// <summary>
+        /// Copies a consistent snapshot of the table.
+        /// </summary>
+        /// <returns><c>false</c> if the table was being written during all attempts, the previous snapshot is kept then.</returns>
+        public bool Read()
+        {
+            for (var attempt = 0; attempt < MAX_READ_ATTEMPTS; attempt++)
+            {
+                var start = Marshal.ReadInt32(table, SEQUENCE_OFFSET);
+                if ((start & 1) != 0) continue;
+                Thread.MemoryBarrier();
+
+                var n = Marshal.ReadInt32(table, COUNT_OFFSET);
+                if (n < 0 || n > MAX_POINTERS) continue;
+                if (n > 0)
+                {
+                    Marshal.Copy(timestampPtr, Timestamp, 0, n);
+                    Marshal.Copy(idPtr, Id, 0, n);
+                    Marshal.Copy(typePtr, Type, 0, n);
+                    Marshal.Copy(updatedPtr, updated, 0, n);
+                    Marshal.Copy(pointerFlagsPtr, PointerFlags, 0, n);
+                    Marshal.Copy(maskPtr, Mask, 0, n);
+                    Marshal.Copy(pressurePtr, Pressure, 0, n);
+                    Marshal.Copy(rotationPtr, Rotation, 0, n);
+                    Marshal.Copy(xPtr, X, 0, n);
+                    Marshal.Copy(yPtr, Y, 0, n);
+                    Marshal.Copy(slotPtr, Slot, 0, n);
+                    Marshal.Copy(devicePtr, Device, 0, n);
+                }
+
+                Thread.MemoryBarrier();
+                if (Marshal.ReadInt32(table, SEQUENCE_OFFSET) != start) continue;
+
+                count = n;
+                previousSequence = sequence;
+                sequence = start;
+                return true;
+            }
+            return false;
+        }
+
+        /// <summary>
+        /// Checks if the pointer at index changed since the previous snapshot.
+        /// </summary>
+        public bool IsUpdated(int index)
+        {
+            return updated[index] - previousSequence > 0;
+        }
+
+        #endregion
+
+        #region Private functions
+
+        private IntPtr offset(int bytes)
+        {
+            return new IntPtr(table.ToInt64() + bytes);
+        }
+
+        #endregion
+    }
+}
+
+#endif
@@ -7,6 +7,7 @@ using System;
 #endif
 using TouchScript.InputSources.InputHandlers;
 using TouchScript.Pointers;
+using TouchScript.Utils;
 using TouchScript.Utils.Attributes;
 using UnityEngine;
 
@@ -45,7 +46,12 @@ namespace TouchScript.InputSources
             /// <summary>
             /// Don't initialize pointer input at all.
             /// </summary>
-            None
+            None,
+
+            /// <summary>
+            /// HID touch screen reports read with raw input, bypasses WM_POINTER processing.
+            /// </summary>
+            RawInput
         }
 
         /// <summary>
@@ -66,7 +72,59 @@ namespace TouchScript.InputSources
             /// <summary>
             /// Don't initialize pointer input at all.
             /// </summary>
-            None
+            None,
+
+            /// <summary>
+            /// HID touch screen reports read with raw input, bypasses WM_TOUCH processing.
+            /// </summary>
+            RawInput
+        }
+
+        /// <summary>
+        /// Movement of synthetic touches injected by <see cref="StartWindowsSyntheticLoad"/>.
+        /// </summary>
+        public enum WindowsSyntheticLoadPattern
+        {
+            /// <summary>
+            /// Every touch moves in its own random direction.
+            /// </summary>
+            RandomWalk,
+
+            /// <summary>
+            /// Touches sit on a rotating circle which grows and shrinks.
+            /// </summary>
+            Pinch,
+
+            /// <summary>
+            /// Rows of touches swipe across the window again and again.
+            /// </summary>
+            SwipeStorm
+        }
+
+        /// <summary>
+        /// How Windows pointer positions are predicted, see <see cref="SetWindowsPrediction"/>.
+        /// </summary>
+        public enum WindowsPredictionMode
+        {
+            /// <summary>
+            /// Positions are not predicted.
+            /// </summary>
+            None,
+
+            /// <summary>
+            /// Velocity between the last two samples.
+            /// </summary>
+            Linear,
+
+            /// <summary>
+            /// Velocity and acceleration of the last three samples.
+            /// </summary>
+            ConstantAcceleration,
+
+            /// <summary>
+            /// Velocity estimated by a Kalman filter, smooths out noisy digitizers.
+            /// </summary>
+            Kalman
         }
 
 #if UNITY_STANDALONE_WIN && !UNITY_EDITOR
@@ -103,7 +161,15 @@ namespace TouchScript.InputSources
         }
 
         /// <summary>
-        /// Initialize mouse input on Windows 8+ or not.
+        /// Initialize native evdev touch input on Linux or not. Requires read access to /dev/input/event*.
+        /// </summary>
+        public bool LinuxTouch
+        {
+            get { return linuxTouch; }
+        }
+
+        /// <summary>
+        /// Initialize mouse input on Windows 8+ or not. With Windows 8 API mice are read as pointers and every mouse has its own device index.
         /// </summary>
         public bool Windows8Mouse
         {
@@ -126,6 +192,544 @@ namespace TouchScript.InputSources
             get { return universalWindowsMouse; }
         }
 
+        /// <summary>
+        /// Buffer native pointer events on Windows and process them once per frame instead of calling managed code for every event.
+        /// </summary>
+        public bool WindowsBufferedInput
+        {
+            get { return windowsBufferedInput; }
+            set
+            {
+                windowsBufferedInput = value;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+                if (windows8PointerHandler != null) windows8PointerHandler.BufferedInput = value;
+                if (windows7PointerHandler != null) windows7PointerHandler.BufferedInput = value;
+#endif
+            }
+        }
+
+        /// <summary>
+        /// Keep a native table of active Windows pointers and read pointer updates from it once per frame when <see cref="WindowsBufferedInput"/> is on.
+        /// </summary>
+        public bool WindowsPointerTable
+        {
+            get { return windowsPointerTable; }
+            set
+            {
+                windowsPointerTable = value;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+                if (windows8PointerHandler != null) windows8PointerHandler.SharedPointerTable = value;
+                if (windows7PointerHandler != null) windows7PointerHandler.SharedPointerTable = value;
+#endif
+            }
+        }
+
+        /// <summary>
+        /// Merge consecutive updates of every Windows pointer into the latest one when buffered events are processed.
+        /// </summary>
+        public bool WindowsCoalesceUpdates
+        {
+            get { return windowsCoalesceUpdates; }
+            set
+            {
+                windowsCoalesceUpdates = value;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+                if (windows8PointerHandler != null) windows8PointerHandler.CoalesceUpdates = value;
+                if (windows7PointerHandler != null) windows7PointerHandler.CoalesceUpdates = value;
+#endif
+            }
+        }
+
+        /// <summary>
+        /// Drop Windows pointer updates which do not move the pointer or change its pressure or rotation.
+        /// </summary>
+        public bool WindowsSuppressStationary
+        {
+            get { return windowsSuppressStationary; }
+            set
+            {
+                windowsSuppressStationary = value;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+                if (windows8PointerHandler != null) windows8PointerHandler.SuppressStationary = value;
+                if (windows7PointerHandler != null) windows7PointerHandler.SuppressStationary = value;
+#endif
+            }
+        }
+
+        /// <summary>
+        /// Drop Windows touches classified as palms, see <see cref="SetWindowsFilterParams"/>.
+        /// </summary>
+        public bool WindowsPalmRejection
+        {
+            get { return windowsPalmRejection; }
+            set
+            {
+                windowsPalmRejection = value;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+                if (windows8PointerHandler != null) windows8PointerHandler.PalmRejection = value;
+                if (windows7PointerHandler != null) windows7PointerHandler.PalmRejection = value;
+#endif
+            }
+        }
+
+        /// <summary>
+        /// Track active Windows touches natively so that <see cref="GetWindowsContactAggregates"/> can compute their centroid, bounds, spread and angle.
+        /// </summary>
+        public bool WindowsContactAggregates
+        {
+            get { return windowsContactAggregates; }
+            set
+            {
+                windowsContactAggregates = value;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+                if (windows8PointerHandler != null) windows8PointerHandler.ContactAggregates = value;
+                if (windows7PointerHandler != null) windows7PointerHandler.ContactAggregates = value;
+#endif
+            }
+        }
+
+        /// <summary>
+        /// Make buffered Windows events which arrive after the frame began wait for the next frame.
+        /// </summary>
+        public bool WindowsFrameSync
+        {
+            get { return windowsFrameSync; }
+            set
+            {
+                windowsFrameSync = value;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+                if (windows8PointerHandler != null) windows8PointerHandler.FrameSync = value;
+                if (windows7PointerHandler != null) windows7PointerHandler.FrameSync = value;
+#endif
+            }
+        }
+
+        /// <summary>
+        /// Should native Windows plugin smooth jittery pointer positions with a One Euro filter.
+        /// </summary>
+        public bool WindowsJitterFilter
+        {
+            get { return windowsJitterFilter; }
+            set
+            {
+                windowsJitterFilter = value;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+                if (windows8PointerHandler != null) windows8PointerHandler.JitterFilter = value;
+                if (windows7PointerHandler != null) windows7PointerHandler.JitterFilter = value;
+#endif
+            }
+        }
+
+        /// <summary>
+        /// Filter, transform and publish Windows pointer events on a native thread so that the window proc only decodes them. Requires <see cref="WindowsBufferedInput"/>.
+        /// </summary>
+        public bool WindowsDeliveryThread
+        {
+            get { return windowsDeliveryThread; }
+            set
+            {
+                windowsDeliveryThread = value;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+                if (windows8PointerHandler != null) windows8PointerHandler.DeliveryThread = value;
+                if (windows7PointerHandler != null) windows7PointerHandler.DeliveryThread = value;
+#endif
+            }
+        }
+
+        /// <summary>
+        /// Decode all contacts of a digitizer frame at once with Windows 8 API.
+        /// </summary>
+        public bool Windows8FrameDecoding
+        {
+            get { return windows8FrameDecoding; }
+            set
+            {
+                windows8FrameDecoding = value;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+                if (windows8PointerHandler != null) windows8PointerHandler.FrameDecoding = value;
+#endif
+            }
+        }
+
+        /// <summary>
+        /// Process all pointer samples Windows coalesced between messages with Windows 8 API.
+        /// </summary>
+        public bool Windows8PointerHistory
+        {
+            get { return windows8PointerHistory; }
+            set
+            {
+                windows8PointerHistory = value;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+                if (windows8PointerHandler != null) windows8PointerHandler.PointerHistory = value;
+#endif
+            }
+        }
+
+        /// <summary>
+        /// Sets parameters of native Windows stationary and palm filters.
+        /// </summary>
+        /// <param name="positionEpsilon">Maximum movement in pixels of an update which is considered stationary.</param>
+        /// <param name="pressureEpsilon">Maximum pressure change in native units (0-1024) of a stationary update.</param>
+        /// <param name="rotationEpsilon">Maximum rotation change in degrees of a stationary update.</param>
+        /// <param name="maxContactArea">Touches with a larger contact area in pixels are palms, 0 to not check the area.</param>
+        /// <param name="requireConfidence">Treat touches the digitizer is not confident about as palms. Only supported by Windows 8 API.</param>
+        public void SetWindowsFilterParams(float positionEpsilon, int pressureEpsilon, int rotationEpsilon, int maxContactArea, bool requireConfidence)
+        {
+            windowsPositionEpsilon = positionEpsilon;
+            windowsPressureEpsilon = pressureEpsilon;
+            windowsRotationEpsilon = rotationEpsilon;
+            windowsMaxContactArea = maxContactArea;
+            windowsRequireConfidence = requireConfidence;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) windows8PointerHandler.SetFilterParams(positionEpsilon, pressureEpsilon, rotationEpsilon, maxContactArea, requireConfidence);
+            if (windows7PointerHandler != null) windows7PointerHandler.SetFilterParams(positionEpsilon, pressureEpsilon, rotationEpsilon, maxContactArea, requireConfidence);
+#endif
+        }
+
+        /// <summary>
+        /// Sets parameters of the native Windows One Euro jitter filter.
+        /// </summary>
+        /// <param name="minCutoff">Cutoff frequency in Hz of a resting pointer, lower values remove more jitter.</param>
+        /// <param name="beta">How fast the cutoff grows with pointer speed in px/s, higher values reduce lag.</param>
+        /// <param name="derivativeCutoff">Cutoff frequency in Hz used to smooth pointer speed.</param>
+        public void SetWindowsJitterFilterParams(float minCutoff, float beta, float derivativeCutoff)
+        {
+            windowsJitterMinCutoff = minCutoff;
+            windowsJitterBeta = beta;
+            windowsJitterDerivativeCutoff = derivativeCutoff;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) windows8PointerHandler.SetJitterFilterParams(minCutoff, beta, derivativeCutoff);
+            if (windows7PointerHandler != null) windows7PointerHandler.SetJitterFilterParams(minCutoff, beta, derivativeCutoff);
+#endif
+        }
+
+        /// <summary>
+        /// How far ahead in seconds Windows pointer positions are predicted every frame, usually the time until the frame is displayed.
+        /// </summary>
+        public float WindowsPredictionTime
+        {
+            get { return windowsPredictionTime; }
+            set
+            {
+                windowsPredictionTime = value;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+                if (windows8PointerHandler != null) windows8PointerHandler.PredictionTime = value;
+                if (windows7PointerHandler != null) windows7PointerHandler.PredictionTime = value;
+#endif
+            }
+        }
+
+        /// <summary>
+        /// Sets how positions of a Windows pointer type are predicted natively to compensate input latency.
+        /// </summary>
+        /// <param name="type">Pointer type, touch, pen or mouse.</param>
+        /// <param name="mode">Prediction mode.</param>
+        public void SetWindowsPrediction(Pointer.PointerType type, WindowsPredictionMode mode)
+        {
+            switch (type)
+            {
+                case Pointer.PointerType.Touch:
+                    windowsTouchPrediction = mode;
+                    break;
+                case Pointer.PointerType.Pen:
+                    windowsPenPrediction = mode;
+                    break;
+                case Pointer.PointerType.Mouse:
+                    windowsMousePrediction = mode;
+                    break;
+                default:
+                    return;
+            }
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) windows8PointerHandler.SetPrediction(type, (WindowsPointerHandler.PredictionMode) mode);
+            if (windows7PointerHandler != null) windows7PointerHandler.SetPrediction(type, (WindowsPointerHandler.PredictionMode) mode);
+#endif
+        }
+
+        /// <summary>
+        /// Sets parameters of native Windows position prediction.
+        /// </summary>
+        /// <param name="processNoise">Variance of acceleration in (px/s^2)^2 the Kalman filter expects.</param>
+        /// <param name="measurementNoise">Variance of sample positions in px^2 the Kalman filter expects.</param>
+        /// <param name="maxHorizon">Pointers whose last sample is older than this many seconds are not extrapolated.</param>
+        public void SetWindowsPredictionParams(float processNoise, float measurementNoise, float maxHorizon)
+        {
+            windowsProcessNoise = processNoise;
+            windowsMeasurementNoise = measurementNoise;
+            windowsPredictionHorizon = maxHorizon;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) windows8PointerHandler.SetPredictionParams(processNoise, measurementNoise, maxHorizon);
+            if (windows7PointerHandler != null) windows7PointerHandler.SetPredictionParams(processNoise, measurementNoise, maxHorizon);
+#endif
+        }
+
+        /// <summary>
+        /// Starts injecting synthetic touches with the Windows touch injection API to load test the whole input pipeline.
+        /// </summary>
+        /// <param name="contacts">Number of simultaneous touches, at most 256.</param>
+        /// <param name="hz">Injected frames per second, at most 1000.</param>
+        /// <param name="pattern">How the touches move.</param>
+        /// <returns><c>true</c> if injection started. Requires Windows 8 or later and Windows 8 or Windows 7 pointer API.</returns>
+        public bool StartWindowsSyntheticLoad(int contacts, int hz, WindowsSyntheticLoadPattern pattern)
+        {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) return windows8PointerHandler.StartSyntheticLoad(contacts, hz, (WindowsPointerHandler.SyntheticLoadPattern) pattern);
+            if (windows7PointerHandler != null) return windows7PointerHandler.StartSyntheticLoad(contacts, hz, (WindowsPointerHandler.SyntheticLoadPattern) pattern);
+#endif
+            return false;
+        }
+
+        /// <summary>
+        /// Stops injecting synthetic touches started with <see cref="StartWindowsSyntheticLoad"/>.
+        /// </summary>
+        public void StopWindowsSyntheticLoad()
+        {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) windows8PointerHandler.StopSyntheticLoad();
+            if (windows7PointerHandler != null) windows7PointerHandler.StopSyntheticLoad();
+#endif
+        }
+
+        /// <summary>
+        /// Starts recording Windows pointer events to a binary file which can be replayed with <see cref="StartWindowsReplay"/>.
+        /// </summary>
+        /// <param name="path">Path of the capture file, an existing file is overwritten.</param>
+        /// <returns><c>true</c> if the file was created.</returns>
+        public bool StartWindowsCapture(string path)
+        {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) return windows8PointerHandler.StartCapture(path);
+            if (windows7PointerHandler != null) return windows7PointerHandler.StartCapture(path);
+#endif
+            return false;
+        }
+
+        /// <summary>
+        /// Stops recording started with <see cref="StartWindowsCapture"/>.
+        /// </summary>
+        public void StopWindowsCapture()
+        {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) windows8PointerHandler.StopCapture();
+            if (windows7PointerHandler != null) windows7PointerHandler.StopCapture();
+#endif
+        }
+
+        /// <summary>
+        /// Replays a file recorded with <see cref="StartWindowsCapture"/> instead of live Windows pointer input.
+        /// </summary>
+        /// <param name="path">Path of the capture file.</param>
+        /// <param name="originalTiming">Deliver events spaced as they were recorded, otherwise deliver them as fast as possible.</param>
+        /// <returns><c>true</c> if the file was opened.</returns>
+        public bool StartWindowsReplay(string path, bool originalTiming)
+        {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) return windows8PointerHandler.StartReplay(path, originalTiming);
+            if (windows7PointerHandler != null) return windows7PointerHandler.StartReplay(path, originalTiming);
+#endif
+            return false;
+        }
+
+        /// <summary>
+        /// Stops a replay started with <see cref="StartWindowsReplay"/>.
+        /// </summary>
+        public void StopWindowsReplay()
+        {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) windows8PointerHandler.StopReplay();
+            if (windows7PointerHandler != null) windows7PointerHandler.StopReplay();
+#endif
+        }
+
+        /// <summary>
+        /// Computes aggregates of active Windows touches natively, see <see cref="WindowsContactAggregates"/>.
+        /// </summary>
+        /// <param name="buffer">The buffer to fill. The first aggregate is of all touches, it is followed by one for every touch device with active touches.</param>
+        /// <returns>Number of aggregates written.</returns>
+        public int GetWindowsContactAggregates(WindowsContactAggregate[] buffer)
+        {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) return windows8PointerHandler.GetContactAggregates(buffer);
+            if (windows7PointerHandler != null) return windows7PointerHandler.GetContactAggregates(buffer);
+#endif
+            return 0;
+        }
+
+        /// <summary>
+        /// Describes every native pointer device seen so far. Position of a device in the list is the <see cref="Pointer.DeviceIndex"/> of its pointers.
+        /// </summary>
+        /// <param name="buffer">The buffer to fill.</param>
+        /// <returns>Number of devices written.</returns>
+        public int GetNativeDevices(NativeDeviceInfo[] buffer)
+        {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) return windows8PointerHandler.GetDevices(buffer);
+            if (windows7PointerHandler != null) return windows7PointerHandler.GetDevices(buffer);
+#elif UNITY_STANDALONE_LINUX && !UNITY_EDITOR
+            if (linuxPointerHandler != null) return linuxPointerHandler.GetDevices(buffer);
+#endif
+            return 0;
+        }
+
+        /// <summary>
+        /// Sets a remapper used instead of <see cref="InputSource.CoordinatesRemapper"/> for pointers of one native device.
+        /// </summary>
+        /// <param name="device">Index of the device, see <see cref="GetNativeDevices"/>.</param>
+        /// <param name="remapper">The remapper or <c>null</c> to use <see cref="InputSource.CoordinatesRemapper"/>.</param>
+        public void SetNativeDeviceCoordinatesRemapper(uint device, ICoordinatesRemapper remapper)
+        {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) windows8PointerHandler.SetDeviceCoordinatesRemapper(device, remapper);
+            if (windows7PointerHandler != null) windows7PointerHandler.SetDeviceCoordinatesRemapper(device, remapper);
+#elif UNITY_STANDALONE_LINUX && !UNITY_EDITOR
+            if (linuxPointerHandler != null) linuxPointerHandler.SetDeviceCoordinatesRemapper(device, remapper);
+#endif
+        }
+
+        /// <summary>
+        /// Hooks another window of the application for Windows touch input, for example the one of a secondary display.
+        /// </summary>
+        /// <remarks>Touches of the window are reported in its pixels with the remapper applied. The window must belong to the Unity window thread, raw input supports only the main window.</remarks>
+        /// <param name="window">Handle of the window.</param>
+        /// <param name="width">Width of the client area of the window in pixels.</param>
+        /// <param name="height">Height of the client area of the window in pixels.</param>
+        /// <param name="remapper">Remapper for touches of the window or <c>null</c>.</param>
+        /// <returns>Id of the window for <see cref="DestroyWindowsContext"/>, -1 if Windows 8 or Windows 7 pointer API is not used or the window couldn't be hooked.</returns>
+        public int CreateWindowsContext(System.IntPtr window, int width, int height, ICoordinatesRemapper remapper)
+        {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            WindowsPointerHandler handler = windows8PointerHandler;
+            if (handler == null) handler = windows7PointerHandler;
+            if (handler == null) return -1;
+
+            var context = handler.CreateContextHandler(window, width, height);
+            if (context == null) return -1;
+            context.CoordinatesRemapper = remapper;
+            return context.Context;
+#else
+            return -1;
+#endif
+        }
+
+        /// <summary>
+        /// Cancels touches of a window hooked by <see cref="CreateWindowsContext"/> and unhooks it.
+        /// </summary>
+        /// <param name="context">Id of the window.</param>
+        public void DestroyWindowsContext(int context)
+        {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            WindowsPointerHandler handler = windows8PointerHandler;
+            if (handler == null) handler = windows7PointerHandler;
+            if (handler == null) return;
+
+            var contextHandler = handler.GetContextHandler(context);
+            if (contextHandler != null) contextHandler.Dispose();
+#endif
+        }
+
+        /// <summary>
+        /// Takes the freshest positions of active Windows pointers right now. Requires <see cref="WindowsPointerTable"/>.
+        /// </summary>
+        /// <remarks>Call it as late as possible before drawing and read results with <see cref="TryGetWindowsLatchedPosition"/>.</remarks>
+        /// <returns><c>false</c> if there is no Windows pointer handler or it couldn't latch positions; <c>true</c> otherwise.</returns>
+        public bool LatchWindowsPositions()
+        {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) return windows8PointerHandler.LatchPositions();
+            if (windows7PointerHandler != null) return windows7PointerHandler.LatchPositions();
+#endif
+            return false;
+        }
+
+        /// <summary>
+        /// Returns the position of a pointer taken by the last <see cref="LatchWindowsPositions"/>.
+        /// </summary>
+        /// <param name="pointerId">Id of the pointer.</param>
+        /// <param name="position">Latched position.</param>
+        /// <returns><c>true</c> if the pointer was active when positions were latched; <c>false</c> otherwise.</returns>
+        public bool TryGetWindowsLatchedPosition(int pointerId, out Vector2 position)
+        {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) return windows8PointerHandler.TryGetLatchedPosition(pointerId, out position);
+            if (windows7PointerHandler != null) return windows7PointerHandler.TryGetLatchedPosition(pointerId, out position);
+#endif
+            position = Vector2.zero;
+            return false;
+        }
+
+        /// <summary>
+        /// Copies the current values of native input counters.
+        /// </summary>
+        /// <param name="stats">The snapshot to fill.</param>
+        /// <returns><c>true</c> if Windows 8 or Windows 7 pointer API or Linux touch is used and the snapshot was filled.</returns>
+        public bool GetNativeInputStats(NativeInputStats stats)
+        {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null)
+            {
+                windows8PointerHandler.GetInputStats(stats);
+                return true;
+            }
+            if (windows7PointerHandler != null)
+            {
+                windows7PointerHandler.GetInputStats(stats);
+                return true;
+            }
+#elif UNITY_STANDALONE_LINUX && !UNITY_EDITOR
+            if (linuxPointerHandler != null)
+            {
+                linuxPointerHandler.GetInputStats(stats);
+                return true;
+            }
+#endif
+            return false;
+        }
+
+        /// <summary>
+        /// Resets native input counters to zero.
+        /// </summary>
+        public void ResetNativeInputStats()
+        {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (windows8PointerHandler != null) windows8PointerHandler.ResetInputStats();
+            if (windows7PointerHandler != null) windows7PointerHandler.ResetInputStats();
+#elif UNITY_STANDALONE_LINUX && !UNITY_EDITOR
+            if (linuxPointerHandler != null) linuxPointerHandler.ResetInputStats();
+#endif
+        }
+
+        /// <summary>
+        /// Measure latency of Windows pointer events from the native window proc to TouchScript processing them.
+        /// </summary>
+        public bool WindowsMeasureLatency
+        {
+            get { return windowsMeasureLatency; }
+            set
+            {
+                windowsMeasureLatency = value;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+                if (windows8PointerHandler != null) windows8PointerHandler.MeasureLatency = value;
+                if (windows7PointerHandler != null) windows7PointerHandler.MeasureLatency = value;
+#endif
+            }
+        }
+
+        /// <summary>
+        /// Latency of Windows pointer events collected while <see cref="WindowsMeasureLatency"/> is on or <c>null</c> if native Windows input is not used.
+        /// </summary>
+        public LatencyHistogram WindowsLatency
+        {
+            get
+            {
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+                if (windows8PointerHandler != null) return windows8PointerHandler.Latency;
+                if (windows7PointerHandler != null) return windows7PointerHandler.Latency;
+#endif
+                return null;
+            }
+        }
+
         /// <summary>
         /// Use emulated second mouse pointer with ALT or not.
         /// </summary>
@@ -159,6 +763,10 @@ namespace TouchScript.InputSources
 		[HideInInspector]
 		private bool webglProps; // Used in the custom inspector
 
+        [SerializeField]
+        [HideInInspector]
+        private bool linuxProps; // Used in the custom inspector
+
 #pragma warning restore CS0414
 
 		[SerializeField]
@@ -171,6 +779,10 @@ namespace TouchScript.InputSources
         [SerializeField]
         private bool webGLTouch = true;
 
+        [ToggleLeft]
+        [SerializeField]
+        private bool linuxTouch = true;
+
         [ToggleLeft]
         [SerializeField]
         private bool windows8Mouse = true;
@@ -183,15 +795,78 @@ namespace TouchScript.InputSources
         [SerializeField]
         private bool universalWindowsMouse = true;
 
+        [ToggleLeft]
+        [SerializeField]
+        private bool windowsBufferedInput = false;
+
+        [ToggleLeft]
+        [SerializeField]
+        private bool windowsPointerTable = false;
+
+        [ToggleLeft]
+        [SerializeField]
+        private bool windowsCoalesceUpdates = false;
+
+        [ToggleLeft]
+        [SerializeField]
+        private bool windowsSuppressStationary = false;
+
+        [ToggleLeft]
+        [SerializeField]
+        private bool windowsPalmRejection = false;
+
+        [ToggleLeft]
+        [SerializeField]
+        private bool windowsContactAggregates = false;
+
+        [ToggleLeft]
+        [SerializeField]
+        private bool windowsFrameSync = false;
+
+        [ToggleLeft]
+        [SerializeField]
+        private bool windowsJitterFilter = false;
+
+        [ToggleLeft]
+        [SerializeField]
+        private bool windowsDeliveryThread = false;
+
+        [ToggleLeft]
+        [SerializeField]
+        private bool windows8FrameDecoding = false;
+
+        [ToggleLeft]
+        [SerializeField]
+        private bool windows8PointerHistory = false;
+
         [ToggleLeft]
         [SerializeField]
         private bool emulateSecondMousePointer = true;
 
+        private bool windowsMeasureLatency = false;
+        private float windowsPositionEpsilon = .5f;
+        private int windowsPressureEpsilon = 0;
+        private int windowsRotationEpsilon = 0;
+        private int windowsMaxContactArea = 0;
+        private bool windowsRequireConfidence = false;
+        private float windowsJitterMinCutoff = 1f;
+        private float windowsJitterBeta = .007f;
+        private float windowsJitterDerivativeCutoff = 1f;
+        private WindowsPredictionMode windowsTouchPrediction = WindowsPredictionMode.None;
+        private WindowsPredictionMode windowsPenPrediction = WindowsPredictionMode.None;
+        private WindowsPredictionMode windowsMousePrediction = WindowsPredictionMode.None;
+        private float windowsPredictionTime = .016f;
+        private float windowsProcessNoise = 4000000f;
+        private float windowsMeasurementNoise = 1f;
+        private float windowsPredictionHorizon = .05f;
+
         private MouseHandler mouseHandler;
         private TouchHandler touchHandler;
 #if UNITY_STANDALONE_WIN && !UNITY_EDITOR
         private Windows8PointerHandler windows8PointerHandler;
         private Windows7PointerHandler windows7PointerHandler;
+#elif UNITY_STANDALONE_LINUX && !UNITY_EDITOR
+        private LinuxPointerHandler linuxPointerHandler;
 #endif
 
         #endregion
@@ -208,6 +883,8 @@ namespace TouchScript.InputSources
             if (windows8PointerHandler != null) 
             {
                 handled = windows8PointerHandler.UpdateInput();
+                // Only exists if mouse in pointer couldn't be enabled.
+                if (mouseHandler != null) mouseHandler.UpdateInput();
             } 
             else
             {
@@ -216,6 +893,12 @@ namespace TouchScript.InputSources
                     handled = windows7PointerHandler.UpdateInput();
                 }
                 else 
+#endif
+#if UNITY_STANDALONE_LINUX && !UNITY_EDITOR
+            if (linuxPointerHandler != null)
+            {
+                handled = linuxPointerHandler.UpdateInput();
+            }
 #endif
             if (touchHandler != null)
             {
@@ -239,6 +922,8 @@ namespace TouchScript.InputSources
 #if UNITY_STANDALONE_WIN && !UNITY_EDITOR
             if (windows8PointerHandler != null) windows8PointerHandler.UpdateResolution();
             else if (windows7PointerHandler != null) windows7PointerHandler.UpdateResolution();
+#elif UNITY_STANDALONE_LINUX && !UNITY_EDITOR
+            if (linuxPointerHandler != null) linuxPointerHandler.UpdateResolution();
 #endif
             if (touchHandler != null) touchHandler.UpdateResolution();
             if (mouseHandler != null) mouseHandler.UpdateResolution();
@@ -255,6 +940,8 @@ namespace TouchScript.InputSources
 #if UNITY_STANDALONE_WIN && !UNITY_EDITOR
             if (windows7PointerHandler != null && !handled) handled = windows7PointerHandler.CancelPointer(pointer, shouldReturn);
             if (windows8PointerHandler != null && !handled) handled = windows8PointerHandler.CancelPointer(pointer, shouldReturn);
+#elif UNITY_STANDALONE_LINUX && !UNITY_EDITOR
+            if (linuxPointerHandler != null && !handled) handled = linuxPointerHandler.CancelPointer(pointer, shouldReturn);
 #endif
 
             return handled;
@@ -278,7 +965,10 @@ namespace TouchScript.InputSources
             enableTouch();
             enableMouse();
 #else
-#if UNITY_STANDALONE_OSX || UNITY_STANDALONE_LINUX
+#if UNITY_STANDALONE_OSX
+            enableMouse();
+#elif UNITY_STANDALONE_LINUX
+            if (LinuxTouch) enableLinuxTouch();
             enableMouse();
 #elif UNITY_STANDALONE_WIN
             if (Environment.OSVersion.Platform == PlatformID.Win32NT)
@@ -302,6 +992,10 @@ namespace TouchScript.InputSources
                         case Windows8APIType.None:
                             enableMouse();
                             break;
+                        case Windows8APIType.RawInput:
+                            enableWindows7Touch(true);
+                            if (Windows8Mouse) enableMouse();
+                            break;
                     }
                 }
                 else if (Environment.OSVersion.Version >= WIN7_VERSION)
@@ -320,6 +1014,10 @@ namespace TouchScript.InputSources
                         case Windows7APIType.None:
                             enableMouse();
                             break;
+                        case Windows7APIType.RawInput:
+                            enableWindows7Touch(true);
+                            if (Windows7Mouse) enableMouse();
+                            break;
                     }
                 }
                 else
@@ -356,6 +1054,8 @@ namespace TouchScript.InputSources
 #if UNITY_STANDALONE_WIN && !UNITY_EDITOR
             disableWindows7Touch();
             disableWindows8Touch();
+#elif UNITY_STANDALONE_LINUX && !UNITY_EDITOR
+            disableLinuxTouch();
 #endif
 
             base.OnDisable();
@@ -380,6 +1080,8 @@ namespace TouchScript.InputSources
 #if UNITY_STANDALONE_WIN && !UNITY_EDITOR
             if (windows7PointerHandler != null) windows7PointerHandler.CoordinatesRemapper = remapper;
             if (windows8PointerHandler != null) windows8PointerHandler.CoordinatesRemapper = remapper;
+#elif UNITY_STANDALONE_LINUX && !UNITY_EDITOR
+            if (linuxPointerHandler != null) linuxPointerHandler.CoordinatesRemapper = remapper;
 #endif
         }
 
@@ -419,10 +1121,30 @@ namespace TouchScript.InputSources
         }
 
 #if UNITY_STANDALONE_WIN && !UNITY_EDITOR
-        private void enableWindows7Touch()
+        // Raw input shares the touch only Windows 7 handler setup.
+        private void enableWindows7Touch(bool rawInput = false)
         {
-            windows7PointerHandler = new Windows7PointerHandler(addPointer, updatePointer, pressPointer, releasePointer, removePointer, cancelPointer);
-            Debug.Log("[TouchScript] Initialized Windows 7 pointer input.");
+            if (rawInput) windows7PointerHandler = new WindowsRawPointerHandler(addPointer, updatePointer, pressPointer, releasePointer, removePointer, cancelPointer);
+            else windows7PointerHandler = new Windows7PointerHandler(addPointer, updatePointer, pressPointer, releasePointer, removePointer, cancelPointer);
+            windows7PointerHandler.BufferedInput = windowsBufferedInput;
+            windows7PointerHandler.MeasureLatency = windowsMeasureLatency;
+            windows7PointerHandler.SharedPointerTable = windowsPointerTable;
+            windows7PointerHandler.CoalesceUpdates = windowsCoalesceUpdates;
+            windows7PointerHandler.SuppressStationary = windowsSuppressStationary;
+            windows7PointerHandler.SetFilterParams(windowsPositionEpsilon, windowsPressureEpsilon, windowsRotationEpsilon, windowsMaxContactArea, windowsRequireConfidence);
+            windows7PointerHandler.SetJitterFilterParams(windowsJitterMinCutoff, windowsJitterBeta, windowsJitterDerivativeCutoff);
+            windows7PointerHandler.PalmRejection = windowsPalmRejection;
+            windows7PointerHandler.ContactAggregates = windowsContactAggregates;
+            windows7PointerHandler.FrameSync = windowsFrameSync;
+            windows7PointerHandler.PredictionTime = windowsPredictionTime;
+            windows7PointerHandler.SetPredictionParams(windowsProcessNoise, windowsMeasurementNoise, windowsPredictionHorizon);
+            windows7PointerHandler.SetPrediction(Pointer.PointerType.Touch, (WindowsPointerHandler.PredictionMode) windowsTouchPrediction);
+            windows7PointerHandler.SetPrediction(Pointer.PointerType.Pen, (WindowsPointerHandler.PredictionMode) windowsPenPrediction);
+            windows7PointerHandler.SetPrediction(Pointer.PointerType.Mouse, (WindowsPointerHandler.PredictionMode) windowsMousePrediction);
+            windows7PointerHandler.JitterFilter = windowsJitterFilter;
+            windows7PointerHandler.DeliveryThread = windowsDeliveryThread;
+            if (rawInput) Debug.Log("[TouchScript] Initialized Windows raw input.");
+            else Debug.Log("[TouchScript] Initialized Windows 7 pointer input.");
         }
 
         private void disableWindows7Touch()
@@ -438,6 +1160,26 @@ namespace TouchScript.InputSources
         {
             windows8PointerHandler = new Windows8PointerHandler(addPointer, updatePointer, pressPointer, releasePointer, removePointer, cancelPointer);
             windows8PointerHandler.MouseInPointer = windows8Mouse;
+            if (windows8Mouse && !windows8PointerHandler.MouseInPointer) enableMouse();
+            windows8PointerHandler.BufferedInput = windowsBufferedInput;
+            windows8PointerHandler.FrameDecoding = windows8FrameDecoding;
+            windows8PointerHandler.PointerHistory = windows8PointerHistory;
+            windows8PointerHandler.MeasureLatency = windowsMeasureLatency;
+            windows8PointerHandler.SharedPointerTable = windowsPointerTable;
+            windows8PointerHandler.CoalesceUpdates = windowsCoalesceUpdates;
+            windows8PointerHandler.SuppressStationary = windowsSuppressStationary;
+            windows8PointerHandler.SetFilterParams(windowsPositionEpsilon, windowsPressureEpsilon, windowsRotationEpsilon, windowsMaxContactArea, windowsRequireConfidence);
+            windows8PointerHandler.SetJitterFilterParams(windowsJitterMinCutoff, windowsJitterBeta, windowsJitterDerivativeCutoff);
+            windows8PointerHandler.PalmRejection = windowsPalmRejection;
+            windows8PointerHandler.ContactAggregates = windowsContactAggregates;
+            windows8PointerHandler.FrameSync = windowsFrameSync;
+            windows8PointerHandler.PredictionTime = windowsPredictionTime;
+            windows8PointerHandler.SetPredictionParams(windowsProcessNoise, windowsMeasurementNoise, windowsPredictionHorizon);
+            windows8PointerHandler.SetPrediction(Pointer.PointerType.Touch, (WindowsPointerHandler.PredictionMode) windowsTouchPrediction);
+            windows8PointerHandler.SetPrediction(Pointer.PointerType.Pen, (WindowsPointerHandler.PredictionMode) windowsPenPrediction);
+            windows8PointerHandler.SetPrediction(Pointer.PointerType.Mouse, (WindowsPointerHandler.PredictionMode) windowsMousePrediction);
+            windows8PointerHandler.JitterFilter = windowsJitterFilter;
+            windows8PointerHandler.DeliveryThread = windowsDeliveryThread;
             Debug.Log("[TouchScript] Initialized Windows 8 pointer input.");
         }
 
@@ -449,6 +1191,21 @@ namespace TouchScript.InputSources
                 windows8PointerHandler = null;
             }
         }
+#elif UNITY_STANDALONE_LINUX && !UNITY_EDITOR
+        private void enableLinuxTouch()
+        {
+            linuxPointerHandler = new LinuxPointerHandler(addPointer, updatePointer, pressPointer, releasePointer, removePointer, cancelPointer);
+            Debug.Log("[TouchScript] Initialized Linux touch input.");
+        }
+
+        private void disableLinuxTouch()
+        {
+            if (linuxPointerHandler != null)
+            {
+                linuxPointerHandler.Dispose();
+                linuxPointerHandler = null;
+            }
+        }
 #endif
 
         #endregion
@@ -42,6 +42,11 @@ namespace TouchScript.Pointers
         /// </summary>
         public const uint FLAG_INTERNAL = 1 << 2;
 
+        /// <summary>
+        /// The input device classified this pointer as an accidental contact, i.e. a palm.
+        /// </summary>
+        public const uint FLAG_PALM = 1 << 3;
+
         /// <summary>
         /// Pointer type.
         /// </summary>
@@ -216,6 +221,11 @@ namespace TouchScript.Pointers
         /// <inheritdoc />
         public uint Flags { get; set; }
 
+        /// <summary>
+        /// Index of the physical device which created this pointer, 0 if the input source doesn't tell devices apart.
+        /// </summary>
+        public uint DeviceIndex { get; set; }
+
         /// <summary>
         /// Projection parameters for the layer which created this pointer.
         /// </summary>
@@ -271,6 +281,7 @@ namespace TouchScript.Pointers
         {
             Type = target.Type;
             Flags = target.Flags;
+            DeviceIndex = target.DeviceIndex;
             Buttons = target.Buttons;
             position = target.position;
             newPosition = target.newPosition;
@@ -348,6 +359,7 @@ namespace TouchScript.Pointers
             INTERNAL_ClearPressData();
             position = newPosition = PreviousPosition = Vector2.zero;
             Flags = 0;
+            DeviceIndex = 0;
             Buttons = PointerButtonState.Nothing;
             overDataIsDirty = true;
         }
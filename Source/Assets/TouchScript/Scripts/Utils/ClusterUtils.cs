@@ -6,6 +6,10 @@ using System.Collections.Generic;
 using System.Text;
 using TouchScript.Pointers;
 using UnityEngine;
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+using System;
+using System.Runtime.InteropServices;
+#endif
 
 namespace TouchScript.Utils
 {
@@ -14,7 +18,16 @@ namespace TouchScript.Utils
     /// </summary>
     public static class ClusterUtils
     {
+        /// <summary>
+        /// Maximum number of passes <see cref="Split2D"/> makes before it gives up on convergence.
+        /// </summary>
+        public const int MAX_SPLIT_ITERATIONS = 32;
+
         private static StringBuilder hashString = new StringBuilder();
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+        private const int MAX_NATIVE_SPLIT_POINTS = 256;
+        private static bool nativeSplitAvailable = true;
+#endif
 
         /// <summary>
         /// Calculates the centroid of pointers' positions.
@@ -48,6 +61,41 @@ namespace TouchScript.Utils
             return position / count;
         }
 
+        /// <summary>
+        /// Splits positions into two clusters without allocating. On Windows standalone the work is done by WindowsTouch.dll.
+        /// </summary>
+        /// <param name="positions">Positions to split.</param>
+        /// <param name="count">Number of positions to use from the start of <paramref name="positions"/>.</param>
+        /// <param name="assignments">Receives the cluster of every position, 0 or 1. Must hold at least <paramref name="count"/> elements.</param>
+        /// <param name="centers">Receives centroids of both clusters. Must hold at least 2 elements.</param>
+        /// <returns>Number of passes made or -1 if there are less than 2 positions.</returns>
+        /// <remarks>The first two positions start the clusters. Every pass takes the positions most distant from both cluster centers as new centers and reassigns the rest to the closest one, until assignments stop changing.</remarks>
+        public static int Split2D(Vector2[] positions, int count, int[] assignments, Vector2[] centers)
+        {
+            if (count < 2) return -1;
+
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+            if (nativeSplitAvailable && count <= MAX_NATIVE_SPLIT_POINTS)
+            {
+                try
+                {
+                    var result = SplitClusters(positions, count, assignments, centers);
+                    if (result >= 0) return result;
+                }
+                catch (DllNotFoundException)
+                {
+                    nativeSplitAvailable = false;
+                }
+                catch (EntryPointNotFoundException)
+                {
+                    nativeSplitAvailable = false;
+                }
+            }
+#endif
+
+            return split2D(positions, count, assignments, centers);
+        }
+
         /// <summary>
         /// Computes a unique hash for a list of pointers.
         /// </summary>
@@ -63,5 +111,87 @@ namespace TouchScript.Utils
             }
             return hashString.ToString();
         }
+    
+        private static int split2D(Vector2[] positions, int count, int[] assignments, Vector2[] centers)
+        {
+            for (var i = 0; i < count; i++) assignments[i] = i == 1 ? 1 : 0;
+            var center1 = positions[0];
+            var center2 = positions[1];
+            var iteration = 0;
+
+            if (count > 2)
+            {
+                var changed = true;
+                while (changed && iteration < MAX_SPLIT_ITERATIONS)
+                {
+                    iteration++;
+
+                    // Take most distant points from cluster1 and cluster2
+                    var far1 = 0;
+                    var far2 = 0;
+                    var maxDist1 = -float.MaxValue;
+                    var maxDist2 = -float.MaxValue;
+                    for (var i = 0; i < count; i++)
+                    {
+                        var dist = (center1 - positions[i]).sqrMagnitude;
+                        if (dist > maxDist2)
+                        {
+                            maxDist2 = dist;
+                            far2 = i;
+                        }
+
+                        dist = (center2 - positions[i]).sqrMagnitude;
+                        if (dist > maxDist1)
+                        {
+                            maxDist1 = dist;
+                            far1 = i;
+                        }
+                    }
+
+                    // If it is the same point it means that this point is too far away from both clusters and has to be in a separate cluster
+                    if (far1 == far2) center1 = (center1 + center2) * .5f;
+                    else center1 = positions[far1];
+                    center2 = positions[far2];
+
+                    // Initial assignments are only a guess, so the first pass never counts as converged
+                    changed = iteration == 1;
+                    var sum1 = new Vector2();
+                    var sum2 = new Vector2();
+                    var count1 = 0;
+                    for (var i = 0; i < count; i++)
+                    {
+                        var position = positions[i];
+                        var cluster = (center1 - position).sqrMagnitude < (center2 - position).sqrMagnitude ? 0 : 1;
+                        if (cluster == 0)
+                        {
+                            sum1 += position;
+                            count1++;
+                        }
+                        else
+                        {
+                            sum2 += position;
+                        }
+                        if (assignments[i] != cluster)
+                        {
+                            assignments[i] = cluster;
+                            changed = true;
+                        }
+                    }
+
+                    // An empty cluster keeps its center
+                    if (count1 > 0) center1 = sum1 / count1;
+                    if (count1 < count) center2 = sum2 / (count - count1);
+                }
+            }
+
+            centers[0] = center1;
+            centers[1] = center2;
+            return iteration;
+        }
+
+#if UNITY_STANDALONE_WIN && !UNITY_EDITOR
+        [DllImport("WindowsTouch", CallingConvention = CallingConvention.StdCall)]
+        private static extern int SplitClusters(Vector2[] points, int count, [Out] int[] assignments, [Out] Vector2[] centers);
+#endif
     }
 }
\ No newline at end of file
@@ -0,0 +1,118 @@
+/*
+ * @author Valentin Simonov / http://va.lent.in/
+ */
+
+using System;
+
+namespace TouchScript.Utils
+{
+    /// <summary>
+    /// Histogram of latency samples in milliseconds with fixed size buckets. Doesn't allocate after it is created.
+    /// </summary>
+    public sealed class LatencyHistogram
+    {
+        #region Public properties
+
+        /// <summary>
+        /// Number of samples added since the last <see cref="Reset"/>.
+        /// </summary>
+        public int Count
+        {
+            get { return count; }
+        }
+
+        /// <summary>
+        /// Average latency in milliseconds.
+        /// </summary>
+        public float Average
+        {
+            get { return count == 0 ? 0 : (float) (sum / count); }
+        }
+
+        /// <summary>
+        /// Maximum latency in milliseconds.
+        /// </summary>
+        public float Max
+        {
+            get { return max; }
+        }
+
+        #endregion
+
+        #region Private variables
+
+        private int[] buckets;
+        private float bucketSize;
+        private int count;
+        private double sum;
+        private float max;
+
+        #endregion
+
+        #region Constructor
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="LatencyHistogram"/> class.
+        /// </summary>
+        /// <param name="bucketSize">Size of one bucket in milliseconds.</param>
+        /// <param name="range">Maximum tracked latency in milliseconds, larger samples are put in the last bucket.</param>
+        public LatencyHistogram(float bucketSize = .25f, float range = 250f)
+        {
+            if (bucketSize <= 0) throw new ArgumentOutOfRangeException("bucketSize");
+            this.bucketSize = bucketSize;
+            buckets = new int[Math.Max(1, (int) Math.Ceiling(range / bucketSize))];
+        }
+
+        #endregion
+
+        #region Public methods
+
+        /// <summary>
+        /// Adds a sample.
+        /// </summary>
+        /// <param name="milliseconds">Latency in milliseconds.</param>
+        public void Add(float milliseconds)
+        {
+            if (milliseconds < 0) milliseconds = 0;
+            var bucket = (int) (milliseconds / bucketSize);
+            if (bucket >= buckets.Length) bucket = buckets.Length - 1;
+            buckets[bucket]++;
+            count++;
+            sum += milliseconds;
+            if (milliseconds > max) max = milliseconds;
+        }
+
+        /// <summary>
+        /// Returns the latency in milliseconds below which the given fraction of samples falls.
+        /// </summary>
+        /// <param name="percentile">Fraction of samples in range [0, 1], i.e. 0.95 for the 95th percentile.</param>
+        /// <returns>Upper bound of the bucket containing the percentile or 0 if there are no samples.</returns>
+        public float GetPercentile(float percentile)
+        {
+            if (count == 0) return 0;
+            var target = (int) Math.Ceiling(Math.Min(Math.Max(percentile, 0f), 1f) * count);
+            if (target < 1) target = 1;
+
+            var total = 0;
+            for (var i = 0; i < buckets.Length; i++)
+            {
+                total += buckets[i];
+                if (total >= target) return Math.Min((i + 1) * bucketSize, max);
+            }
+            return max;
+        }
+
+        /// <summary>
+        /// Removes all samples.
+        /// </summary>
+        public void Reset()
+        {
+            Array.Clear(buckets, 0, buckets.Length);
+            count = 0;
+            sum = 0;
+            max = 0;
+        }
+
+        #endregion
+    }
+}
@@ -106,6 +106,12 @@ namespace TouchScript.Utils.Platform
 
         [DllImport("user32.dll")]
         public static extern IntPtr EnableMouseInPointer(bool value);
+
+        [DllImport("Kernel32.dll")]
+        public static extern bool QueryPerformanceCounter(out long lpPerformanceCount);
+
+        [DllImport("Kernel32.dll")]
+        public static extern bool QueryPerformanceFrequency(out long lpFrequency);
     }
 }
 